@@ -0,0 +1,98 @@
+#include "pch.h"
+#include "AllocationTracker.h"
+#include <new>
+
+// Each block is prefixed with it's size, padded to keep the default new alignment
+constexpr size_t AllocationHeaderSize = 16;
+
+static std::atomic<uint64_t> Allocations = 0;
+static std::atomic<uint64_t> LiveBytes = 0;
+static std::atomic<uint64_t> PeakBytes = 0;
+static std::atomic<uint64_t> BaselineBytes = 0;
+
+static void* TrackedAllocate(size_t Size)
+{
+	auto Block = (uint8_t*)std::malloc(Size + AllocationHeaderSize);
+
+	if (Block == nullptr)
+		throw std::bad_alloc();
+
+	*(size_t*)Block = Size;
+
+	Allocations++;
+	uint64_t Live = (LiveBytes += Size);
+	uint64_t Peak = PeakBytes;
+
+	while (Live > Peak && !PeakBytes.compare_exchange_weak(Peak, Live))
+		;
+
+	return Block + AllocationHeaderSize;
+}
+
+static void TrackedFree(void* Pointer)
+{
+	if (Pointer == nullptr)
+		return;
+
+	auto Block = (uint8_t*)Pointer - AllocationHeaderSize;
+
+	LiveBytes -= *(size_t*)Block;
+	std::free(Block);
+}
+
+void* operator new(size_t Size)
+{
+	return TrackedAllocate(Size);
+}
+
+void* operator new[](size_t Size)
+{
+	return TrackedAllocate(Size);
+}
+
+void operator delete(void* Pointer) noexcept
+{
+	TrackedFree(Pointer);
+}
+
+void operator delete[](void* Pointer) noexcept
+{
+	TrackedFree(Pointer);
+}
+
+void operator delete(void* Pointer, size_t) noexcept
+{
+	TrackedFree(Pointer);
+}
+
+void operator delete[](void* Pointer, size_t) noexcept
+{
+	TrackedFree(Pointer);
+}
+
+void AllocationTracker::Reset()
+{
+	Allocations = 0;
+	BaselineBytes = LiveBytes.load();
+	PeakBytes = BaselineBytes.load();
+}
+
+uint64_t AllocationTracker::GetAllocations()
+{
+	return Allocations;
+}
+
+uint64_t AllocationTracker::GetPeakBytes()
+{
+	return PeakBytes - BaselineBytes;
+}
+
+uint64_t AllocationTracker::GetProcessPeakBytes()
+{
+	PROCESS_MEMORY_COUNTERS_EX Counters{};
+
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS*)&Counters, sizeof(Counters)))
+		return 0;
+
+	return Counters.PeakPagefileUsage;
+}
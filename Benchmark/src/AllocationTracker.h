@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+// Tracks every allocation made through operator new in the benchmark process.
+// Codecs that allocate through malloc directly aren't seen here, the process counters cover those.
+class AllocationTracker
+{
+public:
+	// Starts a new measurement, the peak is reset to the bytes currently live
+	static void Reset();
+
+	// The number of allocations since the last reset
+	static uint64_t GetAllocations();
+	// The highest number of live bytes since the last reset, minus the bytes live when it was reset
+	static uint64_t GetPeakBytes();
+
+	// The peak commit charge of the whole process
+	static uint64_t GetProcessPeakBytes();
+};
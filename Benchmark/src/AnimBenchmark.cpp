@@ -0,0 +1,302 @@
+#include "pch.h"
+#include "AnimBenchmark.h"
+#include "RpakAnimDecoder.h"
+#include "MemoryStream.h"
+#include "BinaryReader.h"
+#include "Path.h"
+#include "File.h"
+#include <chrono>
+
+// A sequence recorded by RpakAnimDecoder::BeginCapture
+struct AnimCapture
+{
+	RpakAnimLayout Layout;
+	bool Additive;
+	List<Assets::Bone> Bones;
+	List<RpakAnimSection> Sections;
+	// The offset of each section's data in the blob
+	List<uint64_t> SectionOffsets;
+	List<uint64_t> SectionSizes;
+	std::unique_ptr<uint8_t[]> Data;
+	uint64_t DataSize;
+};
+
+// Loads a capture, returns false when the file isn't one
+static bool LoadAnimCapture(const string& Path, AnimCapture& Result)
+{
+	auto Reader = IO::BinaryReader(IO::File::OpenRead(Path));
+
+	if (Reader.Read<uint32_t>() != AnimCaptureMagic || Reader.Read<uint32_t>() != AnimCaptureVersion)
+		return false;
+
+	Result.Layout = Reader.Read<RpakAnimLayout>();
+	Result.Additive = Reader.Read<uint8_t>() != 0;
+
+	const uint32_t BoneCount = Reader.Read<uint32_t>();
+
+	Result.Bones.Clear();
+
+	for (uint32_t b = 0; b < BoneCount; b++)
+	{
+		string Name = Reader.ReadCString();
+		int32_t Parent = Reader.Read<int32_t>();
+		Math::Vector3 Position = Reader.Read<Math::Vector3>();
+		Math::Quaternion Rotation = Reader.Read<Math::Quaternion>();
+
+		Result.Bones.EmplaceBack(Name, Parent, Position, Rotation);
+	}
+
+	// The section data follows the section headers, gather them into one blob
+	auto BaseStream = Reader.GetBaseStream();
+	const uint64_t Remaining = BaseStream->GetLength() - BaseStream->GetPosition();
+
+	Result.Sections.Clear();
+	Result.SectionOffsets.Clear();
+	Result.SectionSizes.Clear();
+	Result.Data = std::make_unique<uint8_t[]>(Remaining);
+	Result.DataSize = 0;
+
+	while (BaseStream->GetPosition() < BaseStream->GetLength())
+	{
+		RpakAnimSection Section = Reader.Read<RpakAnimSection>();
+		uint64_t SectionSize = Reader.Read<uint64_t>();
+
+		if (Result.DataSize + SectionSize > Remaining)
+			return false;
+
+		Reader.Read(Result.Data.get(), Result.DataSize, SectionSize);
+
+		Result.Sections.Add(Section);
+		Result.SectionOffsets.Add(Result.DataSize);
+		Result.SectionSizes.Add(SectionSize);
+		Result.DataSize += SectionSize;
+	}
+
+	return true;
+}
+
+// Builds the animation the decoders write into, the same way ExtractAnimation does
+static std::unique_ptr<Assets::Animation> CreateAnimation(AnimCapture& Capture)
+{
+	auto Anim = std::make_unique<Assets::Animation>(Capture.Bones.Count());
+
+	for (auto& Bone : Capture.Bones)
+		Anim->Bones.EmplaceBack(Bone.Name(), Bone.Parent(), Bone.LocalPosition(), Bone.LocalRotation());
+
+	Anim->Tracks.Initialize(Capture.Bones.Count(), Capture.Layout.FrameCount, Capture.Additive ? Assets::AnimationCurveMode::Additive : Assets::AnimationCurveMode::Absolute);
+
+	return Anim;
+}
+
+// The decode loop from before sections were resolved once: every frame looks it's section up again, re-reads
+// the bone flags and walks every track through the stream. Rpak data was borrowed in place, starpak data copied per track.
+static void DecodeReference(AnimCapture& Capture, Assets::Animation& Anim, bool CopyTracks)
+{
+	const RpakAnimLayout& Layout = Capture.Layout;
+	const uint32_t BoneCount = Capture.Bones.Count();
+	const uint64_t FlagSize = ((4 * (uint64_t)BoneCount + 7) / 8 + 1) & 0xFFFFFFFFFFFFFFFE;
+
+	RpakAnimDecoder Decoder(Anim, BoneCount, Capture.Additive);
+
+	IO::MemoryStream Stream(Capture.Data.get(), 0, Capture.DataSize, false, true);
+	IO::BinaryReader Reader(&Stream, true);
+
+	auto BoneFlagData = std::make_unique<uint8_t[]>(FlagSize);
+
+	for (uint32_t Frame = 0; Frame < Layout.FrameCount; Frame++)
+	{
+		uint32_t SectionIndex = 0;
+		uint32_t SectionFrame = Frame;
+
+		if (Layout.SectionFrames && Frame >= Layout.SplitFrames)
+		{
+			const uint32_t FrameAfterSplit = Frame - Layout.SplitFrames;
+
+			if (Layout.FrameCount <= Layout.SplitFrames || Frame != Layout.FrameCount - 1)
+			{
+				SectionIndex = FrameAfterSplit / Layout.SectionFrames + 1;
+				SectionFrame = Frame - (Layout.SectionFrames * (FrameAfterSplit / Layout.SectionFrames)) - Layout.SplitFrames;
+			}
+			else
+			{
+				SectionFrame = 0;
+				SectionIndex = (Layout.FrameCount - Layout.SplitFrames - 1) / Layout.SectionFrames + 2;
+			}
+		}
+
+		// Stands in for the section table read
+		uint64_t SectionOffset = 0;
+
+		for (uint32_t s = 0; s < Capture.Sections.Count(); s++)
+		{
+			if (Capture.Sections[s].Index == SectionIndex)
+			{
+				SectionOffset = Capture.SectionOffsets[s];
+				break;
+			}
+		}
+
+		Stream.SetPosition(SectionOffset);
+		Stream.Read(BoneFlagData.get(), 0, FlagSize);
+
+		for (uint32_t b = 0; b < BoneCount; b++)
+		{
+			uint8_t BoneFlags = BoneFlagData[b / 2] >> (4 * (b % 2));
+
+			if (!(BoneFlags & 0x7))
+				continue;
+
+			mstudio_rle_anim_t Header = Reader.Read<mstudio_rle_anim_t>();
+
+			short SizeToRead = Header.size > 0 ? Header.size - sizeof(mstudio_rle_anim_t) : 0;
+
+			std::unique_ptr<uint8_t[]> TrackData = nullptr;
+			uint16_t* TrackDataPtr = nullptr;
+
+			if (CopyTracks)
+			{
+				TrackData = Reader.Read(SizeToRead);
+				TrackDataPtr = (uint16_t*)TrackData.get();
+			}
+			else
+			{
+				TrackDataPtr = (uint16_t*)Stream.Borrow(Stream.GetPosition(), SizeToRead);
+				Stream.Seek(SizeToRead, IO::SeekOrigin::Current);
+			}
+
+			Header.bAdditiveCustom = Capture.Additive;
+
+			if (BoneFlags & STUDIO_ANIM_BONEPOS)
+				Decoder.CalcBonePosition(Header, &TrackDataPtr, b, SectionFrame, Frame);
+			if (BoneFlags & STUDIO_ANIM_BONEROT)
+				Decoder.CalcBoneQuaternion(Header, &TrackDataPtr, b, SectionFrame, Frame);
+			if (BoneFlags & STUDIO_ANIM_BONESCALE)
+				Decoder.CalcBoneScale(Header, &TrackDataPtr, b, SectionFrame, Frame);
+		}
+	}
+}
+
+// The section decoder, the same way ExtractAnimation drives it for rpak data
+static void DecodeSections(AnimCapture& Capture, Assets::Animation& Anim)
+{
+	RpakAnimDecoder Decoder(Anim, Capture.Bones.Count(), Capture.Additive);
+
+	for (uint32_t s = 0; s < Capture.Sections.Count(); s++)
+	{
+		Decoder.ResolveSection(Capture.Data.get() + Capture.SectionOffsets[s], Capture.SectionSizes[s]);
+		Decoder.DecodeSection(Capture.Sections[s]);
+	}
+}
+
+// Runs the decode a number of times and keeps the fastest run
+template<typename TDecode>
+static std::chrono::nanoseconds BenchmarkDecode(uint32_t Iterations, TDecode Decode)
+{
+	auto Best = std::chrono::nanoseconds::max();
+
+	for (uint32_t i = 0; i < Iterations; i++)
+	{
+		auto Start = std::chrono::high_resolution_clock::now();
+		Decode();
+		auto End = std::chrono::high_resolution_clock::now();
+
+		auto Time = std::chrono::duration_cast<std::chrono::nanoseconds>(End - Start);
+
+		if (Time < Best)
+			Best = Time;
+	}
+
+	return Best;
+}
+
+// Compares the written channels and their values of both animations
+static bool TracksMatch(const Assets::AnimationTrackBuffer& Lhs, const Assets::AnimationTrackBuffer& Rhs)
+{
+	if (Lhs.BoneCount() != Rhs.BoneCount() || Lhs.FrameCount() != Rhs.FrameCount())
+		return false;
+
+	constexpr Assets::AnimationTrackChannel Channels[] = { Assets::AnimationTrackChannel::Rotation, Assets::AnimationTrackChannel::Translation, Assets::AnimationTrackChannel::Scale };
+	constexpr uint32_t ChannelComponents[][2] = { { (uint32_t)Assets::AnimationTrackComponent::RotateX, 4 }, { (uint32_t)Assets::AnimationTrackComponent::TranslateX, 3 }, { (uint32_t)Assets::AnimationTrackComponent::ScaleX, 3 } };
+
+	for (uint32_t b = 0; b < Lhs.BoneCount(); b++)
+	{
+		for (uint32_t f = 0; f < Lhs.FrameCount(); f++)
+		{
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				const bool HasChannel = Lhs.HasChannel(b, f, Channels[c]);
+
+				if (HasChannel != Rhs.HasChannel(b, f, Channels[c]))
+					return false;
+				if (!HasChannel)
+					continue;
+
+				for (uint32_t i = 0; i < ChannelComponents[c][1]; i++)
+				{
+					auto Component = (Assets::AnimationTrackComponent)(ChannelComponents[c][0] + i);
+
+					if (std::memcmp(&Lhs.Track(Component, b)[f], &Rhs.Track(Component, b)[f], sizeof(float)) != 0)
+						return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+static double FramesPerSecond(uint64_t Frames, std::chrono::nanoseconds Time)
+{
+	if (Time.count() == 0)
+		return 0.0;
+
+	return (double)Frames / ((double)Time.count() / 1e9);
+}
+
+uint32_t RunAnimBenchmark(const List<string>& Corpus, uint32_t Iterations)
+{
+	uint32_t Mismatches = 0;
+	uint64_t TotalFrames = 0;
+	auto TotalReference = std::chrono::nanoseconds::zero();
+	auto TotalReferenceCopy = std::chrono::nanoseconds::zero();
+	auto TotalSections = std::chrono::nanoseconds::zero();
+
+	printf("%-40s %8s %6s %14s %14s %14s %8s\n", "capture", "frames", "bones", "ref (fps)", "ref copy (fps)", "section (fps)", "match");
+
+	for (auto& Path : Corpus)
+	{
+		AnimCapture Capture{};
+
+		if (!LoadAnimCapture(Path, Capture))
+		{
+			printf("%-40s skipped, not an animation capture\n", (const char*)IO::Path::GetFileName(Path));
+			continue;
+		}
+
+		auto ReferenceAnim = CreateAnimation(Capture);
+		auto ReferenceCopyAnim = CreateAnimation(Capture);
+		auto SectionAnim = CreateAnimation(Capture);
+
+		auto ReferenceTime = BenchmarkDecode(Iterations, [&] { DecodeReference(Capture, *ReferenceAnim, false); });
+		auto ReferenceCopyTime = BenchmarkDecode(Iterations, [&] { DecodeReference(Capture, *ReferenceCopyAnim, true); });
+		auto SectionTime = BenchmarkDecode(Iterations, [&] { DecodeSections(Capture, *SectionAnim); });
+
+		bool Match = TracksMatch(ReferenceAnim->Tracks, SectionAnim->Tracks) && TracksMatch(ReferenceCopyAnim->Tracks, SectionAnim->Tracks);
+
+		if (!Match)
+			Mismatches++;
+
+		const uint32_t Frames = Capture.Layout.FrameCount;
+
+		TotalFrames += Frames;
+		TotalReference += ReferenceTime;
+		TotalReferenceCopy += ReferenceCopyTime;
+		TotalSections += SectionTime;
+
+		printf("%-40s %8u %6u %14.0f %14.0f %14.0f %8s\n", (const char*)IO::Path::GetFileName(Path), Frames, Capture.Bones.Count(), FramesPerSecond(Frames, ReferenceTime), FramesPerSecond(Frames, ReferenceCopyTime), FramesPerSecond(Frames, SectionTime), Match ? "yes" : "NO");
+	}
+
+	printf("%-40s %8llu %6s %14.0f %14.0f %14.0f %8u\n", "total", TotalFrames, "", FramesPerSecond(TotalFrames, TotalReference), FramesPerSecond(TotalFrames, TotalReferenceCopy), FramesPerSecond(TotalFrames, TotalSections), Mismatches);
+
+	return Mismatches;
+}
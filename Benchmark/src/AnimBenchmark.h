@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstdint>
+#include "ListBase.h"
+#include "StringBase.h"
+
+// Decodes every animation capture (.animcap, written by a debug build of Legion with --animcapture) in the corpus
+// with the per-frame reference loop and the section decoder. Reports frames per second for each
+// and verifies the decoded tracks match, returns the number of mismatches.
+uint32_t RunAnimBenchmark(const List<string>& Corpus, uint32_t Iterations);
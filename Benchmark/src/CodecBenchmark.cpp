@@ -0,0 +1,375 @@
+#include "pch.h"
+#include "CodecBenchmark.h"
+#include "PakBenchmark.h"
+#include "AllocationTracker.h"
+#include "rtech.h"
+#include "File.h"
+#include "Path.h"
+#include "StreamWriter.h"
+#include "LZ4Codec.h"
+#include "ZLibCodec.h"
+#include "DeflateCodec.h"
+#include "LZHAMCodec.h"
+#include "LZO1XCodec.h"
+#include <chrono>
+#include <functional>
+
+// A block of data the codecs run over
+struct CodecSample
+{
+	string Name;
+	std::unique_ptr<uint8_t[]> Data;
+	uint64_t Size;
+};
+
+// The measurements of a single codec over a single sample
+struct CodecResult
+{
+	string Codec;
+	string Sample;
+	uint64_t CompressedSize;
+	uint64_t DecodedSize;
+	double DecodeThroughput;
+	double AllocationsPerCall;
+	uint64_t PeakBytes;
+	bool Verified;
+};
+
+// A codec with both directions available in cppkore
+struct RoundTripCodec
+{
+	const char* Name;
+	std::unique_ptr<uint8_t[]>(*Compress)(uint8_t* Input, uint64_t InputLength, uint64_t& OutputLength);
+	uint64_t(*Decompress)(uint8_t* Input, uint64_t InputLength, uint8_t* Output, uint64_t OutputLength);
+};
+
+static const RoundTripCodec RoundTripCodecs[] =
+{
+	{
+		"LZ4",
+		[](uint8_t* Input, uint64_t InputLength, uint64_t& OutputLength) { return Compression::LZ4Codec::Compress(Input, 0, InputLength, OutputLength); },
+		[](uint8_t* Input, uint64_t InputLength, uint8_t* Output, uint64_t OutputLength) { return Compression::LZ4Codec::Decompress(Input, 0, InputLength, Output, 0, OutputLength); }
+	},
+	{
+		"LZ4HC",
+		[](uint8_t* Input, uint64_t InputLength, uint64_t& OutputLength) { return Compression::LZ4Codec::CompressHC(Input, 0, InputLength, OutputLength); },
+		[](uint8_t* Input, uint64_t InputLength, uint8_t* Output, uint64_t OutputLength) { return Compression::LZ4Codec::Decompress(Input, 0, InputLength, Output, 0, OutputLength); }
+	},
+	{
+		"ZLib",
+		[](uint8_t* Input, uint64_t InputLength, uint64_t& OutputLength) { return Compression::ZLibCodec::Compress(Input, 0, InputLength, OutputLength); },
+		[](uint8_t* Input, uint64_t InputLength, uint8_t* Output, uint64_t OutputLength) { return Compression::ZLibCodec::Decompress(Input, 0, InputLength, Output, 0, OutputLength); }
+	},
+	{
+		"Deflate",
+		[](uint8_t* Input, uint64_t InputLength, uint64_t& OutputLength) { return Compression::DeflateCodec::Compress(Input, 0, InputLength, OutputLength); },
+		[](uint8_t* Input, uint64_t InputLength, uint8_t* Output, uint64_t OutputLength) { return Compression::DeflateCodec::Decompress(Input, 0, InputLength, Output, 0, OutputLength); }
+	},
+	{
+		"LZHAM",
+		[](uint8_t* Input, uint64_t InputLength, uint64_t& OutputLength) { return Compression::LZHAMCodec::Compress(Input, 0, InputLength, OutputLength); },
+		[](uint8_t* Input, uint64_t InputLength, uint8_t* Output, uint64_t OutputLength) { return Compression::LZHAMCodec::Decompress(Input, 0, InputLength, Output, 0, OutputLength); }
+	},
+	{
+		"LZO1X",
+		[](uint8_t* Input, uint64_t InputLength, uint64_t& OutputLength) { return Compression::LZO1XCodec::Compress(Input, 0, InputLength, OutputLength); },
+		[](uint8_t* Input, uint64_t InputLength, uint8_t* Output, uint64_t OutputLength) { return Compression::LZO1XCodec::Decompress(Input, 0, InputLength, Output, 0, OutputLength); }
+	},
+};
+
+// Runs a decode the requested number of times, the routine returns false if the decode failed
+static void MeasureDecode(const std::function<bool()>& Decode, uint32_t Iterations, uint64_t DecodedSize, CodecResult& Result)
+{
+	auto Best = std::chrono::nanoseconds::max();
+	bool Verified = true;
+
+	AllocationTracker::Reset();
+
+	for (uint32_t i = 0; i < Iterations; i++)
+	{
+		auto Start = std::chrono::high_resolution_clock::now();
+		Verified &= Decode();
+		auto End = std::chrono::high_resolution_clock::now();
+
+		auto Time = std::chrono::duration_cast<std::chrono::nanoseconds>(End - Start);
+
+		if (Time < Best)
+			Best = Time;
+	}
+
+	Result.DecodedSize = DecodedSize;
+	Result.AllocationsPerCall = (double)AllocationTracker::GetAllocations() / (double)Iterations;
+	Result.PeakBytes = AllocationTracker::GetPeakBytes();
+	Result.Verified = Verified;
+	Result.DecodeThroughput = (Best.count() > 0) ? ((double)DecodedSize / (1024.0 * 1024.0)) / ((double)Best.count() / 1e9) : 0.0;
+}
+
+// Deterministic synthetic data, shaped after what ends up in paks
+static void BuildSyntheticSamples(uint64_t Size, std::vector<CodecSample>& Samples)
+{
+	uint64_t Seed = 0x9E3779B97F4A7C15;
+	auto NextRandom = [&Seed]()
+	{
+		Seed ^= Seed << 13;
+		Seed ^= Seed >> 7;
+		Seed ^= Seed << 17;
+		return Seed;
+	};
+
+	// Padding and cleared segments
+	{
+		CodecSample Sample{ "synthetic/zeros", std::make_unique<uint8_t[]>(Size), Size };
+		std::memset(Sample.Data.get(), 0, Size);
+		Samples.emplace_back(std::move(Sample));
+	}
+
+	// Already compressed payloads, like streamed texture data
+	{
+		CodecSample Sample{ "synthetic/random", std::make_unique<uint8_t[]>(Size), Size };
+		for (uint64_t i = 0; i < Size; i++)
+			Sample.Data[i] = (uint8_t)NextRandom();
+		Samples.emplace_back(std::move(Sample));
+	}
+
+	// Asset names and datatable strings
+	{
+		static const char* Words[] = { "mdl/", "weapons/", "humans/", "pilots/", "_v21_", "animseq/", ".rmdl", ".rseq", "albedo", "normal", "gloss", "spec", "\0" };
+
+		CodecSample Sample{ "synthetic/text", std::make_unique<uint8_t[]>(Size), Size };
+		uint64_t Position = 0;
+
+		while (Position < Size)
+		{
+			auto Word = Words[NextRandom() % _countof(Words)];
+			auto Length = max((size_t)1, strlen(Word));
+
+			for (size_t i = 0; i < Length && Position < Size; i++)
+				Sample.Data[Position++] = (uint8_t)Word[i];
+		}
+
+		Samples.emplace_back(std::move(Sample));
+	}
+
+	// Vertex streams, slowly changing floats with noise in the low bits
+	{
+		CodecSample Sample{ "synthetic/vertices", std::make_unique<uint8_t[]>(Size), Size };
+		auto Floats = (float*)Sample.Data.get();
+		float Value = 0.0f;
+
+		for (uint64_t i = 0; i < Size / sizeof(float); i++)
+		{
+			Value += (float)((int64_t)(NextRandom() % 200) - 100) * 0.001f;
+			Floats[i] = Value;
+		}
+
+		std::memset(Sample.Data.get() + (Size & ~(sizeof(float) - 1)), 0, Size & (sizeof(float) - 1));
+		Samples.emplace_back(std::move(Sample));
+	}
+}
+
+static void BenchmarkRoundTrip(const CodecSample& Sample, uint32_t Iterations, List<CodecResult>& Results)
+{
+	auto Output = std::make_unique<uint8_t[]>(Sample.Size);
+
+	for (auto& Codec : RoundTripCodecs)
+	{
+		CodecResult Result{ Codec.Name, Sample.Name };
+
+		uint64_t CompressedSize = 0;
+		auto Compressed = Codec.Compress(Sample.Data.get(), Sample.Size, CompressedSize);
+
+		Result.CompressedSize = CompressedSize;
+
+		if (Compressed == nullptr || CompressedSize == 0)
+		{
+			Results.EmplaceBack(std::move(Result));
+			continue;
+		}
+
+		MeasureDecode([&]()
+		{
+			return Codec.Decompress(Compressed.get(), CompressedSize, Output.get(), Sample.Size) == Sample.Size;
+		}, Iterations, Sample.Size, Result);
+
+		Result.Verified &= (std::memcmp(Output.get(), Sample.Data.get(), Sample.Size) == 0);
+
+		Results.EmplaceBack(std::move(Result));
+	}
+}
+
+static void BenchmarkPak(const string& Path, uint32_t Iterations, List<CodecResult>& Results)
+{
+	CompressedPak Pak{};
+
+	if (!LoadCompressedPak(Path, Pak))
+		return;
+
+	if (Pak.CompressionType == RpakCompressionType::Respawn)
+	{
+		CodecResult Result{ "RTech", IO::Path::GetFileName(Path), Pak.CompressedSize };
+
+		rpak_decomp_state State;
+		uint64_t DecompressedSize = RTech::DecompressPakfileInit(&State, Pak.Buffer.get(), Pak.CompressedSize, 0, Pak.HeaderSize);
+		auto Output = std::make_unique<uint8_t[]>(DecompressedSize);
+
+		MeasureDecode([&]()
+		{
+			RTech::DecompressPakfileInit(&State, Pak.Buffer.get(), Pak.CompressedSize, 0, Pak.HeaderSize);
+
+			State.out_mask = UINT64_MAX;
+			State.out = uint64_t(Output.get());
+
+			return RTech::DecompressPakFile(&State, DecompressedSize, DecompressedSize) == 1;
+		}, Iterations, DecompressedSize, Result);
+
+		Results.EmplaceBack(std::move(Result));
+	}
+	else if (Pak.CompressionType == RpakCompressionType::Oodle)
+	{
+		CodecResult Result{ "Oodle", IO::Path::GetFileName(Path), Pak.CompressedSize };
+
+		uint64_t CompressedSize = Pak.CompressedSize - Pak.HeaderSize;
+		uint64_t DecompressedSize = Pak.DecompressedSize;
+		auto Output = std::make_unique<uint8_t[]>(DecompressedSize);
+
+		// Some paks count the header in their decompressed size, RpakLib retries the same way
+		if (!RTech::DecompressOodleBuffer(Pak.Buffer.get(), CompressedSize, Output.get(), DecompressedSize))
+			DecompressedSize -= Pak.HeaderSize;
+
+		MeasureDecode([&]()
+		{
+			return RTech::DecompressOodleBuffer(Pak.Buffer.get(), CompressedSize, Output.get(), DecompressedSize);
+		}, Iterations, DecompressedSize, Result);
+
+		Results.EmplaceBack(std::move(Result));
+	}
+}
+
+static void BenchmarkSnowflake(const string& Path, uint32_t Iterations, List<CodecResult>& Results)
+{
+	auto Data = IO::File::ReadAllBytes(Path);
+	uint64_t DataSize = Data.Count();
+
+	CodecResult Result{ "Snowflake", IO::Path::GetFileName(Path), DataSize };
+
+	if (DataSize == 0)
+	{
+		Results.EmplaceBack(std::move(Result));
+		return;
+	}
+
+	// Same state setup as RTech::DecompressStreamedBuffer
+	auto State = std::make_unique<uint8_t[]>(0x25000);
+	auto EditState = (__int64*)State.get();
+
+	RTech::DecompressSnowflakeInit((int64_t)State.get(), (int64_t)&Data[0], DataSize);
+
+	__int64 DecompressedSize = EditState[0x48D3];
+	auto Output = std::make_unique<uint8_t[]>(DecompressedSize);
+
+	MeasureDecode([&]()
+	{
+		RTech::DecompressSnowflakeInit((int64_t)State.get(), (int64_t)&Data[0], DataSize);
+
+		unsigned int v15 = *((unsigned int*)EditState + 0x91A4);
+		__int64 v16 = DecompressedSize;
+		*((uint32_t*)EditState + 0x91A2) = 0;
+		if (v15 < DecompressedSize)
+			v16 = v15;
+
+		EditState[0x48D4] = v16;
+		EditState[0x48DA] = (__int64)Output.get();
+		EditState[0x48DB] = 0;
+
+		RTech::DecompressSnowflake((int64_t)State.get(), DataSize, DecompressedSize);
+
+		return EditState[0x48DB] == DecompressedSize;
+	}, Iterations, DecompressedSize, Result);
+
+	Results.EmplaceBack(std::move(Result));
+}
+
+static void WriteJsonReport(const string& Path, const List<CodecResult>& Results, const CodecBenchmarkOptions& Options)
+{
+	auto Writer = IO::StreamWriter(IO::File::Create(Path));
+
+	Writer.WriteLine("{");
+	Writer.WriteLineFmt("\t\"iterations\": %u,", Options.Iterations);
+	Writer.WriteLineFmt("\t\"synthetic_size\": %llu,", Options.SyntheticSize);
+	Writer.WriteLineFmt("\t\"process_peak_bytes\": %llu,", AllocationTracker::GetProcessPeakBytes());
+	Writer.WriteLine("\t\"results\": [");
+
+	for (uint32_t i = 0; i < Results.Count(); i++)
+	{
+		auto& Result = Results[i];
+
+		Writer.WriteLine("\t\t{");
+		Writer.WriteLineFmt("\t\t\t\"codec\": \"%s\",", (const char*)Result.Codec);
+		Writer.WriteLineFmt("\t\t\t\"sample\": \"%s\",", (const char*)Result.Sample.Replace("\\", "\\\\").Replace("\"", "\\\""));
+		Writer.WriteLineFmt("\t\t\t\"compressed_bytes\": %llu,", Result.CompressedSize);
+		Writer.WriteLineFmt("\t\t\t\"decoded_bytes\": %llu,", Result.DecodedSize);
+		Writer.WriteLineFmt("\t\t\t\"decode_mb_per_sec\": %.3f,", Result.DecodeThroughput);
+		Writer.WriteLineFmt("\t\t\t\"allocations_per_call\": %.2f,", Result.AllocationsPerCall);
+		Writer.WriteLineFmt("\t\t\t\"peak_bytes\": %llu,", Result.PeakBytes);
+		Writer.WriteLineFmt("\t\t\t\"verified\": %s", Result.Verified ? "true" : "false");
+		Writer.WriteLine((i + 1 < Results.Count()) ? "\t\t}," : "\t\t}");
+	}
+
+	Writer.WriteLine("\t]");
+	Writer.WriteLine("}");
+}
+
+uint32_t RunCodecBenchmark(const List<string>& Corpus, const CodecBenchmarkOptions& Options)
+{
+	List<CodecResult> Results;
+	std::vector<CodecSample> Samples;
+
+	if (Options.SyntheticSize > 0)
+		BuildSyntheticSamples(Options.SyntheticSize, Samples);
+
+	for (auto& Sample : Samples)
+		BenchmarkRoundTrip(Sample, Options.Iterations, Results);
+
+	for (auto& Path : Corpus)
+	{
+		if (Path.EndsWith(".rpak"))
+		{
+			BenchmarkPak(Path, Options.Iterations, Results);
+		}
+		else if (Path.EndsWith(".snowflake"))
+		{
+			BenchmarkSnowflake(Path, Options.Iterations, Results);
+		}
+		else
+		{
+			auto Data = IO::File::ReadAllBytes(Path);
+
+			if (Data.Count() == 0)
+				continue;
+
+			CodecSample Sample{ IO::Path::GetFileName(Path), std::make_unique<uint8_t[]>(Data.Count()), Data.Count() };
+			std::memcpy(Sample.Data.get(), &Data[0], Data.Count());
+
+			BenchmarkRoundTrip(Sample, Options.Iterations, Results);
+		}
+	}
+
+	uint32_t Failures = 0;
+
+	printf("%-10s %-36s %12s %12s %10s %14s %8s\n", "codec", "sample", "size (MB)", "MB/s", "allocs", "peak (KB)", "ok");
+
+	for (auto& Result : Results)
+	{
+		if (!Result.Verified)
+			Failures++;
+
+		printf("%-10s %-36s %12.2f %12.2f %10.2f %14.1f %8s\n", (const char*)Result.Codec, (const char*)Result.Sample, (double)Result.DecodedSize / (1024.0 * 1024.0), Result.DecodeThroughput, Result.AllocationsPerCall, (double)Result.PeakBytes / 1024.0, Result.Verified ? "yes" : "NO");
+	}
+
+	printf("process peak: %.2f MB\n", (double)AllocationTracker::GetProcessPeakBytes() / (1024.0 * 1024.0));
+
+	if (!string::IsNullOrEmpty(Options.JsonPath))
+		WriteJsonReport(Options.JsonPath, Results, Options);
+
+	return Failures;
+}
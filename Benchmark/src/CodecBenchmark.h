@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include "ListBase.h"
+#include "StringBase.h"
+
+// Options for the codec benchmark
+struct CodecBenchmarkOptions
+{
+	// How many times each decode is run, the fastest run is reported
+	uint32_t Iterations;
+	// The size of each synthetic sample, 0 disables them
+	uint64_t SyntheticSize;
+	// Where to write the json report, empty to skip it
+	string JsonPath;
+};
+
+// Runs every codec over the synthetic samples and the corpus, reporting decode throughput, allocations and peak memory.
+// Rpaks in the corpus are decoded with the codec they were compressed with, .snowflake dumps with the snowflake decoder,
+// every other file is treated as raw data and round-tripped through the cppkore codecs. Returns the number of failed decodes.
+uint32_t RunCodecBenchmark(const List<string>& Corpus, const CodecBenchmarkOptions& Options);
@@ -0,0 +1,219 @@
+#include "pch.h"
+#include "KernelBenchmark.h"
+#include "Half.h"
+#include <rtech.h>
+#include <chrono>
+#include <random>
+#include <vector>
+
+// Runs the kernel a number of times and keeps the fastest run
+template<typename TKernel>
+static std::chrono::nanoseconds BenchmarkKernel(uint32_t Iterations, TKernel Kernel)
+{
+	auto Best = std::chrono::nanoseconds::max();
+
+	for (uint32_t i = 0; i < Iterations; i++)
+	{
+		auto Start = std::chrono::high_resolution_clock::now();
+		Kernel();
+		auto End = std::chrono::high_resolution_clock::now();
+
+		auto Time = std::chrono::duration_cast<std::chrono::nanoseconds>(End - Start);
+
+		if (Time < Best)
+			Best = Time;
+	}
+
+	return Best;
+}
+
+static double ValuesPerSecond(uint64_t Values, std::chrono::nanoseconds Time)
+{
+	if (Time.count() == 0)
+		return 0.0;
+
+	return (double)Values / ((double)Time.count() / 1e9);
+}
+
+// Counts the values that differ in any bit
+template<typename T>
+static uint64_t CountMismatches(const std::vector<T>& Lhs, const std::vector<T>& Rhs)
+{
+	uint64_t Result = 0;
+
+	for (size_t i = 0; i < Lhs.size(); i++)
+	{
+		if (std::memcmp(&Lhs[i], &Rhs[i], sizeof(T)) != 0)
+			Result++;
+	}
+
+	return Result;
+}
+
+static void PrintKernel(const char* Name, uint64_t Values, std::chrono::nanoseconds ScalarTime, std::chrono::nanoseconds BatchTime, uint64_t Mismatches)
+{
+	printf("%-24s %10llu %16.0f %16.0f %10llu\n", Name, Values, ValuesPerSecond(Values, ScalarTime), ValuesPerSecond(Values, BatchTime), Mismatches);
+}
+
+// Every 16bit pattern, including subnormals, infinities and nans
+static uint64_t RunHalfKernel(uint32_t Iterations)
+{
+	std::vector<uint16_t> Halves(0x10000);
+
+	for (uint32_t i = 0; i < 0x10000; i++)
+		Halves[i] = (uint16_t)i;
+
+	std::vector<float> Scalar(Halves.size());
+	std::vector<float> Batch(Halves.size());
+
+	auto ScalarTime = BenchmarkKernel(Iterations, [&]
+	{
+		for (size_t i = 0; i < Halves.size(); i++)
+			Scalar[i] = Math::Half(Halves[i]).ToFloat();
+	});
+	auto BatchTime = BenchmarkKernel(Iterations, [&] { Math::Half::ToFloat(Halves.data(), Batch.data(), Halves.size()); });
+
+	const uint64_t Mismatches = CountMismatches(Scalar, Batch);
+
+	PrintKernel("half to float", Halves.size(), ScalarTime, BatchTime, Mismatches);
+
+	return Mismatches;
+}
+
+// Random quaternions, plus the extremes of every component and both signs of w
+static uint64_t RunQuat64Kernel(uint32_t Iterations, std::mt19937_64& Random)
+{
+	std::vector<uint64_t> Packed(1 << 20);
+
+	for (auto& Value : Packed)
+		Value = Random();
+
+	const uint64_t Extremes[] = { 0, 0x100000, 0x1FFFFF };
+	size_t Index = 0;
+
+	for (auto X : Extremes)
+		for (auto Y : Extremes)
+			for (auto Z : Extremes)
+				for (uint64_t W = 0; W < 2; W++)
+					Packed[Index++] = X | (Y << 21) | (Z << 42) | (W << 63);
+
+	std::vector<Math::Quaternion> Scalar(Packed.size());
+	std::vector<Math::Quaternion> Batch(Packed.size());
+
+	auto ScalarTime = BenchmarkKernel(Iterations, [&]
+	{
+		for (size_t i = 0; i < Packed.size(); i++)
+			Scalar[i] = RTech::UnpackQuat64(Packed[i]);
+	});
+	auto BatchTime = BenchmarkKernel(Iterations, [&] { RTech::UnpackQuat64Batch(Packed.data(), Batch.data(), (uint32_t)Packed.size()); });
+
+	const uint64_t Mismatches = CountMismatches(Scalar, Batch);
+
+	PrintKernel("quat64 unpack", Packed.size(), ScalarTime, BatchTime, Mismatches);
+
+	return Mismatches;
+}
+
+// Builds an anim value track of random runs covering the frames, raw runs are weighted up since they're the most common
+static std::vector<uint8_t> BuildAnimValueTrack(std::mt19937_64& Random, uint32_t FrameCount, bool RawOnly)
+{
+	// Large enough for a run of the biggest type on every frame, the data of a run is random
+	std::vector<uint8_t> Track(((size_t)FrameCount + 64) * 64);
+
+	for (auto& Value : Track)
+		Value = (uint8_t)Random();
+
+	size_t Offset = 0;
+	uint32_t Frames = 0;
+
+	while (Frames < FrameCount)
+	{
+		uint8_t* Run = Track.data() + Offset;
+
+		Run[0] = (RawOnly || (Random() % 2) == 0) ? 0 : (uint8_t)(1 + Random() % 19);
+		Run[1] = (uint8_t)(1 + Random() % 64);
+
+		Frames += Run[1];
+		Offset = RTech::NextAnimValueRun(Run) - Track.data();
+	}
+
+	return Track;
+}
+
+static uint64_t RunAnimValueKernel(const char* Name, uint32_t Iterations, std::mt19937_64& Random, bool RawOnly)
+{
+	constexpr uint32_t TrackCount = 256;
+	constexpr uint32_t FrameCount = 1024;
+	constexpr float Scale = 0.00019175345f;
+
+	std::vector<std::vector<uint8_t>> Tracks;
+
+	for (uint32_t t = 0; t < TrackCount; t++)
+		Tracks.emplace_back(BuildAnimValueTrack(Random, FrameCount, RawOnly));
+
+	std::vector<float> Scalar(TrackCount * FrameCount * 2);
+	std::vector<float> Batch(TrackCount * FrameCount * 2);
+
+	auto ScalarTime = BenchmarkKernel(Iterations, [&]
+	{
+		for (uint32_t t = 0; t < TrackCount; t++)
+		{
+			float* Values = Scalar.data() + t * FrameCount * 2;
+
+			for (uint32_t f = 0; f < FrameCount; f++)
+				RTech::ExtractAnimValue(f, Tracks[t].data(), Scale, &Values[f], &Values[FrameCount + f]);
+		}
+	});
+	auto BatchTime = BenchmarkKernel(Iterations, [&]
+	{
+		for (uint32_t t = 0; t < TrackCount; t++)
+		{
+			float* Values = Batch.data() + t * FrameCount * 2;
+
+			RTech::ExtractAnimValues(0, FrameCount, Tracks[t].data(), Scale, Values, Values + FrameCount);
+		}
+	});
+
+	uint64_t Mismatches = CountMismatches(Scalar, Batch);
+
+	// Runs that start part way through a track
+	for (uint32_t t = 0; t < TrackCount; t++)
+	{
+		const uint32_t FirstFrame = (uint32_t)(Random() % FrameCount);
+		const uint32_t Count = (uint32_t)(1 + Random() % (FrameCount - FirstFrame));
+
+		std::vector<float> Values(Count), NextValues(Count);
+
+		RTech::ExtractAnimValues(FirstFrame, Count, Tracks[t].data(), Scale, Values.data(), NextValues.data());
+
+		for (uint32_t f = 0; f < Count; f++)
+		{
+			float Value = 0, NextValue = 0;
+
+			RTech::ExtractAnimValue(FirstFrame + f, Tracks[t].data(), Scale, &Value, &NextValue);
+
+			if (std::memcmp(&Value, &Values[f], sizeof(float)) != 0 || std::memcmp(&NextValue, &NextValues[f], sizeof(float)) != 0)
+				Mismatches++;
+		}
+	}
+
+	PrintKernel(Name, (uint64_t)TrackCount * FrameCount, ScalarTime, BatchTime, Mismatches);
+
+	return Mismatches;
+}
+
+uint32_t RunKernelBenchmark(uint32_t Iterations)
+{
+	std::mt19937_64 Random(0x4C6567696F6E);
+
+	printf("%-24s %10s %16s %16s %10s\n", "kernel", "values", "scalar (per s)", "batch (per s)", "mismatch");
+
+	uint64_t Mismatches = 0;
+
+	Mismatches += RunHalfKernel(Iterations);
+	Mismatches += RunQuat64Kernel(Iterations, Random);
+	Mismatches += RunAnimValueKernel("anim values (raw)", Iterations, Random, true);
+	Mismatches += RunAnimValueKernel("anim values (mixed)", Iterations, Random, false);
+
+	return (uint32_t)min(Mismatches, (uint64_t)UINT32_MAX);
+}
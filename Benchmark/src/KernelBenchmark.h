@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstdint>
+
+// Runs the batch animation kernels (anim value runs, packed quaternions, half floats) against their
+// scalar versions on synthetic data. Reports the throughput of each and verifies the results are
+// bit identical, returns the number of mismatches.
+uint32_t RunKernelBenchmark(uint32_t Iterations);
@@ -0,0 +1,113 @@
+#include "pch.h"
+#include "PakBenchmark.h"
+#include "CodecBenchmark.h"
+#include "AnimBenchmark.h"
+#include "KernelBenchmark.h"
+#include "StreamBenchmark.h"
+#include "File.h"
+#include "Directory.h"
+
+// Gathers the files to benchmark and the options, directories are searched for files matching the pattern
+static List<string> BuildCorpus(int argc, char** argv, int Start, const string& SearchPattern, CodecBenchmarkOptions& Options)
+{
+	List<string> Corpus;
+
+	for (int i = Start; i < argc; i++)
+	{
+		string Arg = argv[i];
+
+		if (Arg == "--iterations" && (i + 1) < argc)
+		{
+			Options.Iterations = max(1u, (uint32_t)strtoul(argv[++i], nullptr, 10));
+			continue;
+		}
+		else if (Arg == "--synthetic" && (i + 1) < argc)
+		{
+			Options.SyntheticSize = strtoull(argv[++i], nullptr, 10) * 1024 * 1024;
+			continue;
+		}
+		else if (Arg == "--json" && (i + 1) < argc)
+		{
+			Options.JsonPath = argv[++i];
+			continue;
+		}
+
+		if (IO::Directory::Exists(Arg))
+		{
+			for (auto& File : IO::Directory::GetFiles(Arg, SearchPattern))
+				Corpus.EmplaceBack(File);
+		}
+		else if (IO::File::Exists(Arg))
+		{
+			Corpus.EmplaceBack(Arg);
+		}
+		else
+		{
+			printf("ignoring \"%s\", it doesn't exist\n", argv[i]);
+		}
+	}
+
+	return Corpus;
+}
+
+static void PrintUsage()
+{
+	printf("usage: LegionBench <mode> [files or directories...] [options]\n");
+	printf("modes:\n");
+	printf("  pak       compares the rpak decoder against the reference decoder\n");
+	printf("  codecs    runs every codec over synthetic data and the corpus:\n");
+	printf("            .rpak files are decoded with the codec they were compressed with,\n");
+	printf("            .snowflake files are raw snowflake streams,\n");
+	printf("            anything else is raw data, like segment dumps, round-tripped through the cppkore codecs\n");
+	printf("  anims     compares the per-frame animation decode against the section decoder,\n");
+	printf("            on .animcap sequences recorded with --animcapture by a debug build of Legion\n");
+	printf("  kernels   compares the batch animation kernels against their scalar versions on synthetic data\n");
+	printf("  streams   checks the reads of every seekable stream land where SetPosition and ReadAt leave them\n");
+	printf("options:\n");
+	printf("  --iterations <count>    how many times each decode is run, the fastest is reported (default 5)\n");
+	printf("  --synthetic <MB>        the size of each synthetic sample, 0 disables them (default 16)\n");
+	printf("  --json <path>           writes the codec results as json\n");
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	string Mode = string(argv[1]).ToLower();
+
+	CodecBenchmarkOptions Options{};
+	Options.Iterations = 5;
+	Options.SyntheticSize = 16 * 1024 * 1024;
+
+	if (Mode == "pak")
+	{
+		auto Corpus = BuildCorpus(argc, argv, 2, "*.rpak", Options);
+		return (RunPakBenchmark(Corpus, Options.Iterations) == 0) ? 0 : 2;
+	}
+	else if (Mode == "codecs")
+	{
+		auto Corpus = BuildCorpus(argc, argv, 2, "*", Options);
+		return (RunCodecBenchmark(Corpus, Options) == 0) ? 0 : 2;
+	}
+	else if (Mode == "anims")
+	{
+		auto Corpus = BuildCorpus(argc, argv, 2, "*.animcap", Options);
+		return (RunAnimBenchmark(Corpus, Options.Iterations) == 0) ? 0 : 2;
+	}
+	else if (Mode == "kernels")
+	{
+		BuildCorpus(argc, argv, 2, "*", Options);
+		return (RunKernelBenchmark(Options.Iterations) == 0) ? 0 : 2;
+	}
+	else if (Mode == "streams")
+	{
+		return (RunStreamBenchmark() == 0) ? 0 : 2;
+	}
+
+	PrintUsage();
+	return 1;
+}
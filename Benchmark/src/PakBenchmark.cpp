@@ -0,0 +1,156 @@
+#include "pch.h"
+#include "PakBenchmark.h"
+#include "rtech.h"
+#include "File.h"
+#include "Path.h"
+#include "BinaryReader.h"
+#include <chrono>
+
+typedef uint8_t(__fastcall* PakDecoder)(rpak_decomp_state*, uint64_t, uint64_t);
+
+bool LoadCompressedPak(const string& Path, CompressedPak& Pak)
+{
+	IO::BinaryReader Reader = IO::BinaryReader(IO::File::OpenRead(Path));
+	RpakBaseHeader BaseHeader = Reader.Read<RpakBaseHeader>();
+
+	if (BaseHeader.Magic != 0x6B615052)
+		return false;
+
+	Reader.GetBaseStream()->SetPosition(0);
+
+	switch (BaseHeader.Version)
+	{
+	case (uint32_t)RpakGameVersion::Apex:
+	{
+		RpakApexHeader Header = Reader.Read<RpakApexHeader>();
+
+		if (Header.CompressionType == RpakCompressionType::None || Header.CompressedSize == Header.DecompressedSize)
+			return false;
+
+		Pak.CompressionType = Header.CompressionType;
+		Pak.CompressedSize = Header.CompressedSize;
+		Pak.DecompressedSize = Header.DecompressedSize;
+		Pak.HeaderSize = sizeof(RpakApexHeader);
+		break;
+	}
+	case (uint32_t)RpakGameVersion::Titanfall:
+	{
+		RpakTitanfallHeader Header = Reader.Read<RpakTitanfallHeader>();
+
+		if (Header.CompressedSize == Header.DecompressedSize)
+			return false;
+
+		Pak.CompressionType = RpakCompressionType::Respawn;
+		Pak.CompressedSize = Header.CompressedSize;
+		Pak.DecompressedSize = Header.DecompressedSize;
+		Pak.HeaderSize = sizeof(RpakTitanfallHeader);
+		break;
+	}
+	default:
+		return false;
+	}
+
+	// The respawn decoder expects the header to be part of it's input, oodle data starts at the buffer
+	if (Pak.CompressionType == RpakCompressionType::Respawn)
+	{
+		Pak.Buffer = std::make_unique<uint8_t[]>(Pak.CompressedSize);
+		Reader.Read(Pak.Buffer.get() + Pak.HeaderSize, 0, Pak.CompressedSize - Pak.HeaderSize);
+	}
+	else
+	{
+		Pak.Buffer = std::make_unique<uint8_t[]>(Pak.CompressedSize - Pak.HeaderSize);
+		Reader.Read(Pak.Buffer.get(), 0, Pak.CompressedSize - Pak.HeaderSize);
+	}
+
+	return true;
+}
+
+// Decodes the pak into the output buffer, returning the time spent in the decoder alone
+static std::chrono::nanoseconds DecodePak(PakDecoder Decoder, CompressedPak& Pak, std::unique_ptr<uint8_t[]>& Output, uint64_t& OutputSize, uint8_t& Result)
+{
+	rpak_decomp_state State;
+
+	uint64_t DecompressedSize = RTech::DecompressPakfileInit(&State, Pak.Buffer.get(), Pak.CompressedSize, 0, Pak.HeaderSize);
+
+	if (Output == nullptr || OutputSize != DecompressedSize)
+	{
+		Output = std::make_unique<uint8_t[]>(DecompressedSize);
+		OutputSize = DecompressedSize;
+	}
+
+	State.out_mask = UINT64_MAX;
+	State.out = uint64_t(Output.get());
+
+	auto Start = std::chrono::high_resolution_clock::now();
+	Result = Decoder(&State, DecompressedSize, DecompressedSize);
+	auto End = std::chrono::high_resolution_clock::now();
+
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(End - Start);
+}
+
+// Runs the decoder a number of times and keeps the fastest run
+static std::chrono::nanoseconds BenchmarkDecoder(PakDecoder Decoder, CompressedPak& Pak, uint32_t Iterations, std::unique_ptr<uint8_t[]>& Output, uint64_t& OutputSize, uint8_t& Result)
+{
+	auto Best = std::chrono::nanoseconds::max();
+
+	for (uint32_t i = 0; i < Iterations; i++)
+	{
+		auto Time = DecodePak(Decoder, Pak, Output, OutputSize, Result);
+
+		if (Time < Best)
+			Best = Time;
+	}
+
+	return Best;
+}
+
+static double Throughput(uint64_t Size, std::chrono::nanoseconds Time)
+{
+	if (Time.count() == 0)
+		return 0.0;
+
+	return ((double)Size / (1024.0 * 1024.0)) / ((double)Time.count() / 1e9);
+}
+
+uint32_t RunPakBenchmark(const List<string>& Corpus, uint32_t Iterations)
+{
+	uint32_t Mismatches = 0;
+	uint64_t TotalSize = 0;
+	auto TotalReference = std::chrono::nanoseconds::zero();
+	auto TotalFast = std::chrono::nanoseconds::zero();
+
+	printf("%-40s %12s %12s %12s %8s\n", "pak", "size (MB)", "ref (MB/s)", "fast (MB/s)", "match");
+
+	for (auto& Path : Corpus)
+	{
+		CompressedPak Pak{};
+
+		if (!LoadCompressedPak(Path, Pak) || Pak.CompressionType != RpakCompressionType::Respawn)
+		{
+			printf("%-40s skipped, not respawn compressed\n", (const char*)IO::Path::GetFileName(Path));
+			continue;
+		}
+
+		std::unique_ptr<uint8_t[]> ReferenceOutput = nullptr, FastOutput = nullptr;
+		uint64_t ReferenceSize = 0, FastSize = 0;
+		uint8_t ReferenceResult = 0, FastResult = 0;
+
+		auto ReferenceTime = BenchmarkDecoder(RTech::DecompressPakFileReference, Pak, Iterations, ReferenceOutput, ReferenceSize, ReferenceResult);
+		auto FastTime = BenchmarkDecoder(RTech::DecompressPakFile, Pak, Iterations, FastOutput, FastSize, FastResult);
+
+		bool Match = (ReferenceResult == FastResult) && (ReferenceSize == FastSize) && std::memcmp(ReferenceOutput.get(), FastOutput.get(), ReferenceSize) == 0;
+
+		if (!Match)
+			Mismatches++;
+
+		TotalSize += ReferenceSize;
+		TotalReference += ReferenceTime;
+		TotalFast += FastTime;
+
+		printf("%-40s %12.2f %12.2f %12.2f %8s\n", (const char*)IO::Path::GetFileName(Path), (double)ReferenceSize / (1024.0 * 1024.0), Throughput(ReferenceSize, ReferenceTime), Throughput(FastSize, FastTime), Match ? "yes" : "NO");
+	}
+
+	printf("%-40s %12.2f %12.2f %12.2f %8u\n", "total", (double)TotalSize / (1024.0 * 1024.0), Throughput(TotalSize, TotalReference), Throughput(TotalSize, TotalFast), Mismatches);
+
+	return Mismatches;
+}
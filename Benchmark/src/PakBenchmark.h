@@ -0,0 +1,24 @@
+#pragma once
+
+#include <memory>
+#include <cstdint>
+#include "ListBase.h"
+#include "StringBase.h"
+#include "RpakLib.h"
+
+// A compressed pak, loaded the same way RpakLib mounts it
+struct CompressedPak
+{
+	RpakCompressionType CompressionType;
+	std::unique_ptr<uint8_t[]> Buffer;
+	uint64_t CompressedSize;
+	uint64_t DecompressedSize;
+	uint64_t HeaderSize;
+};
+
+// Loads a compressed pak, returns false if the pak isn't compressed
+bool LoadCompressedPak(const string& Path, CompressedPak& Pak);
+
+// Decompresses every respawn compressed rpak in the corpus with both pak decoders.
+// Reports the throughput of each and verifies their output matches, returns the number of mismatches.
+uint32_t RunPakBenchmark(const List<string>& Corpus, uint32_t Iterations);
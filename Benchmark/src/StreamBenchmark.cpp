@@ -0,0 +1,113 @@
+#include "pch.h"
+#include "StreamBenchmark.h"
+#include "File.h"
+#include "Path.h"
+#include "MemoryStream.h"
+#include "RandomAccessStream.h"
+#include "BinaryReader.h"
+#include <vector>
+
+// Bigger than the default stream buffers, so reads cross buffer boundaries
+constexpr uint64_t StreamSampleSize = 3 * 4096 + 123;
+// A string that starts before the end of the first buffer and ends after it
+constexpr uint64_t StreamStringOffset = 4096 - 5;
+constexpr uint64_t StreamStringLength = 11;
+
+static std::vector<uint8_t> BuildStreamSample()
+{
+	std::vector<uint8_t> Sample(StreamSampleSize);
+
+	for (uint64_t i = 0; i < StreamSampleSize; i++)
+		Sample[i] = (uint8_t)((i * 31) % 251) + 1;
+
+	Sample[StreamStringOffset + StreamStringLength] = 0;
+
+	return Sample;
+}
+
+// Compares a read against the sample at the given offset
+static uint32_t CheckRead(const char* Name, const char* Step, const std::vector<uint8_t>& Sample, const uint8_t* Data, uint64_t Read, uint64_t Offset, uint64_t Count)
+{
+	if (Read == Count && std::memcmp(Data, Sample.data() + Offset, Count) == 0)
+		return 0;
+
+	printf("%-16s %s: expected %llu bytes at %llu\n", Name, Step, Count, Offset);
+	return 1;
+}
+
+static uint32_t CheckPosition(const char* Name, const char* Step, IO::Stream* Stream, uint64_t Expected)
+{
+	auto Position = Stream->GetPosition();
+
+	if (Position == Expected)
+		return 0;
+
+	printf("%-16s %s: position is %llu, expected %llu\n", Name, Step, Position, Expected);
+	return 1;
+}
+
+static uint32_t RunStreamChecks(const char* Name, IO::Stream* Stream, const std::vector<uint8_t>& Sample)
+{
+	uint32_t Mismatches = 0;
+	uint8_t Buffer[64]{};
+
+	// Fill the read buffer first, so a stale buffer or position shows up in the reads after it
+	Mismatches += CheckRead(Name, "Read", Sample, Buffer, Stream->Read(Buffer, 0, 16), 0, 16);
+
+	// SetPosition -> ReadAt -> Read, the ReadAt must leave the position SetPosition moved to
+	Stream->SetPosition(5000);
+	Mismatches += CheckRead(Name, "ReadAt", Sample, Buffer, Stream->ReadAt(Buffer, 0, 32, 9000), 9000, 32);
+	Mismatches += CheckPosition(Name, "ReadAt", Stream, 5000);
+	Mismatches += CheckRead(Name, "Read after ReadAt", Sample, Buffer, Stream->Read(Buffer, 0, 32), 5000, 32);
+	Mismatches += CheckPosition(Name, "Read after ReadAt", Stream, 5032);
+
+	// ReadAt in the middle of buffered data
+	Mismatches += CheckRead(Name, "buffered ReadAt", Sample, Buffer, Stream->ReadAt(Buffer, 0, 16, 100), 100, 16);
+	Mismatches += CheckRead(Name, "buffered Read", Sample, Buffer, Stream->Read(Buffer, 0, 16), 5032, 16);
+
+	// A c string crossing the end of a buffer, then the bytes after it's terminator
+	IO::BinaryReader Reader(Stream, true);
+
+	Stream->SetPosition(StreamStringOffset);
+	auto String = Reader.ReadCString();
+
+	Mismatches += CheckRead(Name, "ReadCString", Sample, (const uint8_t*)String.ToCString(), String.Length(), StreamStringOffset, StreamStringLength);
+	Mismatches += CheckPosition(Name, "ReadCString", Stream, StreamStringOffset + StreamStringLength + 1);
+	Mismatches += CheckRead(Name, "Read after ReadCString", Sample, Buffer, Stream->Read(Buffer, 0, 8), StreamStringOffset + StreamStringLength + 1, 8);
+
+	printf("%-16s %10u\n", Name, Mismatches);
+
+	return Mismatches;
+}
+
+uint32_t RunStreamBenchmark()
+{
+	auto Sample = BuildStreamSample();
+	auto SamplePath = IO::Path::GetTempFileName();
+
+	IO::File::WriteAllBytes(SamplePath, Sample.data(), Sample.size());
+
+	printf("%-16s %10s\n", "stream", "mismatch");
+
+	uint32_t Mismatches = 0;
+
+	{
+		auto Stream = IO::File::OpenRead(SamplePath);
+		Mismatches += RunStreamChecks("file", Stream.get(), Sample);
+	}
+
+	{
+		std::shared_ptr<IO::RandomAccessFile> File = IO::RandomAccessFile::OpenRead(SamplePath);
+		IO::RandomAccessStream Stream(File);
+		Mismatches += RunStreamChecks("random access", &Stream, Sample);
+	}
+
+	{
+		IO::MemoryStream Stream(Sample.data(), 0, Sample.size(), false, true);
+		Mismatches += RunStreamChecks("memory", &Stream, Sample);
+	}
+
+	IO::File::Delete(SamplePath);
+
+	return Mismatches;
+}
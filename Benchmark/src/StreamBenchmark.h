@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstdint>
+
+// Runs the position sensitive reads (Read, ReadAt, ReadCString) of the file, random access and memory streams
+// over a synthetic file, mixing them with SetPosition. Verifies every read returns the data at the expected
+// offset and leaves the expected position, returns the number of mismatches.
+uint32_t RunStreamBenchmark();
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <memory>
+#include <cstdint>
+#include "Mesh.h"
+#include "Vector2.h"
+#include "Vector3.h"
+
+// Builds indexed meshes from bsp triangles, corners that share a position, normal and uv
+// are welded into one vertex. One builder can be reused for every mesh of a map.
+class BspMeshBuilder
+{
+public:
+	BspMeshBuilder();
+	~BspMeshBuilder() = default;
+
+	// Starts a mesh, the position and normal lumps must stay valid until the next one.
+	void Begin(Assets::Mesh& Mesh, const Math::Vector3* Positions, const Math::Vector3* Normals, uint32_t TriangleCount);
+	// Gets the mesh vertex for a corner, adding it when no corner with the same values was added yet.
+	uint32_t AddVertex(uint16_t Index, int32_t PositionIndex, int32_t NormalIndex, const Math::Vector2& UV);
+
+	// Adds the triangles of a bsp mesh, indices are relative to the vertex lump passed in.
+	template<typename TVertex>
+	void AddTriangles(const uint16_t* Indices, uint32_t TriangleCount, const TVertex* Vertices)
+	{
+		for (uint32_t t = 0; t < TriangleCount; t++, Indices += 3)
+		{
+			const TVertex& V1 = Vertices[Indices[0]];
+			const TVertex& V2 = Vertices[Indices[1]];
+			const TVertex& V3 = Vertices[Indices[2]];
+
+			const uint32_t Index1 = this->AddVertex(Indices[0], V1.posIdx, V1.nmlIdx, V1.tex);
+			const uint32_t Index2 = this->AddVertex(Indices[1], V2.posIdx, V2.nmlIdx, V2.tex);
+			const uint32_t Index3 = this->AddVertex(Indices[2], V3.posIdx, V3.nmlIdx, V3.tex);
+
+			this->_Mesh->Faces.EmplaceBack(Index1, Index2, Index3);
+		}
+	}
+
+private:
+	struct WeldEntry
+	{
+		int32_t PositionIndex;
+		int32_t NormalIndex;
+		uint32_t U;
+		uint32_t V;
+		uint32_t Vertex;
+		// The mesh the entry belongs to, stale entries are skipped instead of clearing the table
+		uint32_t Generation;
+	};
+
+	Assets::Mesh* _Mesh;
+	const Math::Vector3* _Positions;
+	const Math::Vector3* _Normals;
+	uint32_t _Generation;
+
+	// Faces index the lump with 16 bits, so every corner seen before in the mesh is resolved without hashing
+	std::unique_ptr<uint32_t[]> _IndexVertices;
+	std::unique_ptr<uint32_t[]> _IndexGenerations;
+
+	std::unique_ptr<WeldEntry[]> _Table;
+	uint32_t _TableMask;
+};
@@ -122,6 +122,8 @@ public:
 	void MountBank(const string& Path);
 	// Extracts a Miles audio file
 	bool ExtractAsset(const MilesAudioAsset& Asset, const string& FilePath);
+	// Lets the next extract try loading the bink decoder again if it failed, called when an export starts
+	static void BeginExport();
 
 	// Builds the viewer list of assets
 	std::unique_ptr<List<ApexAsset>> BuildAssetList();
@@ -130,6 +132,8 @@ public:
 	Dictionary<uint64_t, MilesAudioAsset> Assets;
 
 private:
+	// Mounts a Miles Mstr file, if it matches the selected language
+	bool MountStreamBank(const string& Path, MilesLanguageID SelectedLanguage);
 
 	// A list of streaming audio bank files
 	Dictionary<uint32_t, MilesStreamBank> StreamBanks;
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <memory>
+#include <cstdint>
+#include "StringBase.h"
+#include "ListBase.h"
+#include "Stream.h"
+#include "BinaryWriter.h"
+#include "Animation.h"
+#include "animtypes.h"
+
+#ifdef LEGION_ANIM_CAPTURE
+// Identifies a capture written by BeginCapture, 'ACAP'
+constexpr uint32_t AnimCaptureMagic = 0x50414341;
+constexpr uint32_t AnimCaptureVersion = 1;
+#endif
+
+// The way an animation's frames are split over it's sections
+struct RpakAnimLayout
+{
+	uint32_t FrameCount;
+	// The count of frames stored in the first section
+	uint32_t SplitFrames;
+	// The count of frames stored in every following section, 0 when the animation isn't sectioned
+	uint32_t SectionFrames;
+};
+
+// A run of consecutive frames that are stored in the same section
+struct RpakAnimSection
+{
+	// The index of the section in the animation's section table
+	uint32_t Index;
+	// The first frame of the animation in the run
+	uint32_t FirstFrame;
+	// The frame inside of the section that the first frame is stored at
+	uint32_t FirstSectionFrame;
+	// The count of frames in the run
+	uint32_t FrameCount;
+};
+
+// Decodes rle animation data section by section, every bone track of a section
+// is resolved once and then decoded for all of it's frames.
+class RpakAnimDecoder
+{
+public:
+	RpakAnimDecoder(Assets::Animation& Anim, uint32_t BoneCount, bool Additive);
+	~RpakAnimDecoder() = default;
+
+	// Splits the frames of the animation into the sections they're stored in, in frame order.
+	static List<RpakAnimSection> BuildSections(const RpakAnimLayout& Layout);
+
+	// Resolves the bone tracks of a section that's already in memory, it must stay valid until it's decoded.
+	void ResolveSection(uint8_t* Data, uint64_t Size);
+	// Reads the section at the stream's position into the decoder, then resolves it.
+	void ReadSection(IO::Stream* Stream);
+	// Decodes every frame of the run from the resolved section.
+	void DecodeSection(const RpakAnimSection& Section);
+
+	// Decodes one key of a bone track into the animation, advancing the track data past it.
+	void CalcBonePosition(const mstudio_rle_anim_t& BoneFlags, uint16_t** BoneTrackData, uint32_t BoneIndex, uint32_t Frame, uint32_t FrameIndex);
+	void CalcBoneQuaternion(const mstudio_rle_anim_t& BoneFlags, uint16_t** BoneTrackData, uint32_t BoneIndex, uint32_t Frame, uint32_t FrameIndex);
+	void CalcBoneScale(const mstudio_rle_anim_t& BoneFlags, uint16_t** BoneTrackData, uint32_t BoneIndex, uint32_t Frame, uint32_t FrameIndex);
+
+#ifdef LEGION_ANIM_CAPTURE
+	// Writes the layout and every section decoded from now on to a capture, for replaying in LegionBench.
+	void BeginCapture(const string& Path, const RpakAnimLayout& Layout);
+#endif
+
+private:
+	struct BoneTrack
+	{
+		mstudio_rle_anim_t Header;
+		uint8_t Flags;
+		uint32_t BoneIndex;
+		uint16_t* Data;
+
+		// Where the data of each channel starts
+		uint16_t* Position;
+		uint16_t* Rotation;
+		uint16_t* Scale;
+
+		// The channels that aren't animated hold one value for the whole section
+		float StaticPosition[3];
+		Math::Quaternion StaticRotation;
+		float StaticScale[3];
+	};
+
+	Assets::Animation& _Anim;
+	uint32_t _BoneCount;
+	bool _Additive;
+
+	// The tracks of the resolved section
+	List<BoneTrack> _Tracks;
+	uint8_t* _SectionData;
+	uint64_t _SectionSize;
+
+	// Values that aren't animated, converted in one batch when the section is resolved
+	std::unique_ptr<uint16_t[]> _StaticHalves;
+	std::unique_ptr<float[]> _StaticFloats;
+	std::unique_ptr<uint64_t[]> _StaticQuats;
+	std::unique_ptr<Math::Quaternion[]> _StaticRotations;
+	uint32_t _StaticHalfCapacity;
+	uint32_t _StaticQuatCapacity;
+
+	// Frame values of the run being decoded, reused for every section
+	std::unique_ptr<float[]> _Scratch;
+	uint32_t _ScratchFrames;
+
+	// Sections read from a stream, reused for every section
+	std::unique_ptr<uint8_t[]> _Buffer;
+	uint64_t _BufferSize;
+
+#ifdef LEGION_ANIM_CAPTURE
+	std::unique_ptr<IO::BinaryWriter> _Capture;
+#endif
+
+	// Makes sure the section buffer fits the size, keeping it's contents.
+	void EnsureBuffer(uint64_t Size);
+	// Converts the channels that aren't animated of every track in the section.
+	void ResolveStaticValues();
+	// Makes sure the static buffers fit the counts of the section.
+	void EnsureStatic(uint32_t HalfCount, uint32_t QuatCount);
+	// Makes sure the frame values fit the count of frames.
+	void EnsureScratch(uint32_t FrameCount);
+
+	// Decodes each channel of a track for every frame of the run.
+	void DecodePositions(const BoneTrack& Track, const RpakAnimSection& Section);
+	void DecodeRotations(const BoneTrack& Track, const RpakAnimSection& Section);
+	void DecodeScales(const BoneTrack& Track, const RpakAnimSection& Section);
+};
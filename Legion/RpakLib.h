@@ -6,6 +6,8 @@
 #include "MemoryStream.h"
 #include "FileStream.h"
 #include "BinaryReader.h"
+#include "MemoryMappedFile.h"
+#include "RandomAccessStream.h"
 
 #include "RpakAssets.h"
 #include "ApexAsset.h"
@@ -18,7 +20,7 @@
 
 #include <assets/shader.h>
 
-#define MAX_LOADED_FILES 4096
+#include <future>
 
 #pragma pack(push, 1)
 struct RpakBaseHeader
@@ -262,13 +264,33 @@ public:
 
 	Dictionary<uint64_t, RpakApexAssetEntry> AssetHashmap;
 
-	std::unique_ptr<uint8_t[]> SegmentData;
+	// Owns the segment data for paks that had to be decompressed,
+	// uncompressed paks point SegmentData directly into MappedFile instead.
+	std::unique_ptr<uint8_t[]> SegmentBuffer;
+	std::unique_ptr<IO::MemoryMappedFile> MappedFile;
+
+	uint8_t* SegmentData;
 	uint64_t SegmentDataSize;
 
 	std::unique_ptr<uint8_t[]> PatchData;
 	uint64_t PatchDataSize;
 };
 
+// Holds the state of a single pak while it's being mounted
+struct RpakMountContext
+{
+	string Path;
+	bool Dump;
+
+	std::unique_ptr<RpakFile> File;
+	// Patch paks referenced by this pak, in load order
+	List<string> PatchPaths;
+	// Set when mounting threw, rethrown once the pak is merged
+	std::exception_ptr Error;
+
+	RpakMountContext(const string& Path, bool Dump);
+};
+
 struct RpakLoadAsset
 {
 	uint64_t NameHash;
@@ -421,6 +443,28 @@ static std::map<SubtitleLanguageHash, string> SubtitleLanguageMap{
 	{SubtitleLanguageHash::Spanish, "spanish"},
 };
 
+// An image written during the current export session
+struct RpakExportedImage
+{
+	string Name;
+	string FilePath;
+};
+
+// A texture slot of a material, exported along with it
+struct RpakMaterialImage
+{
+	uint64_t Hash;
+	string NameOverride;
+	bool NormalRecalculate;
+};
+
+// A material parsed during the current export session
+struct RpakExportedMaterial
+{
+	RMdlMaterial Material;
+	List<RpakMaterialImage> Images;
+};
+
 class RpakLib
 {
 public:
@@ -430,6 +474,8 @@ public:
 	void LoadRpaks(const List<string>& Paths);
 	void LoadRpak(const string& Path, bool Dump = false);
 	void PatchAssets();
+	// Closes the cached starpak handles once an export is done, streams still reading keep their handle open
+	void ReleaseStarpakHandles();
 
 	Dictionary<uint64_t, RpakLoadAsset> Assets;
 
@@ -437,6 +483,13 @@ public:
 	bool m_bAnimExporterInitialized = false;
 	bool m_bImageExporterInitialized = false;
 
+	// Memory map uncompressed paks instead of copying them into memory
+	bool m_bMapUncompressedPaks = true;
+#ifdef LEGION_ANIM_CAPTURE
+	// When set, every decoded animation sequence is also captured here for LegionBench
+	string AnimCapturePath;
+#endif
+
 	// Builds the viewer list of assets
 	std::unique_ptr<List<ApexAsset>> BuildAssetList(const std::array<bool, 12>& arrAssets);
 	// Builds the preview model mesh
@@ -478,16 +531,32 @@ public:
 	List<ShaderVar> ExtractShaderVars(const RpakLoadAsset& Asset, const std::string& CBufName = "", D3D_SHADER_VARIABLE_TYPE Type = D3D_SVT_FORCE_DWORD); // default value as a type that should never be used
 	Dictionary<uint32_t, ShaderResBinding> ExtractShaderResourceBindings(const RpakLoadAsset& Asset, D3D_SHADER_INPUT_TYPE InputType);
 
+	// Finds a loaded asset of the type by it's short name, the file name without extension in lowercase.
+	// Each type is indexed once on first use and again after assets are patched, returns nullptr if it isn't loaded.
+	const RpakLoadAsset* FindAssetByName(AssetType_t Type, const string& Name);
+
 	// Used by the BSP system.
 	RMdlMaterial ExtractMaterial(const RpakLoadAsset& Asset, const string& Path, bool IncludeImages, bool IncludeImageNames);
 
 private:
-	std::array<RpakFile, MAX_LOADED_FILES> LoadedFiles;
-	uint32_t LoadedFileIndex;
+	// Mounted paks, allocated individually so assets can keep a pointer to their pak
+	std::vector<std::unique_ptr<RpakFile>> LoadedFiles;
 
-	List<string> LoadFileQueue;
 	List<string> LoadedFilePaths;
 
+	// Open starpak handles keyed by pak and starpak index, shared by every stream reading from them
+	Dictionary<uint64_t, std::shared_ptr<IO::RandomAccessFile>> StarpakHandles;
+	std::mutex StarpakHandleLock;
+
+	// Images and materials already exported this session, keyed by guid and output format
+	Dictionary<string, std::shared_future<RpakExportedImage>> ExportedImages;
+	Dictionary<string, std::shared_future<RpakExportedMaterial>> ExportedMaterials;
+	std::mutex ExportCacheLock;
+
+	// Short asset names to hashes for each indexed asset type
+	Dictionary<uint32_t, std::shared_ptr<Dictionary<string, uint64_t>>> AssetNameIndex;
+	std::mutex AssetNameIndexLock;
+
 	// The exporter formats for models and anims
 	std::unique_ptr<Assets::Exporters::Exporter> ModelExporter;
 	std::unique_ptr<Assets::Exporters::Exporter> AnimExporter;
@@ -500,7 +569,7 @@ private:
 	uint64_t GetFileOffset(const RpakLoadAsset& Asset, uint32_t SegmentIndex, uint32_t SegmentOffset);
 	uint64_t GetFileOffset(const RpakLoadAsset& Asset, RPakPtr& ptr);
 	uint64_t GetEmbeddedStarpakOffset(const RpakLoadAsset& asset);
-	std::unique_ptr<IO::FileStream> GetStarpakStream(const RpakLoadAsset& Asset, bool Optimal);
+	std::unique_ptr<IO::Stream> GetStarpakStream(const RpakLoadAsset& Asset, bool Optimal);
 
 	string ReadStringFromPointer(const RpakLoadAsset& Asset, const RPakPtr& ptr);
 	string ReadStringFromPointer(const RpakLoadAsset& Asset, uint32_t index, uint32_t offset);
@@ -525,6 +594,14 @@ private:
 	void BuildRUIInfo(const RpakLoadAsset& Asset, ApexAsset& Info);
 	void BuildWrapInfo(const RpakLoadAsset& Asset, ApexAsset& Info);
 
+	// purpose: read just the name of an asset for the name index
+	string ReadModelName(const RpakLoadAsset& Asset);
+	string ReadMaterialName(const RpakLoadAsset& Asset);
+	// Reads the name along with the header it's read from, for the asset info
+	string ReadModelName(const RpakLoadAsset& Asset, ModelHeader& Header);
+	string ReadMaterialName(const RpakLoadAsset& Asset, MaterialHeader& Header);
+	std::shared_ptr<Dictionary<string, uint64_t>> BuildAssetNameIndex(AssetType_t Type);
+
 	std::unique_ptr<Assets::Model> ExtractModel(const RpakLoadAsset& Asset, const string& Path, const string& AnimPath, bool IncludeMaterials, bool IncludeAnimations);
 	std::unique_ptr<Assets::Model> ExtractModel_V16(const RpakLoadAsset& Asset, const string& Path, const string& AnimPath, bool IncludeMaterials, bool IncludeAnimations);
 	void ExtractModelLod(IO::BinaryReader& Reader, const std::unique_ptr<IO::MemoryStream>& RpakStream, string Name, uint64_t Offset, const std::unique_ptr<Assets::Model>& Model, RMdlFixupPatches& Fixup, uint32_t Version, bool IncludeMaterials);
@@ -532,6 +609,8 @@ private:
 	void ExtractModelLod_V16(IO::BinaryReader& Reader, const std::unique_ptr<IO::MemoryStream>& RpakStream, string Name, uint64_t Offset, const std::unique_ptr<Assets::Model>& Model, RMdlFixupPatches& Fixup, uint32_t Version, bool IncludeMaterials);
 	void ExtractModelLodOld(IO::BinaryReader& Reader, const std::unique_ptr<IO::MemoryStream>& RpakStream, string Name, uint64_t Offset, const std::unique_ptr<Assets::Model>& Model, RMdlFixupPatches& Fixup, uint32_t Version, bool IncludeMaterials);
 	void ExtractTexture(const RpakLoadAsset& asset, std::unique_ptr<Assets::Texture>& texture, string& name);
+	RpakExportedMaterial ParseMaterial(const RpakLoadAsset& Asset);
+	void ResetExportCache();
 	void ExtractUIIA(const RpakLoadAsset& Asset, std::unique_ptr<Assets::Texture>& Texture);
 	void ExtractAnimation_V11(const RpakLoadAsset& Asset, const List<Assets::Bone>& Skeleton, const string& Path);
 	void ExtractAnimation(const RpakLoadAsset& Asset, const List<Assets::Bone>& Skeleton, const string& Path);
@@ -556,20 +635,27 @@ private:
 	void R_WriteRSONFile(const RpakLoadAsset& Asset, std::ofstream& out, IO::BinaryReader & Reader, RSONNode node, int level);
 
 	string GetSubtitlesNameFromHash(uint64_t Hash);
-	void CalcBonePosition(const mstudio_rle_anim_t& BoneFlags, uint16_t** BoneTrackData, const std::unique_ptr<Assets::Animation>& Anim, uint32_t BoneIndex, uint32_t Frame, uint32_t FrameIndex);
-	void CalcBoneQuaternion(const mstudio_rle_anim_t& BoneFlags, uint16_t** BoneTrackData, const std::unique_ptr<Assets::Animation>& Anim, uint32_t BoneIndex, uint32_t Frame, uint32_t FrameIndex);
-	void CalcBoneScale(const mstudio_rle_anim_t& BoneFlags, uint16_t** BoneTrackData, const std::unique_ptr<Assets::Animation>& Anim, uint32_t BoneIndex, uint32_t Frame, uint32_t FrameIndex);
 
 	bool ValidateAssetPatchStatus(const RpakLoadAsset& Asset);
 	bool ValidateAssetStreamStatus(const RpakLoadAsset& Asset);
 
-	bool MountRpak(const string& Path, bool Dump);
-	void MountStarpak(const string& Path, uint32_t FileIndex, uint32_t StarpakIndex, bool Optimal);
-
-	bool MountApexRpak(const string& Path, bool Dump);
-	bool ParseApexRpak(const string& RpakPath, std::unique_ptr<IO::MemoryStream>& ParseStream);
-	bool MountTitanfallRpak(const string& Path, bool Dump);
-	bool ParseTitanfallRpak(const string& RpakPath, std::unique_ptr<IO::MemoryStream>& ParseStream);
-	bool MountR2TTRpak(const string& Path, bool Dump);
-	bool ParseR2TTRpak(const string& RpakPath, std::unique_ptr<IO::MemoryStream>& ParseStream);
+	// Mounts a pak and the patch paks it references, without touching the loaded files
+	void MountRpakChain(const string& Path, bool Dump, bool IsFirstChain, std::vector<RpakMountContext>& Chain);
+	// Merges a mounted chain into the loaded files in the same order a serial load would
+	void CommitRpakChain(const string& Path, bool Dump, std::vector<RpakMountContext>& Chain);
+
+	bool MountRpak(RpakMountContext& Context);
+	void MountStarpak(const string& Path, RpakFile& File, uint32_t StarpakIndex, bool Optimal);
+
+	bool MountApexRpak(RpakMountContext& Context);
+	bool ParseApexRpak(RpakMountContext& Context, std::unique_ptr<IO::MemoryStream>& ParseStream, std::unique_ptr<IO::MemoryMappedFile> MappedFile = nullptr);
+	bool MountTitanfallRpak(RpakMountContext& Context);
+	bool ParseTitanfallRpak(RpakMountContext& Context, std::unique_ptr<IO::MemoryStream>& ParseStream, std::unique_ptr<IO::MemoryMappedFile> MappedFile = nullptr);
+	bool MountR2TTRpak(RpakMountContext& Context);
+	bool ParseR2TTRpak(RpakMountContext& Context, std::unique_ptr<IO::MemoryStream>& ParseStream, std::unique_ptr<IO::MemoryMappedFile> MappedFile = nullptr);
+
+	// Opens a read-only view of an uncompressed pak, returns nullptr when mapping is disabled
+	std::unique_ptr<IO::MemoryStream> MapRpak(const string& Path, std::unique_ptr<IO::MemoryMappedFile>& MappedFile);
+	// Attaches the remaining data in the parse stream as the segment data of the file
+	void LoadSegmentData(RpakFile* File, std::unique_ptr<IO::MemoryStream>& ParseStream, std::unique_ptr<IO::MemoryMappedFile>& MappedFile);
 };
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 #include "BinaryReader.h"
+#include "MemoryMappedFile.h"
+#include "RandomAccessFile.h"
 #include "..\cppkore_incl\LZHAM_ALPHA\lzham.h"
 
 constexpr unsigned int LIBRARY_PACKS = 2;
@@ -48,6 +50,32 @@ struct vpk_dir_h
 	vpk_dir_h(string path);
 };
 
+struct vpk_archive_h
+{
+	std::unique_ptr<IO::MemoryMappedFile> m_pMappedChunk{}; // Mapped archive chunk, only set when mapping is enabled.
+	std::unique_ptr<IO::RandomAccessFile> m_pChunk      {}; // Archive chunk for positional reads when it isn't mapped.
+};
+
+struct vpk_archive_table_h
+{
+	std::vector<vpk_archive_h> m_vArchives{}; // Every archive chunk of the vpk, opened once and shared between threads.
+
+	vpk_archive_table_h(const vpk_dir_h& vpk, bool bMapArchives);
+	bool IsOpen(uint16_t iArchiveIndex) const;
+	const uint8_t* Read(uint16_t iArchiveIndex, uint64_t nOffset, uint64_t nSize, std::vector<uint8_t>& vBuffer) const;
+};
+
+struct vpk_unpack_ctx_h
+{
+	lzham_decompress_params    m_lzDecompParams  {}; // LZham decompression parameters.
+	lzham_decompress_state_ptr m_pLzDecompState  {}; // Decompressor state, reinitialized for every entry.
+	std::vector<uint8_t>       m_vCompressedBuf  {}; // Compressed entry data, grows to the largest entry seen.
+	std::vector<uint8_t>       m_vDecompressedBuf{}; // Decompressed entry data, grows to the largest entry seen.
+
+	vpk_unpack_ctx_h(const lzham_decompress_params* pParams);
+	~vpk_unpack_ctx_h();
+};
+
 class CPackedStore
 {
 	std::vector<uint8_t>         m_vHashBuffer      {}; // Buffer for post decomp file validation.
@@ -58,15 +86,18 @@ class CPackedStore
 	lzham_uint32                 m_nCrc32           {}; // Pre/post operation Crc32 file checksum.
 	lzham_decompress_params      m_lzDecompParams   {}; // LZham decompression parameters.
 	lzham_decompress_status_t    m_lzDecompStatus   {}; // LZham decompression results.
+	bool                         m_bMapArchives = true; // Map archive chunks instead of reading entries from them.
 
 public:
 	void InitLzParams();
+	void SetMapArchives(bool bMapArchives);
 	vpk_dir_h GetPackDirFile(string svPackDirFile);
 	std::string GetPackChunkFile(std::string svPackDirFile, int iArchiveIndex);
 	std::vector<vpk_entry_block> GetEntryBlocks(IO::BinaryReader* reader);
 	std::string FormatBlockPath(std::string svName, std::string svPath, std::string svExtension);
 	std::string StripLocalePrefix(std::string svPackDirFile);
 	void UnpackAll(vpk_dir_h vpk, std::string svPathOut = "");
+	void UnpackBlock(const vpk_archive_table_h& archives, const vpk_entry_block& block, const std::string& svPathOut, vpk_unpack_ctx_h& ctx);
 	void ValidateAdler32PostDecomp(std::string svDirAsset);
 	void ValidateCRC32PostDecomp(std::string svDirAsset);
 };
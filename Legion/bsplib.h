@@ -14,6 +14,7 @@
 #include "Exporter.h"
 #include "RpakLib.h"
 #include "Path.h"
+#include "WorkStealingScheduler.h"
 
 
 enum class ApexRBspLumps
@@ -375,9 +376,19 @@ void ExportBsp(const std::unique_ptr<RpakLib>& RpakFileSystem, const string& Ass
 // Initializes a model exporter
 void InitializeBSPModelExporter(ModelExportFormat_t Format = ModelExportFormat_t::SEModel);
 
+// World meshes are built in batches of this many, each batch reuses one builder and frees it when done
+constexpr uint32_t BspMeshesPerTask = 32;
+
 // Exports an on-disk bsp asset, returning list of prop model names
 List<string> ExportPropContainer(std::unique_ptr<IO::MemoryStream>& Stream, const string& Name, const string& Path);
 
+// Extracts each of the materials that's loaded in an rpak as a sub-task of the group, every material is only extracted once
+void ExtractBspMaterials(Threading::TaskGroup& Group, const std::unique_ptr<RpakLib>& RpakFileSystem, const List<string>& MaterialNames, List<RMdlMaterial>& Materials, List<uint8_t>& Extracted, const string& TexturePath);
+// Adds a mesh's material to the model, using the extracted material when there is one
+uint32_t AddBspMaterial(Assets::Model& Model, const string& MaterialName, const RMdlMaterial* ParsedMaterial);
+// Schedules exporting each of the prop models that's loaded in an rpak
+void ScheduleBspPropExports(Threading::WorkStealingScheduler& Scheduler, const std::unique_ptr<RpakLib>& RpakFileSystem, const List<string>& PropNames, const string& ModelPath);
+
 template<typename T>
 static void ReadExternalLumpFile(const string& BasePath, uint32_t Lump, uint32_t DataSize, List<T>& Data)
 {
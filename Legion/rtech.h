@@ -280,11 +280,21 @@ class RTech
 public:
 	static uint64_t __fastcall DecompressPakfileInit(rpak_decomp_state* state, uint8_t* file_buffer, int64_t file_size, int64_t off_no_header, int64_t header_size);
 	static uint8_t __fastcall DecompressPakFile(rpak_decomp_state* state, uint64_t file_size, uint64_t buffer_size);
+	static uint8_t __fastcall DecompressPakFileReference(rpak_decomp_state* state, uint64_t file_size, uint64_t buffer_size);
 	static int64_t DecompressSnowflakeInit(int64_t param_buf, int64_t data_buf, uint64_t data_size);
 	static bool DecompressSnowflake(int64_t param_buffer, uint64_t data_size, uint64_t buffer_size);
 	static float* __fastcall ExtractAnimValue(int frame_count, uint8_t* in_translation_buffer, float translation_scale, float* out_translation_buffer, float* time_scale/*'time_scale' might nit be correct*/);
+	// Gets the run that follows this one in an anim value track
+	static uint8_t* NextAnimValueRun(uint8_t* run);
+	// Extracts a run of consecutive frames from an anim value track, raw runs are converted 8 frames at a time with avx2
+	static void ExtractAnimValues(int first_frame, uint32_t frame_count, uint8_t* in_translation_buffer, float translation_scale, float* out_translation_buffer, float* time_scale);
 	static void __fastcall AngleQuaternion(const Vector3& angles, Quaternion& outQuat);
+	static Quaternion UnpackQuat64(uint64_t packed_quat);
+	// Unpacks a batch of quaternions, 4 at a time with avx2
+	static void UnpackQuat64Batch(const uint64_t* packed_quats, Quaternion* out_quats, uint32_t count);
 	static std::unique_ptr<IO::MemoryStream> DecompressStreamedBuffer(const uint8_t* Data, uint64_t& DataSize, uint8_t Format, bool OodleReturnDataOnError = true, uint64_t OodleOutBufOffset = 0);
+	// Decodes an oodle buffer straight into the callers output, returns false if the data isn't compressed
+	static bool DecompressOodleBuffer(const uint8_t* Data, uint64_t DataSize, uint8_t* Output, uint64_t OutputSize);
 
 	static uint64_t __fastcall StringToGuid(const char* asset_name);
 	static float __fastcall FrameToEulerTranslation(uint8_t* translation_buffer, int frame_count, float translation_scale);
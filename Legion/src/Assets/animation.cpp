@@ -2,8 +2,10 @@
 #include "RpakLib.h"
 #include "Path.h"
 #include "Directory.h"
+#include "WorkStealingScheduler.h"
 #include <rtech.h>
 #include <animtypes.h>
+#include "RpakAnimDecoder.h"
 
 void RpakLib::BuildAnimInfo(const RpakLoadAsset& Asset, ApexAsset& Info)
 {
@@ -426,7 +428,7 @@ void RpakLib::ExportAnimationSeq(const RpakLoadAsset& Asset, const string& Path)
 	uint64_t ActualOptStarpakOffset = Asset.OptimalStarpakOffset & 0xFFFFFFFFFFFFFF00;
 
 	uint64_t starpakDataOffset = 0;
-	std::unique_ptr<IO::FileStream> StarpakStream = nullptr;
+	std::unique_ptr<IO::Stream> StarpakStream = nullptr;
 
 	if (Asset.OptimalStarpakOffset != -1)
 	{
@@ -611,174 +613,117 @@ void RpakLib::ExtractAnimation(const RpakLoadAsset& Asset, const List<Assets::Bo
 	uint64_t ActualOptStarpakOffset = Asset.OptimalStarpakOffset & 0xFFFFFFFFFFFFFF00;
 
 	uint64_t starpakDataOffset = 0;
-	std::unique_ptr<IO::FileStream> StarpakStream = nullptr;
 
 	if (Asset.OptimalStarpakOffset != -1)
-	{
 		starpakDataOffset = ActualOptStarpakOffset;
-		StarpakStream = this->GetStarpakStream(Asset, true);
-	}
 	else if (Asset.StarpakOffset != -1)
-	{
 		starpakDataOffset = ActualStarpakOffset;
-		StarpakStream = this->GetStarpakStream(Asset, false);
-	}
 
-	IO::BinaryReader StarpakReader = IO::BinaryReader(StarpakStream.get(), true);
+	// Every blend is decoded as a separate task, with it's own streams
+	Threading::TaskGroup BlendTasks;
 
 	for (uint32_t i = 0; i < seqdesc.numblends; i++)
 	{
-		RpakStream->SetPosition(seqOffset + seqdesc.animindexindex + ((uint64_t)i * sizeof(uint32_t)));
+		Threading::WorkStealingScheduler::Spawn(BlendTasks, [this, &Asset, &Skeleton, &Path, &animName, &seqdesc, seqOffset, starpakDataOffset, i]
+		{
+			auto RpakStream = this->GetFileStream(Asset);
+			IO::BinaryReader Reader = IO::BinaryReader(RpakStream.get(), true);
 
-		int animindex = Reader.Read<int>();
+			std::unique_ptr<IO::Stream> StarpakStream = nullptr;
 
-		RpakStream->SetPosition(seqOffset + animindex);
+			if (Asset.OptimalStarpakOffset != -1)
+				StarpakStream = this->GetStarpakStream(Asset, true);
+			else if (Asset.StarpakOffset != -1)
+				StarpakStream = this->GetStarpakStream(Asset, false);
 
-		mstudioanimdescv54_t animdesc = Reader.Read<mstudioanimdescv54_t>();
+			RpakStream->SetPosition(seqOffset + seqdesc.animindexindex + ((uint64_t)i * sizeof(uint32_t)));
 
-		// unsure what this flag is
-		if (!(animdesc.flags & 0x20000))
-			continue;
+			int animindex = Reader.Read<int>();
 
-		std::unique_ptr<Assets::Animation> Anim = std::make_unique<Assets::Animation>(Skeleton.Count());
+			RpakStream->SetPosition(seqOffset + animindex);
 
-		Assets::AnimationCurveMode AnimCurveType = Assets::AnimationCurveMode::Absolute;
+			mstudioanimdescv54_t animdesc = Reader.Read<mstudioanimdescv54_t>();
 
-		// anim is delta
-		if (animdesc.flags & STUDIO_DELTA)
-			AnimCurveType = Assets::AnimationCurveMode::Additive;
+			// unsure what this flag is
+			if (!(animdesc.flags & 0x20000))
+				return;
 
-		for (auto& Bone : Skeleton)
-		{
-			Anim->Bones.EmplaceBack(Bone.Name(), Bone.Parent(), Bone.LocalPosition(), Bone.LocalRotation());
-
-			List<Assets::Curve>& CurveNodes = Anim->GetNodeCurves(Bone.Name());
-
-			// Inject curve nodes here, we can use the purge empty later to remove them
-			CurveNodes.EmplaceBack(Bone.Name(), Assets::CurveProperty::RotateQuaternion, AnimCurveType);
-			CurveNodes.EmplaceBack(Bone.Name(), Assets::CurveProperty::TranslateX, AnimCurveType);
-			CurveNodes.EmplaceBack(Bone.Name(), Assets::CurveProperty::TranslateY, AnimCurveType);
-			CurveNodes.EmplaceBack(Bone.Name(), Assets::CurveProperty::TranslateZ, AnimCurveType);
-			CurveNodes.EmplaceBack(Bone.Name(), Assets::CurveProperty::ScaleX, AnimCurveType);
-			CurveNodes.EmplaceBack(Bone.Name(), Assets::CurveProperty::ScaleY, AnimCurveType);
-			CurveNodes.EmplaceBack(Bone.Name(), Assets::CurveProperty::ScaleZ, AnimCurveType);
-		}
+			std::unique_ptr<Assets::Animation> Anim = std::make_unique<Assets::Animation>(Skeleton.Count());
 
-		const uint64_t AnimHeaderPointer = seqOffset + animindex;
+			Assets::AnimationCurveMode AnimCurveType = Assets::AnimationCurveMode::Absolute;
 
-		for (uint32_t Frame = 0; Frame < animdesc.numframes; Frame++)
-		{
-			uint32_t ChunkTableIndex = 0;
-			uint32_t ChunkFrame = Frame;
-			uint32_t FrameCountOneLess = 0;
-			uint32_t FirstChunk = animdesc.animindex;
-			uint64_t ChunkDataOffset = 0;
-			uint32_t IsExternal = 0;
-			uint64_t ResultDataPtr = 0;
-
-			if (!animdesc.mediancount)
+			// anim is delta
+			if (animdesc.flags & STUDIO_DELTA)
+				AnimCurveType = Assets::AnimationCurveMode::Additive;
+
+			for (auto& Bone : Skeleton)
 			{
-				// Nothing here
-				goto nomedian;
-			}
-			else if (ChunkFrame >= animdesc.sectionframes)
-			{
-				uint32_t FrameCount = animdesc.numframes;
-				uint32_t ChunkFrameMinusSplitCount = ChunkFrame - animdesc.sectionframes;
-				if (FrameCount <= animdesc.sectionframes || ChunkFrame != FrameCount - 1)
-				{
-					ChunkTableIndex = ChunkFrameMinusSplitCount / animdesc.mediancount + 1;
-					ChunkFrame = ChunkFrame - (animdesc.mediancount * (ChunkFrameMinusSplitCount / animdesc.mediancount)) - animdesc.sectionframes;
-				}
-				else
-				{
-					ChunkFrame = 0;
-					ChunkTableIndex = (FrameCount - animdesc.sectionframes - 1) / animdesc.mediancount + 2;
-				}
+				Anim->Bones.EmplaceBack(Bone.Name(), Bone.Parent(), Bone.LocalPosition(), Bone.LocalRotation());
 			}
 
-			ChunkDataOffset = animdesc.sectionindex + 8 * (uint64_t)ChunkTableIndex;
+			// Keys are written straight into the tracks, curves are only built when the exporter reads them
+			Anim->Tracks.Initialize(Skeleton.Count(), animdesc.numframes, AnimCurveType);
+
+			const uint64_t AnimHeaderPointer = seqOffset + animindex;
+
+			RpakAnimDecoder Decoder(*Anim, Skeleton.Count(), AnimCurveType == Assets::AnimationCurveMode::Additive);
+			RpakAnimLayout Layout{ (uint32_t)animdesc.numframes, (uint32_t)animdesc.sectionframes, (uint32_t)animdesc.mediancount };
 
-			RpakStream->SetPosition(AnimHeaderPointer + ChunkDataOffset);
-			FirstChunk = Reader.Read<uint32_t>();
-			IsExternal = Reader.Read<uint32_t>();
+#ifdef LEGION_ANIM_CAPTURE
+			if (!string::IsNullOrEmpty(this->AnimCapturePath))
+				Decoder.BeginCapture(IO::Path::Combine(this->AnimCapturePath, animName + string::Format("_%d.animcap", i)), Layout);
+#endif
 
-			if (IsExternal)
+			// Each section is resolved once, then all of it's frames are decoded from the resident tracks
+			for (auto& Section : RpakAnimDecoder::BuildSections(Layout))
 			{
-				uint64_t v13 = animdesc.somedataoffset;
-				if (v13)
+				uint32_t FirstChunk = animdesc.animindex;
+				uint32_t IsExternal = 0;
+				uint64_t ResultDataPtr = 0;
+
+				if (Layout.SectionFrames)
+				{
+					RpakStream->SetPosition(AnimHeaderPointer + animdesc.sectionindex + 8 * (uint64_t)Section.Index);
+					FirstChunk = Reader.Read<uint32_t>();
+					IsExternal = Reader.Read<uint32_t>();
+				}
+
+				if (IsExternal)
 				{
-					ResultDataPtr = v13 + FirstChunk;
+					if (animdesc.somedataoffset)
+						ResultDataPtr = animdesc.somedataoffset + FirstChunk;
+					else
+						ResultDataPtr = starpakDataOffset + FirstChunk;
+
+					StarpakStream->SetPosition(ResultDataPtr);
+					Decoder.ReadSection(StarpakStream.get());
 				}
 				else
 				{
-					ResultDataPtr = starpakDataOffset + FirstChunk;
+					// Track data in the rpak is parsed in place
+					ResultDataPtr = AnimHeaderPointer + FirstChunk;
+					Decoder.ResolveSection(RpakStream->Borrow(ResultDataPtr, 0), RpakStream->GetLength() - ResultDataPtr);
 				}
-			}
-			else
-			{
-			nomedian:
-				ResultDataPtr = AnimHeaderPointer + FirstChunk;
+
+				Decoder.DecodeSection(Section);
 			}
 
-			char boneFlagData[256]{};
+			string DestinationPath = IO::Path::Combine(Path, animName + string::Format("_%d", i) + (const char*)this->AnimExporter->AnimationExtension());
 
-			if (IsExternal)
-			{
-				StarpakStream->SetPosition(ResultDataPtr);
-				StarpakStream->Read((uint8_t*)boneFlagData, 0, ((4 * (uint64_t)Skeleton.Count() + 7) / 8 + 1) & 0xFFFFFFFFFFFFFFFE);
-			}
-			else
+			if (!Utils::ShouldWriteFile(DestinationPath))
+				return;
+
+			try
 			{
-				RpakStream->SetPosition(ResultDataPtr);
-				RpakStream->Read((uint8_t*)boneFlagData, 0, ((4 * (uint64_t)Skeleton.Count() + 7) / 8 + 1) & 0xFFFFFFFFFFFFFFFE);
+				this->AnimExporter->ExportAnimation(*Anim.get(), DestinationPath);
 			}
-
-			IO::BinaryReader* currentReader = IsExternal ? &StarpakReader : &Reader;
-
-			for (uint32_t b = 0; b < Skeleton.Count(); b++)
+			catch (...)
 			{
-				uint32_t Shift = 4 * (b % 2);
-				char boneFlags = boneFlagData[b / 2] >> Shift;
-
-				if (boneFlags & 0x7)
-				{
-					mstudio_rle_anim_t anim = currentReader->Read<mstudio_rle_anim_t>();
-
-					short sizeToRead = anim.size > 0 ? anim.size - sizeof(mstudio_rle_anim_t) : 0;
-
-					std::unique_ptr<uint8_t[]> boneTrackData = currentReader->Read(sizeToRead);
-
-					uint16_t* BoneTrackDataPtr = (uint16_t*)boneTrackData.get();
-
-					// this flag does not exist
-					anim.bAdditiveCustom = (AnimCurveType == Assets::AnimationCurveMode::Additive);
-
-					if (boneFlags & STUDIO_ANIM_BONEPOS)
-						CalcBonePosition(anim, &BoneTrackDataPtr, Anim, b, ChunkFrame, Frame);
-					if (boneFlags & STUDIO_ANIM_BONEROT)
-						CalcBoneQuaternion(anim, &BoneTrackDataPtr, Anim, b, ChunkFrame, Frame);
-					if (boneFlags & STUDIO_ANIM_BONESCALE)
-						CalcBoneScale(anim, &BoneTrackDataPtr, Anim, b, ChunkFrame, Frame);
-				}
 			}
-		}
-
-		Anim->RemoveEmptyNodes();
-
-		string DestinationPath = IO::Path::Combine(Path, animName + string::Format("_%d", i) + (const char*)this->AnimExporter->AnimationExtension());
-
-		if (!Utils::ShouldWriteFile(DestinationPath))
-			continue;
-
-		try
-		{
-			this->AnimExporter->ExportAnimation(*Anim.get(), DestinationPath);
-		}
-		catch (...)
-		{
-		}
+		});
 	}
+
+	Threading::WorkStealingScheduler::Wait(BlendTasks);
 }
 
 void RpakLib::ExtractAnimation_V11(const RpakLoadAsset& Asset, const List<Assets::Bone>& Skeleton, const string& Path)
@@ -804,169 +749,113 @@ void RpakLib::ExtractAnimation_V11(const RpakLoadAsset& Asset, const List<Assets
 	uint64_t ActualOptStarpakOffset = Asset.OptimalStarpakOffset & 0xFFFFFFFFFFFFFF00;
 
 	uint64_t starpakDataOffset = 0;
-	std::unique_ptr<IO::FileStream> StarpakStream = nullptr;
 
 	if (Asset.OptimalStarpakOffset != -1)
-	{
 		starpakDataOffset = ActualOptStarpakOffset;
-		StarpakStream = this->GetStarpakStream(Asset, true);
-	}
 	else if (Asset.StarpakOffset != -1)
-	{
 		starpakDataOffset = ActualStarpakOffset;
-		StarpakStream = this->GetStarpakStream(Asset, false);
-	}
 
-	IO::BinaryReader StarpakReader = IO::BinaryReader(StarpakStream.get(), true);
+	// Every blend is decoded as a separate task, with it's own streams
+	Threading::TaskGroup BlendTasks;
 
 	for (uint32_t i = 0; i < seqdesc.numblends; i++)
 	{
-		// sizeof(VAR) needs to match animindex!!!!!!
-		RpakStream->SetPosition(seqOffset + seqdesc.animindexindex + ((uint64_t)i * sizeof(short)));
-
-		uint16 animindex = Reader.Read<uint16>();
-
-		RpakStream->SetPosition(seqOffset + animindex);
-
-		mstudioanimdesc_t_v16 animdesc = Reader.Read<mstudioanimdesc_t_v16>(); // lower case because normal source is like this :)
+		Threading::WorkStealingScheduler::Spawn(BlendTasks, [this, &Asset, &Skeleton, &Path, &animName, &seqdesc, seqOffset, starpakDataOffset, i]
+		{
+			auto RpakStream = this->GetFileStream(Asset);
+			IO::BinaryReader Reader = IO::BinaryReader(RpakStream.get(), true);
 
-		// unsure what this flag is
-		if (!(animdesc.flags & 0x20000))
-			continue;
+			std::unique_ptr<IO::Stream> StarpakStream = nullptr;
 
-		std::unique_ptr<Assets::Animation> Anim = std::make_unique<Assets::Animation>(Skeleton.Count());
+			if (Asset.OptimalStarpakOffset != -1)
+				StarpakStream = this->GetStarpakStream(Asset, true);
+			else if (Asset.StarpakOffset != -1)
+				StarpakStream = this->GetStarpakStream(Asset, false);
 
-		Assets::AnimationCurveMode AnimCurveType = Assets::AnimationCurveMode::Absolute;
+			// sizeof(VAR) needs to match animindex!!!!!!
+			RpakStream->SetPosition(seqOffset + seqdesc.animindexindex + ((uint64_t)i * sizeof(short)));
 
-		// anim is delta
-		if (animdesc.flags & STUDIO_DELTA)
-			AnimCurveType = Assets::AnimationCurveMode::Additive;
+			uint16 animindex = Reader.Read<uint16>();
 
-		for (auto& Bone : Skeleton)
-		{
-			Anim->Bones.EmplaceBack(Bone.Name(), Bone.Parent(), Bone.LocalPosition(), Bone.LocalRotation());
-
-			List<Assets::Curve>& CurveNodes = Anim->GetNodeCurves(Bone.Name());
-
-			// Inject curve nodes here, we can use the purge empty later to remove them
-			CurveNodes.EmplaceBack(Bone.Name(), Assets::CurveProperty::RotateQuaternion, AnimCurveType);
-			CurveNodes.EmplaceBack(Bone.Name(), Assets::CurveProperty::TranslateX, AnimCurveType);
-			CurveNodes.EmplaceBack(Bone.Name(), Assets::CurveProperty::TranslateY, AnimCurveType);
-			CurveNodes.EmplaceBack(Bone.Name(), Assets::CurveProperty::TranslateZ, AnimCurveType);
-			CurveNodes.EmplaceBack(Bone.Name(), Assets::CurveProperty::ScaleX, AnimCurveType);
-			CurveNodes.EmplaceBack(Bone.Name(), Assets::CurveProperty::ScaleY, AnimCurveType);
-			CurveNodes.EmplaceBack(Bone.Name(), Assets::CurveProperty::ScaleZ, AnimCurveType);
-		}
+			RpakStream->SetPosition(seqOffset + animindex);
 
-		const uint64_t animDescPtr = seqOffset + animindex;
+			mstudioanimdesc_t_v16 animdesc = Reader.Read<mstudioanimdesc_t_v16>(); // lower case because normal source is like this :)
 
-		for (uint32_t frameIdx = 0; frameIdx < animdesc.numframes; frameIdx++)
-		{
-			int sectionIdx = 0; // the index of the section we are in
-			short sectionFrameIdx = frameIdx; // frame index for sections
-			int sectionOffset = 0; // offset into current section
-			uint64_t ResultDataPtr = 0; // ptr to the data
-			int AnimIndex = animdesc.animindex; // offset to animation or first section if section animation
-			bool IsExternal = false; // if this is a section, is the section outside of the actual sequence
-
-			if (!animdesc.sectionframes)
-			{
-				// Nothing here
-				goto nomedian;
-			}
-			else if (sectionFrameIdx >= animdesc.unk2)
-			{
-				uint32_t sectionFrameMinusSplitCount = sectionFrameIdx - animdesc.unk2; // I don't really know what unk2 is for but porter uses it so *shrug*
-				if (animdesc.numframes <= animdesc.unk2 || sectionFrameIdx != animdesc.numframes - 1)
-				{
-					sectionIdx = sectionFrameMinusSplitCount / animdesc.sectionframes + 1;
-					sectionFrameIdx = sectionFrameIdx - (animdesc.sectionframes * (sectionFrameMinusSplitCount / animdesc.sectionframes)) - animdesc.unk2;
-				}
-				else
-				{
-					sectionFrameIdx = 0;
-					sectionIdx = (animdesc.numframes - animdesc.unk2 - 1) / animdesc.sectionframes + 2;
-				}
-			}
+			// unsure what this flag is
+			if (!(animdesc.flags & 0x20000))
+				return;
 
-			// Make sure sizeof(VAR) is right datatype!!!
-			sectionOffset = animdesc.sectionindex + sizeof(int) * sectionIdx;
+			std::unique_ptr<Assets::Animation> Anim = std::make_unique<Assets::Animation>(Skeleton.Count());
 
-			RpakStream->SetPosition(animDescPtr + sectionOffset);
-			AnimIndex = Reader.Read<int>();
+			Assets::AnimationCurveMode AnimCurveType = Assets::AnimationCurveMode::Absolute;
 
-			if (AnimIndex < 0 && StarpakStream)
-			{
-				AnimIndex = abs(AnimIndex) - 1;
+			// anim is delta
+			if (animdesc.flags & STUDIO_DELTA)
+				AnimCurveType = Assets::AnimationCurveMode::Additive;
 
-				ResultDataPtr = starpakDataOffset + AnimIndex;
-				IsExternal = true;
-			}
-			else
+			for (auto& Bone : Skeleton)
 			{
-			nomedian:
-				IsExternal = false;
-				ResultDataPtr = animDescPtr + AnimIndex;
+				Anim->Bones.EmplaceBack(Bone.Name(), Bone.Parent(), Bone.LocalPosition(), Bone.LocalRotation());
 			}
 
-			// I have a really bad feeling we will see > 256 bones sooner than later
-			char boneFlagData[256]{};
+			// Keys are written straight into the tracks, curves are only built when the exporter reads them
+			Anim->Tracks.Initialize(Skeleton.Count(), animdesc.numframes, AnimCurveType);
 
-			if (IsExternal)
-			{
-				StarpakStream->SetPosition(ResultDataPtr);
-				StarpakStream->Read((uint8_t*)boneFlagData, 0, ((4 * (uint64_t)Skeleton.Count() + 7) / 8 + 1) & 0xFFFFFFFFFFFFFFFE);
-			}
-			else
-			{
-				RpakStream->SetPosition(ResultDataPtr);
-				RpakStream->Read((uint8_t*)boneFlagData, 0, ((4 * (uint64_t)Skeleton.Count() + 7) / 8 + 1) & 0xFFFFFFFFFFFFFFFE);
-			}
+			const uint64_t animDescPtr = seqOffset + animindex;
+
+			RpakAnimDecoder Decoder(*Anim, Skeleton.Count(), AnimCurveType == Assets::AnimationCurveMode::Additive);
+			RpakAnimLayout Layout{ (uint32_t)animdesc.numframes, (uint32_t)animdesc.unk2, (uint32_t)animdesc.sectionframes };
 
-			IO::BinaryReader* currentReader = IsExternal ? &StarpakReader : &Reader;
+#ifdef LEGION_ANIM_CAPTURE
+			if (!string::IsNullOrEmpty(this->AnimCapturePath))
+				Decoder.BeginCapture(IO::Path::Combine(this->AnimCapturePath, animName + string::Format("_%d.animcap", i)), Layout);
+#endif
 
-			for (uint32_t b = 0; b < Skeleton.Count(); b++)
+			// Each section is resolved once, then all of it's frames are decoded from the resident tracks
+			for (auto& Section : RpakAnimDecoder::BuildSections(Layout))
 			{
-				uint32_t Shift = 4 * (b % 2);
-				char BoneTrackFlags = boneFlagData[b / 2] >> Shift;
+				int AnimIndex = animdesc.animindex; // offset to animation or first section if section animation
+				uint64_t ResultDataPtr = 0; // ptr to the data
 
-				if (BoneTrackFlags & (STUDIO_ANIM_BONEPOS | STUDIO_ANIM_BONEROT | STUDIO_ANIM_BONESCALE))
+				if (Layout.SectionFrames)
 				{
+					// Make sure sizeof(VAR) is right datatype!!!
+					RpakStream->SetPosition(animDescPtr + animdesc.sectionindex + sizeof(int) * (uint64_t)Section.Index);
+					AnimIndex = Reader.Read<int>();
+				}
 
-					mstudio_rle_anim_t anim = currentReader->Read<mstudio_rle_anim_t>();
-
-					short sizeToRead = anim.size > 0 ? anim.size - sizeof(mstudio_rle_anim_t) : 0;
-
-					std::unique_ptr<uint8_t[]> boneTrackData = currentReader->Read(sizeToRead);
-
-					uint16_t* BoneTrackDataPtr = (uint16_t*)boneTrackData.get();
-
-					// Set this so when we do translations we will know whether or not to add the rest position onto it...
-					anim.bAdditiveCustom = (AnimCurveType == Assets::AnimationCurveMode::Additive);
+				// the section is outside of the actual sequence
+				if (Layout.SectionFrames && AnimIndex < 0 && StarpakStream)
+				{
+					ResultDataPtr = starpakDataOffset + (abs(AnimIndex) - 1);
 
-					if (BoneTrackFlags & STUDIO_ANIM_BONEPOS)
-						CalcBonePosition(anim, &BoneTrackDataPtr, Anim, b, sectionFrameIdx, frameIdx);
-					if (BoneTrackFlags & STUDIO_ANIM_BONEROT)
-						CalcBoneQuaternion(anim, &BoneTrackDataPtr, Anim, b, sectionFrameIdx, frameIdx);
-					if (BoneTrackFlags & STUDIO_ANIM_BONESCALE)
-						CalcBoneScale(anim, &BoneTrackDataPtr, Anim, b, sectionFrameIdx, frameIdx);
+					StarpakStream->SetPosition(ResultDataPtr);
+					Decoder.ReadSection(StarpakStream.get());
+				}
+				else
+				{
+					// Track data in the rpak is parsed in place
+					ResultDataPtr = animDescPtr + AnimIndex;
+					Decoder.ResolveSection(RpakStream->Borrow(ResultDataPtr, 0), RpakStream->GetLength() - ResultDataPtr);
 				}
-			}
-		}
 
-		Anim->RemoveEmptyNodes();
+				Decoder.DecodeSection(Section);
+			}
 
-		string DestinationPath = IO::Path::Combine(Path, animName + string::Format("_%d", i) + (const char*)this->AnimExporter->AnimationExtension());
+			string DestinationPath = IO::Path::Combine(Path, animName + string::Format("_%d", i) + (const char*)this->AnimExporter->AnimationExtension());
 
-		if (!Utils::ShouldWriteFile(DestinationPath))
-			continue;
+			if (!Utils::ShouldWriteFile(DestinationPath))
+				return;
 
-		try
-		{
-			this->AnimExporter->ExportAnimation(*Anim.get(), DestinationPath);
-		}
-		catch (...)
-		{
-		}
+			try
+			{
+				this->AnimExporter->ExportAnimation(*Anim.get(), DestinationPath);
+			}
+			catch (...)
+			{
+			}
+		});
 	}
+
+	Threading::WorkStealingScheduler::Wait(BlendTasks);
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "RpakLib.h"
 #include "Path.h"
 #include "Directory.h"
+#include "WorkStealingScheduler.h"
 
 #include <typeinfo>
 #include <typeindex>
@@ -23,15 +24,20 @@ const char* s_MaterialTypes[] = {
 	"RGBS",
 };
 
-void RpakLib::BuildMaterialInfo(const RpakLoadAsset& Asset, ApexAsset& Info)
+string RpakLib::ReadMaterialName(const RpakLoadAsset& Asset)
+{
+	MaterialHeader hdr;
+
+	return this->ReadMaterialName(Asset, hdr);
+}
+
+string RpakLib::ReadMaterialName(const RpakLoadAsset& Asset, MaterialHeader& hdr)
 {
 	auto RpakStream = this->GetFileStream(Asset);
 	IO::BinaryReader Reader = IO::BinaryReader(RpakStream.get(), true);
 
 	RpakStream->SetPosition(this->GetFileOffset(Asset, Asset.SubHeaderIndex, Asset.SubHeaderOffset));
 
-	MaterialHeader hdr;
-	
 	if (Asset.Version == RpakGameVersion::Apex)
 	{
 		if (Asset.AssetVersion >= 16)
@@ -40,9 +46,6 @@ void RpakLib::BuildMaterialInfo(const RpakLoadAsset& Asset, ApexAsset& Info)
 			hdr.FromV16(hdr_v16);
 		}
 		else hdr = Reader.Read<MaterialHeader>();
-
-		Info.DebugInfo = string::Format("type: %s", s_MaterialTypes[hdr.materialType]);
-
 	}
 	else
 	{
@@ -52,7 +55,16 @@ void RpakLib::BuildMaterialInfo(const RpakLoadAsset& Asset, ApexAsset& Info)
 
 	RpakStream->SetPosition(this->GetFileOffset(Asset, hdr.pName.Index, hdr.pName.Offset));
 
-	string MaterialName = Reader.ReadCString();
+	return Reader.ReadCString();
+}
+
+void RpakLib::BuildMaterialInfo(const RpakLoadAsset& Asset, ApexAsset& Info)
+{
+	MaterialHeader hdr;
+	string MaterialName = this->ReadMaterialName(Asset, hdr);
+
+	if (Asset.Version == RpakGameVersion::Apex)
+		Info.DebugInfo = string::Format("type: %s", s_MaterialTypes[hdr.materialType]);
 
 	uint32_t textureSlotCount = (hdr.streamingTextureHandles.Offset - hdr.textureHandles.Offset) / 8;
 	if (ExportManager::Config.GetBool("UseFullPaths"))
@@ -255,7 +267,70 @@ void RpakLib::ExportMaterial(const RpakLoadAsset& Asset, const string& Path)
 
 RMdlMaterial RpakLib::ExtractMaterial(const RpakLoadAsset& Asset, const string& Path, bool IncludeImages, bool IncludeImageNames)
 {
-	RMdlMaterial Result;
+	string CacheKey = string::Format("0x%llx%s", Asset.NameHash, (const char*)ImageExtension);
+
+	std::promise<RpakExportedMaterial> Parsed;
+	std::shared_future<RpakExportedMaterial> Material;
+	bool IsFirstExport = false;
+
+	{
+		std::lock_guard<std::mutex> CacheLock(this->ExportCacheLock);
+
+		if (!this->ExportedMaterials.TryGetValue(CacheKey, Material))
+		{
+			Material = Parsed.get_future().share();
+			this->ExportedMaterials.Add(CacheKey, Material);
+			IsFirstExport = true;
+		}
+	}
+
+	// The first export of a material parses it, every other export waits for that result
+	if (IsFirstExport)
+	{
+		try
+		{
+			Parsed.set_value(this->ParseMaterial(Asset));
+		}
+		catch (...)
+		{
+			Parsed.set_exception(std::current_exception());
+		}
+	}
+
+	const RpakExportedMaterial& Result = Material.get();
+
+	if (IncludeImages)
+	{
+		// Images are exported as sub-tasks, ExportTexture only decodes each of them once
+		Threading::TaskGroup TextureTasks;
+
+		for (auto& Image : Result.Images)
+		{
+			if (!Assets.ContainsKey(Image.Hash))
+				continue;
+
+			RpakLoadAsset& ImageAsset = Assets[Image.Hash];
+
+			// Make sure the data we got to is a proper texture
+			if (ImageAsset.AssetType != (uint32_t)AssetType_t::Texture)
+				continue;
+
+			Threading::WorkStealingScheduler::Spawn(TextureTasks, [this, &ImageAsset, &Path, &Image, IncludeImageNames]
+			{
+				ExportTexture(ImageAsset, Path, IncludeImageNames, Image.NameOverride, Image.NormalRecalculate);
+			});
+		}
+
+		Threading::WorkStealingScheduler::Wait(TextureTasks);
+	}
+
+	return Result.Material;
+}
+
+RpakExportedMaterial RpakLib::ParseMaterial(const RpakLoadAsset& Asset)
+{
+	RpakExportedMaterial Parsed;
+	RMdlMaterial& Result = Parsed.Material;
 
 	auto RpakStream = this->GetFileStream(Asset);
 	IO::BinaryReader Reader = IO::BinaryReader(RpakStream.get(), true);
@@ -421,21 +496,14 @@ RMdlMaterial RpakLib::ExtractMaterial(const RpakLoadAsset& Asset, const string&
 				g_Logger.Info(">> %i: empty\n", i);
 		}
 
-		// Extract to disk if need be
-		if (IncludeImages && Assets.ContainsKey(TextureHash))
-		{
-			RpakLoadAsset& Asset = Assets[TextureHash];
-			// Make sure the data we got to is a proper texture
-			if (Asset.AssetType == (uint32_t)AssetType_t::Texture)
-			{
-				ExportTexture(Asset, Path, IncludeImageNames, bOverridden ? TextureName : string(), bNormalRecalculate);
-			}
-		}
+		// Remember the slot so it can be extracted to disk if need be
+		if (TextureHash != 0)
+			Parsed.Images.EmplaceBack(RpakMaterialImage{ TextureHash, bOverridden ? TextureName : string(), bNormalRecalculate });
 	}
 
 	g_Logger.Info("\n");
 
-	return Result;
+	return Parsed;
 }
 
 std::unique_ptr<Assets::Texture> RpakLib::BuildPreviewMaterial(uint64_t Hash)
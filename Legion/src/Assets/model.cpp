@@ -2,19 +2,34 @@
 #include "RpakLib.h"
 #include "Path.h"
 #include "Directory.h"
+#include "WorkStealingScheduler.h"
 #include <rtech.h>
 
-void RpakLib::BuildModelInfo(const RpakLoadAsset& Asset, ApexAsset& Info)
+string RpakLib::ReadModelName(const RpakLoadAsset& Asset)
+{
+	ModelHeader mdlHdr;
+
+	return this->ReadModelName(Asset, mdlHdr);
+}
+
+string RpakLib::ReadModelName(const RpakLoadAsset& Asset, ModelHeader& Header)
 {
 	auto RpakStream = this->GetFileStream(Asset);
-	IO::BinaryReader Reader = IO::BinaryReader(RpakStream.get(), true);
 
 	RpakStream->SetPosition(this->GetFileOffset(Asset, Asset.SubHeaderIndex, Asset.SubHeaderOffset));
 
+	Header.ReadFromAssetStream(&RpakStream, Asset.SubHeaderSize, Asset.AssetVersion);
+
+	return this->ReadStringFromPointer(Asset, Header.pName);
+}
+
+void RpakLib::BuildModelInfo(const RpakLoadAsset& Asset, ApexAsset& Info)
+{
 	ModelHeader mdlHdr;
-	mdlHdr.ReadFromAssetStream(&RpakStream, Asset.SubHeaderSize, Asset.AssetVersion);
+	mdlHdr.name = this->ReadModelName(Asset, mdlHdr);
 
-	mdlHdr.name = this->ReadStringFromPointer(Asset, mdlHdr.pName);
+	auto RpakStream = this->GetFileStream(Asset);
+	IO::BinaryReader Reader = IO::BinaryReader(RpakStream.get(), true);
 
 	if (ExportManager::Config.GetBool("UseFullPaths"))
 		Info.Name = mdlHdr.name;
@@ -199,6 +214,9 @@ std::unique_ptr<Assets::Model> RpakLib::ExtractModel_V16(const RpakLoadAsset& As
 
 		RpakStream->SetPosition(this->GetFileOffset(Asset, mdlHdr.animSeqs.Index, mdlHdr.animSeqs.Offset));
 
+		// Each sequence is exported as a sub-task, they all share the skeleton
+		Threading::TaskGroup SequenceTasks;
+
 		for (uint32_t i = 0; i < mdlHdr.animSeqCount; i++)
 		{
 			uint64_t AnimHash = Reader.Read<uint64_t>();
@@ -206,12 +224,18 @@ std::unique_ptr<Assets::Model> RpakLib::ExtractModel_V16(const RpakLoadAsset& As
 			if (!Assets.ContainsKey(AnimHash))
 				continue;	// Should never happen
 
-			// We need to make sure the skeleton is kept alive (copied) here...
-			if (!bExportingRawRMdl)
-				this->ExtractAnimation_V11(Assets[AnimHash], Model->Bones, AnimationPath);
-			else
-				this->ExportAnimationSeq(Assets[AnimHash], AnimationPath);
+			Threading::WorkStealingScheduler::Spawn(SequenceTasks, [this, &Model, &AnimationPath, AnimHash, bExportingRawRMdl]
+			{
+				// We need to make sure the skeleton is kept alive (copied) here...
+				if (!bExportingRawRMdl)
+					this->ExtractAnimation_V11(Assets[AnimHash], Model->Bones, AnimationPath);
+				else
+					this->ExportAnimationSeq(Assets[AnimHash], AnimationPath);
+			});
 		}
+
+		// The skeleton must outlive every sequence
+		Threading::WorkStealingScheduler::Wait(SequenceTasks);
 	}
 
 	RpakStream->SetPosition(StudioOffset);
@@ -268,7 +292,7 @@ std::unique_ptr<Assets::Model> RpakLib::ExtractModel_V16(const RpakLoadAsset& As
 	uint64_t OptStarpakIndex = Asset.OptimalStarpakOffset & 0xFF;
 
 	uint64_t Offset = 0;
-	std::unique_ptr<IO::FileStream> StarpakStream = nullptr;
+	std::unique_ptr<IO::Stream> StarpakStream = nullptr;
 
 	if (Asset.OptimalStarpakOffset != -1)
 	{
@@ -294,9 +318,9 @@ std::unique_ptr<Assets::Model> RpakLib::ExtractModel_V16(const RpakLoadAsset& As
 	size_t lodSize = 0;
 	size_t cmpSize = 0;
 
-	size_t streamedDataSize = this->LoadedFiles[Asset.FileIndex].StarpakMap[Asset.StarpakOffset];
+	size_t streamedDataSize = this->LoadedFiles[Asset.FileIndex]->StarpakMap[Asset.StarpakOffset];
 
-	if (this->LoadedFiles[Asset.FileIndex].StarpakMap.ContainsKey(Asset.StarpakOffset))
+	if (this->LoadedFiles[Asset.FileIndex]->StarpakMap.ContainsKey(Asset.StarpakOffset))
 	{
 		IO::Stream* StarpakStream = StarpakReader.GetBaseStream();
 
@@ -327,17 +351,16 @@ std::unique_ptr<Assets::Model> RpakLib::ExtractModel_V16(const RpakLoadAsset& As
 				{
 					cmpSize = lod.vgsizedecompressed;
 
-					// DecompressStreamedBuffer deletes the buffer, no need to free it.
-					uint8_t* tmpCmpBuf = new uint8_t[cmpSize];
+					auto tmpCmpBuf = std::make_unique<uint8_t[]>(cmpSize);
 
 					StarpakStream->SetPosition(Offset + lod.vgoffset);
-					StarpakReader.Read(tmpCmpBuf, 0, lod.vgsizecompressed);
+					StarpakReader.Read(tmpCmpBuf.get(), 0, lod.vgsizecompressed);
 
-					// read into vg stream and decompress
-					vgStream = RTech::DecompressStreamedBuffer(tmpCmpBuf, cmpSize, (uint8_t)CompressionType::OODLE);
-					vgStream->Read(dcmpBuf.get(), decompOffset, cmpSize);
+					// decompress straight into the vg buffer
+					if (!RTech::DecompressOodleBuffer(tmpCmpBuf.get(), cmpSize, dcmpBuf.get() + decompOffset, cmpSize))
+						std::memcpy(dcmpBuf.get() + decompOffset, tmpCmpBuf.get(), cmpSize);
 
-					// add size for an offset so we can write from the stream into the dcmpBuf at the right pos
+					// add size for an offset so we can decode into the dcmpBuf at the right pos
 					decompOffset += lod.vgsizedecompressed;
 				}
 
@@ -602,6 +625,9 @@ std::unique_ptr<Assets::Model> RpakLib::ExtractModel(const RpakLoadAsset& Asset,
 
 		RpakStream->SetPosition(this->GetFileOffset(Asset, mdlHdr.animSeqs.Index, mdlHdr.animSeqs.Offset));
 
+		// Each sequence is exported as a sub-task, they all share the skeleton
+		Threading::TaskGroup SequenceTasks;
+
 		for (uint32_t i = 0; i < mdlHdr.animSeqCount; i++)
 		{
 			uint64_t AnimHash = Reader.Read<uint64_t>();
@@ -609,12 +635,18 @@ std::unique_ptr<Assets::Model> RpakLib::ExtractModel(const RpakLoadAsset& Asset,
 			if (!Assets.ContainsKey(AnimHash))
 				continue;	// Should never happen
 
-			// We need to make sure the skeleton is kept alive (copied) here...
-			if (!bExportingRawRMdl)
-				this->ExtractAnimation(Assets[AnimHash], Model->Bones, AnimationPath);
-			else
-				this->ExportAnimationSeq(Assets[AnimHash], AnimationPath);
+			Threading::WorkStealingScheduler::Spawn(SequenceTasks, [this, &Model, &AnimationPath, AnimHash, bExportingRawRMdl]
+			{
+				// We need to make sure the skeleton is kept alive (copied) here...
+				if (!bExportingRawRMdl)
+					this->ExtractAnimation(Assets[AnimHash], Model->Bones, AnimationPath);
+				else
+					this->ExportAnimationSeq(Assets[AnimHash], AnimationPath);
+			});
 		}
+
+		// The skeleton must outlive every sequence
+		Threading::WorkStealingScheduler::Wait(SequenceTasks);
 	}
 
 	RpakStream->SetPosition(StudioOffset);
@@ -689,7 +721,7 @@ std::unique_ptr<Assets::Model> RpakLib::ExtractModel(const RpakLoadAsset& Asset,
 	uint64_t OptStarpakIndex = Asset.OptimalStarpakOffset & 0xFF;
 
 	uint64_t Offset = 0;
-	std::unique_ptr<IO::FileStream> StarpakStream = nullptr;
+	std::unique_ptr<IO::Stream> StarpakStream = nullptr;
 
 	if (Asset.OptimalStarpakOffset != -1)
 	{
@@ -225,7 +225,7 @@ Dictionary<uint32_t, ShaderResBinding> RpakLib::ExtractShaderResourceBindings(co
 
 	Dictionary<uint32_t, ShaderResBinding> ResBindings;
 
-	if (Asset.RawDataIndex >= (this->LoadedFiles[Asset.FileIndex].SegmentBlocks.Count() + this->LoadedFiles[Asset.FileIndex].StartSegmentIndex))
+	if (Asset.RawDataIndex >= (this->LoadedFiles[Asset.FileIndex]->SegmentBlocks.Count() + this->LoadedFiles[Asset.FileIndex]->StartSegmentIndex))
 		return ResBindings;
 
 	if (Asset.RawDataIndex == -1)
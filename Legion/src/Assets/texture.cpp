@@ -2,6 +2,7 @@
 #include "RpakLib.h"
 #include "Path.h"
 #include "Directory.h"
+#include "File.h"
 #include <DDS.h>
 #include <rtech.h>
 #include <io.h>
@@ -75,52 +76,113 @@ void RpakLib::ExportTexture(const RpakLoadAsset& asset, const string& path, bool
 		IO::Directory::CreateDirectory(IO::Path::Combine(path, ""));
 	}
 
+	NormalRecalcType_t NormalRecalcType = NormalRecalcType_t::None;
+
+	if (normalRecalculate)
+		NormalRecalcType = (NormalRecalcType_t)ExportManager::Config.Get<System::SettingType::Integer>("NormalRecalcType");
+
+	string cacheKey = string::Format("0x%llx%s_%d", asset.NameHash, (const char*)ImageExtension, (int)NormalRecalcType);
+
+	std::promise<RpakExportedImage> written;
+	std::shared_future<RpakExportedImage> exported;
+	bool isFirstExport = false;
+
+	{
+		std::lock_guard<std::mutex> cacheLock(this->ExportCacheLock);
+
+		if (!this->ExportedImages.TryGetValue(cacheKey, exported))
+		{
+			exported = written.get_future().share();
+			this->ExportedImages.Add(cacheKey, exported);
+			isFirstExport = true;
+		}
+	}
+
 	string destName = nameOverride == "" ? string::Format("0x%llx%s", asset.NameHash, (const char*)ImageExtension) : nameOverride;
 	string destPath = IO::Path::Combine(path, destName);
 
-	std::unique_ptr<Assets::Texture> texture = nullptr;
-	string name;
+	// Another export already decoded this image, only place a copy of it at our destination
+	if (!isFirstExport)
+	{
+		const RpakExportedImage& image = exported.get();
 
-	this->ExtractTexture(asset, texture, name);
+		if (includeImageNames && image.Name.Length() > 0)
+			destPath = IO::Path::Combine(path, string::Format("%s%s", IO::Path::GetFileNameWithoutExtension(image.Name).ToCString(), (const char*)ImageExtension));
 
-	if (includeImageNames && name.Length() > 0)
-		destPath = IO::Path::Combine(path, string::Format("%s%s", IO::Path::GetFileNameWithoutExtension(name).ToCString(), (const char*)ImageExtension));
+		if (image.FilePath.Length() == 0 || image.FilePath == destPath || !Utils::ShouldWriteFile(destPath))
+			return;
+
+		try
+		{
+			IO::File::Copy(image.FilePath, destPath, true);
+		}
+		catch (...)
+		{
+			// Nothing, the thread attempted to export an image that already exists...
+		}
 
-	if (!Utils::ShouldWriteFile(destPath))
 		return;
+	}
+
+	RpakExportedImage image;
 
 	try
 	{
-		if (texture)
-		{
-			if (normalRecalculate)
-			{
-				NormalRecalcType_t NormalRecalcType = (NormalRecalcType_t)ExportManager::Config.Get<System::SettingType::Integer>("NormalRecalcType");
+		std::unique_ptr<Assets::Texture> texture = nullptr;
 
-				Assets::TranscodeType Type = Assets::TranscodeType::NormalMapBC5OpenGl;
+		this->ExtractTexture(asset, texture, image.Name);
 
-				switch (NormalRecalcType)
-				{
-				case NormalRecalcType_t::None:
-					break;
-				case NormalRecalcType_t::DirectX:
-					texture->Transcode(Assets::TranscodeType::NormalMapBC5);
-					break;
-				case NormalRecalcType_t::OpenGl:
-					texture->Transcode(Assets::TranscodeType::NormalMapBC5OpenGl);
-					break;
-				}
+		if (includeImageNames && image.Name.Length() > 0)
+			destPath = IO::Path::Combine(path, string::Format("%s%s", IO::Path::GetFileNameWithoutExtension(image.Name).ToCString(), (const char*)ImageExtension));
+
+		if (!Utils::ShouldWriteFile(destPath))
+		{
+			// Already on disk from an earlier session, later exports can still copy it
+			image.FilePath = destPath;
+		}
+		else if (texture)
+		{
+			switch (NormalRecalcType)
+			{
+			case NormalRecalcType_t::None:
+				break;
+			case NormalRecalcType_t::DirectX:
+				texture->Transcode(Assets::TranscodeType::NormalMapBC5);
+				break;
+			case NormalRecalcType_t::OpenGl:
+				texture->Transcode(Assets::TranscodeType::NormalMapBC5OpenGl);
+				break;
 			}
+
 			texture->Save(destPath, ImageSaveType);
+			image.FilePath = destPath;
 		}
 	}
 	catch (...)
 	{
 		// Nothing, the thread attempted to export an image that already exists...
 	}
+
+	written.set_value(image);
+}
+
+// Compressed mips are read here before being decoded, every thread keeps the largest one it has needed
+static uint8_t* GetCompressedMipScratch(uint64_t Size)
+{
+	static thread_local std::unique_ptr<uint8_t[]> Scratch = nullptr;
+	static thread_local uint64_t ScratchSize = 0;
+
+	if (Size > ScratchSize)
+	{
+		Scratch.reset(new uint8_t[Size]);
+		ScratchSize = Size;
+	}
+
+	return Scratch.get();
 }
 
 #undef max
+#undef min
 constexpr uint32_t ALIGNMENT_SIZE = 15;
 uint64_t CalculateHighestMipOffset(const TextureHeader& txtrHdr, const uint8_t& mipCount)
 {
@@ -208,11 +270,11 @@ void RpakLib::ExtractTexture(const RpakLoadAsset& asset, std::unique_ptr<Assets:
 
 	texture = std::make_unique<Assets::Texture>(txtrHdr.width, txtrHdr.height, ddsFormat.Format);
 
-	std::unique_ptr<IO::FileStream> starpakStream = nullptr;
+	std::unique_ptr<IO::Stream> starpakStream = nullptr;
 	uint64_t starpakOffset = asset.StarpakOffset & 0xFFFFFFFFFFFFFF00;
 	uint64_t optStarpakOffset = asset.OptimalStarpakOffset & 0xFFFFFFFFFFFFFF00;
 
-	std::unique_ptr<IO::MemoryStream> decompStarpakStream = nullptr;
+	bool isDecompressed = false;
 	uint64_t highestMipOffset = 0;
 	uint64_t blockSize = texture->BlockSize();
 
@@ -220,16 +282,17 @@ void RpakLib::ExtractTexture(const RpakLoadAsset& asset, std::unique_ptr<Assets:
 
 	if (isVersionWithCompression)
 	{
-		auto decompressBuffer = [](std::unique_ptr<IO::FileStream>& starpakStream, uint64_t bufferSize, uint64_t starpakOffset, uint64_t blockSize) -> std::unique_ptr<IO::MemoryStream>
+		// Compressed mips are decoded straight into the texture
+		auto decompressBuffer = [&texture](std::unique_ptr<IO::Stream>& starpakStream, uint64_t bufferSize, uint64_t starpakOffset, uint64_t blockSize)
 		{
-			auto Buffer = new uint8_t[bufferSize];
+			uint8_t* Buffer = GetCompressedMipScratch(bufferSize);
 
 			// Get location of compress starpakstream buffer.
-			starpakStream->SetPosition(starpakOffset);
-			starpakStream->Read(Buffer, 0, bufferSize);
+			starpakStream->ReadAt(Buffer, 0, bufferSize, starpakOffset);
 
-			// Decompress starpak texture.
-			return RTech::DecompressStreamedBuffer(Buffer, blockSize, (uint8_t)CompressionType::OODLE);
+			// Decompress starpak texture, if it fails it shouldn't be compressed?
+			if (!RTech::DecompressOodleBuffer(Buffer, bufferSize, texture->GetPixels(), blockSize))
+				std::memcpy(texture->GetPixels(), Buffer, std::min(bufferSize, blockSize));
 		};
 
 		if (asset.OptimalStarpakOffset != -1) // Is txtr data in opt starpak?
@@ -237,9 +300,10 @@ void RpakLib::ExtractTexture(const RpakLoadAsset& asset, std::unique_ptr<Assets:
 			starpakStream = this->GetStarpakStream(asset, true);
 			highestMipOffset = optStarpakOffset;
 
-			if (this->LoadedFiles[asset.FileIndex].OptimalStarpakMap.ContainsKey(asset.OptimalStarpakOffset))
+			if (this->LoadedFiles[asset.FileIndex]->OptimalStarpakMap.ContainsKey(asset.OptimalStarpakOffset))
 			{
-				decompStarpakStream = std::move(decompressBuffer(starpakStream, this->LoadedFiles[asset.FileIndex].OptimalStarpakMap[asset.OptimalStarpakOffset], optStarpakOffset, blockSize));
+				decompressBuffer(starpakStream, this->LoadedFiles[asset.FileIndex]->OptimalStarpakMap[asset.OptimalStarpakOffset], optStarpakOffset, blockSize);
+				isDecompressed = true;
 			}
 			else
 			{
@@ -258,7 +322,7 @@ void RpakLib::ExtractTexture(const RpakLoadAsset& asset, std::unique_ptr<Assets:
 				///
 
 				// FIX FIX FIX
-				starpakStream.release();
+				starpakStream.reset();
 				highestMipOffset = this->GetFileOffset(asset, asset.RawDataIndex, asset.RawDataOffset);
 			}
 		}
@@ -267,20 +331,21 @@ void RpakLib::ExtractTexture(const RpakLoadAsset& asset, std::unique_ptr<Assets:
 			starpakStream = this->GetStarpakStream(asset, false);
 			highestMipOffset = starpakOffset;
 
-			if (this->LoadedFiles[asset.FileIndex].StarpakMap.ContainsKey(asset.StarpakOffset))
+			if (this->LoadedFiles[asset.FileIndex]->StarpakMap.ContainsKey(asset.StarpakOffset))
 			{
-				decompStarpakStream = std::move(decompressBuffer(starpakStream, this->LoadedFiles[asset.FileIndex].StarpakMap[asset.StarpakOffset], starpakOffset, blockSize));
+				decompressBuffer(starpakStream, this->LoadedFiles[asset.FileIndex]->StarpakMap[asset.StarpakOffset], starpakOffset, blockSize);
+				isDecompressed = true;
 			}
 			else
 			{
 				g_Logger.Warning("Starpak for asset 0x%llx is not loaded. Output may be incorrect/weird\n", asset.NameHash);
 
 				// FIX FIX FIX
-				starpakStream.release();
+				starpakStream.reset();
 				highestMipOffset = this->GetFileOffset(asset, asset.RawDataIndex, asset.RawDataOffset);
 			}
 		}
-		else if (asset.RawDataIndex != -1 && asset.RawDataIndex >= this->LoadedFiles[asset.FileIndex].StartSegmentIndex) // Is txtr data in RPak?
+		else if (asset.RawDataIndex != -1 && asset.RawDataIndex >= this->LoadedFiles[asset.FileIndex]->StartSegmentIndex) // Is txtr data in RPak?
 		{
 			highestMipOffset = this->GetFileOffset(asset, asset.RawDataIndex, asset.RawDataOffset) + CalculateHighestMipOffset(txtrHdr, txtrHdr.permanentMipCount);
 		}
@@ -297,14 +362,14 @@ void RpakLib::ExtractTexture(const RpakLoadAsset& asset, std::unique_ptr<Assets:
 			starpakStream = this->GetStarpakStream(asset, true);
 			highestMipOffset = optStarpakOffset;
 
-			if (this->LoadedFiles[asset.FileIndex].OptimalStarpakMap.ContainsKey(asset.OptimalStarpakOffset))
+			if (this->LoadedFiles[asset.FileIndex]->OptimalStarpakMap.ContainsKey(asset.OptimalStarpakOffset))
 			{
-				highestMipOffset += (this->LoadedFiles[asset.FileIndex].OptimalStarpakMap[asset.OptimalStarpakOffset] - blockSize);
+				highestMipOffset += (this->LoadedFiles[asset.FileIndex]->OptimalStarpakMap[asset.OptimalStarpakOffset] - blockSize);
 			}
 			else
 			{
 				g_Logger.Warning("OptStarpak for asset 0x%llx is not loaded. Output may be incorrect/weird\n", asset.NameHash);
-				starpakStream.release();
+				starpakStream.reset();
 				highestMipOffset = this->GetFileOffset(asset, asset.RawDataIndex, asset.RawDataOffset) + (txtrHdr.dataSize - blockSize);
 			}
 		}
@@ -313,19 +378,19 @@ void RpakLib::ExtractTexture(const RpakLoadAsset& asset, std::unique_ptr<Assets:
 			starpakStream = this->GetStarpakStream(asset, false);
 			highestMipOffset = starpakOffset;
 
-			if (this->LoadedFiles[asset.FileIndex].StarpakMap.ContainsKey(asset.StarpakOffset))
+			if (this->LoadedFiles[asset.FileIndex]->StarpakMap.ContainsKey(asset.StarpakOffset))
 			{
 				if (!txtrHdr.unkMip)
-					highestMipOffset += (this->LoadedFiles[asset.FileIndex].StarpakMap[asset.StarpakOffset] - blockSize);
+					highestMipOffset += (this->LoadedFiles[asset.FileIndex]->StarpakMap[asset.StarpakOffset] - blockSize);
 			}
 			else
 			{
 				g_Logger.Warning("Starpak for asset 0x%llx is not loaded. Output may be incorrect/weird\n", asset.NameHash);
-				starpakStream.release();
+				starpakStream.reset();
 				highestMipOffset = this->GetFileOffset(asset, asset.RawDataIndex, asset.RawDataOffset) + (txtrHdr.dataSize - blockSize);
 			}
 		}
-		else if (asset.RawDataIndex != -1 && asset.RawDataIndex >= this->LoadedFiles[asset.FileIndex].StartSegmentIndex) // Is txtr data in RPak?
+		else if (asset.RawDataIndex != -1 && asset.RawDataIndex >= this->LoadedFiles[asset.FileIndex]->StartSegmentIndex) // Is txtr data in RPak?
 		{
 			if (!txtrHdr.unkMip)
 				highestMipOffset = this->GetFileOffset(asset, asset.RawDataIndex, asset.RawDataOffset) + (txtrHdr.dataSize - blockSize);
@@ -339,20 +404,13 @@ void RpakLib::ExtractTexture(const RpakLoadAsset& asset, std::unique_ptr<Assets:
 		}
 	}
 
-	if (decompStarpakStream)
+	// Compressed mips were already decoded into the texture
+	if (!isDecompressed)
 	{
-		decompStarpakStream->Read(texture->GetPixels(), 0, blockSize);
-		decompStarpakStream->Close();
-	}
-	else if (starpakStream)
-	{
-		starpakStream->SetPosition(highestMipOffset);
-		starpakStream->Read(texture->GetPixels(), 0, blockSize);
-	}
-	else 
-	{
-		rpakStream->SetPosition(highestMipOffset);
-		rpakStream->Read(texture->GetPixels(), 0, blockSize);
+		if (starpakStream)
+			starpakStream->ReadAt(texture->GetPixels(), 0, blockSize, highestMipOffset);
+		else
+			rpakStream->ReadAt(texture->GetPixels(), 0, blockSize, highestMipOffset);
 	}
 
 	// unswizzle ps4 textures
@@ -101,13 +101,12 @@ void RpakLib::ExtractUIIA(const RpakLoadAsset& Asset, std::unique_ptr<Assets::Te
 	{
 		auto TempStream = this->GetStarpakStream(Asset, true);
 
-		if (this->LoadedFiles[Asset.FileIndex].OptimalStarpakMap.ContainsKey(Asset.OptimalStarpakOffset))
+		if (this->LoadedFiles[Asset.FileIndex]->OptimalStarpakMap.ContainsKey(Asset.OptimalStarpakOffset))
 		{
-			auto BufferSize = this->LoadedFiles[Asset.FileIndex].OptimalStarpakMap[Asset.OptimalStarpakOffset];
+			auto BufferSize = this->LoadedFiles[Asset.FileIndex]->OptimalStarpakMap[Asset.OptimalStarpakOffset];
 			auto CompressedBuffer = std::make_unique<uint8_t[]>(BufferSize);
 
-			TempStream->SetPosition(ActualOptStarpakOffset);
-			TempStream->Read(CompressedBuffer.get(), 0, BufferSize);
+			TempStream->ReadAt(CompressedBuffer.get(), 0, BufferSize, ActualOptStarpakOffset);
 
 			StarpakStream = RTech::DecompressStreamedBuffer(CompressedBuffer.get(), BufferSize, TexHeader.Flags.CompressionType);
 		}
@@ -120,13 +119,12 @@ void RpakLib::ExtractUIIA(const RpakLoadAsset& Asset, std::unique_ptr<Assets::Te
 	{
 		auto TempStream = this->GetStarpakStream(Asset, false);
 
-		if (this->LoadedFiles[Asset.FileIndex].StarpakMap.ContainsKey(Asset.StarpakOffset))
+		if (this->LoadedFiles[Asset.FileIndex]->StarpakMap.ContainsKey(Asset.StarpakOffset))
 		{
-			uint64_t BufferSize = this->LoadedFiles[Asset.FileIndex].StarpakMap[Asset.StarpakOffset];
+			uint64_t BufferSize = this->LoadedFiles[Asset.FileIndex]->StarpakMap[Asset.StarpakOffset];
 			auto CompressedBuffer = std::make_unique<uint8_t[]>(BufferSize);
 
-			TempStream->SetPosition(ActualStarpakOffset);
-			TempStream->Read(CompressedBuffer.get(), 0, BufferSize);
+			TempStream->ReadAt(CompressedBuffer.get(), 0, BufferSize, ActualStarpakOffset);
 
 			StarpakStream = RTech::DecompressStreamedBuffer(CompressedBuffer.get(), BufferSize, TexHeader.Flags.CompressionType);
 		}
@@ -137,25 +135,22 @@ void RpakLib::ExtractUIIA(const RpakLoadAsset& Asset, std::unique_ptr<Assets::Te
 	}
 	else if (Asset.StarpakOffset == 0)
 	{
-		RpakStream->SetPosition(this->LoadedFiles[Asset.FileIndex].EmbeddedStarpakOffset);
+		uint64_t BufferSize = this->LoadedFiles[Asset.FileIndex]->EmbeddedStarpakSize;
 
-		uint64_t BufferSize = this->LoadedFiles[Asset.FileIndex].EmbeddedStarpakSize;
-		auto CompressedBuffer = std::make_unique<uint8_t[]>(BufferSize);
+		// The embedded starpak is already in memory, decompress it in place
+		const uint8_t* CompressedBuffer = RpakStream->Borrow(this->LoadedFiles[Asset.FileIndex]->EmbeddedStarpakOffset, BufferSize);
 
-		RpakStream->Read(CompressedBuffer.get(), 0, BufferSize);
-
-		StarpakStream = RTech::DecompressStreamedBuffer(CompressedBuffer.get(), BufferSize, TexHeader.Flags.CompressionType);
+		StarpakStream = RTech::DecompressStreamedBuffer(CompressedBuffer, BufferSize, TexHeader.Flags.CompressionType);
 	}
 
-	if (Asset.RawDataIndex != -1 && Asset.RawDataIndex >= this->LoadedFiles[Asset.FileIndex].StartSegmentIndex)
+	if (Asset.RawDataIndex != -1 && Asset.RawDataIndex >= this->LoadedFiles[Asset.FileIndex]->StartSegmentIndex)
 	{
 		//
 		// All texture data is inline in rpak, we can calculate without anything else
 		//
 
 		RUIImage RImage{};
-		RpakStream->SetPosition(this->GetFileOffset(Asset, Asset.RawDataIndex, Asset.RawDataOffset));
-		RpakStream->Read((uint8_t*)&RImage, 0, sizeof(RUIImage));
+		RpakStream->ReadAt((uint8_t*)&RImage, 0, sizeof(RUIImage), this->GetFileOffset(Asset, Asset.RawDataIndex, Asset.RawDataOffset));
 
 		bool UseHighResolution = StarpakStream != nullptr;
 
@@ -171,7 +166,6 @@ void RpakLib::ExtractUIIA(const RpakLoadAsset& Asset, std::unique_ptr<Assets::Te
 		{
 			RpakStream = std::move(StarpakStream);
 		}
-		RpakStream->SetPosition(Offset);
 
 		auto CodePoints = std::make_unique<RUIImageTile[]>(TotalBlocks);
 		uint64_t CodePointsSize = TotalBlocks * sizeof(RUIImageTile);
@@ -197,7 +191,7 @@ void RpakLib::ExtractUIIA(const RpakLoadAsset& Asset, std::unique_ptr<Assets::Te
 		}
 		else
 		{
-			RpakStream->Read((uint8_t*)CodePoints.get(), 0, CodePointsSize);
+			RpakStream->ReadAt((uint8_t*)CodePoints.get(), 0, CodePointsSize, Offset);
 		}
 
 		uint32_t NumBc1Blocks = 0;
@@ -247,10 +241,8 @@ void RpakLib::ExtractUIIA(const RpakLoadAsset& Asset, std::unique_ptr<Assets::Te
 						continue;
 					}
 
-					RpakStream->SetPosition(Point.Offset + Offset);
-
 					// Bc1Destination contains 32x32 BC1 512 bytes swizzled, copy to texture location.
-					RpakStream->Read(Bc1Destination.get() + BlockOffset, 0, 512);
+					RpakStream->ReadAt(Bc1Destination.get() + BlockOffset, 0, 512, Point.Offset + Offset);
 				}
 			}
 
@@ -352,10 +344,8 @@ void RpakLib::ExtractUIIA(const RpakLoadAsset& Asset, std::unique_ptr<Assets::Te
 						continue;
 					}
 
-					RpakStream->SetPosition(Point.Offset + Offset);
-
 					// Bc1Destination contains 32x32 BC7 1024 bytes swizzled, copy to texture location.
-					RpakStream->Read(Bc7Destination.get() + BlockOffset, 0, 1024);
+					RpakStream->ReadAt(Bc7Destination.get() + BlockOffset, 0, 1024, Point.Offset + Offset);
 				}
 			}
 
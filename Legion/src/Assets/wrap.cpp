@@ -81,7 +81,7 @@ void RpakLib::ExportWrappedFile(const RpakLoadAsset& Asset, const string& Path)
 	}
 	else
 	{
-		std::unique_ptr<IO::FileStream> StarpakStream = nullptr;
+		std::unique_ptr<IO::Stream> StarpakStream = nullptr;
 		uint64_t StreamOffset = 0;
 
 		if (Asset.OptimalStarpakOffset != -1)
@@ -106,23 +106,22 @@ void RpakLib::ExportWrappedFile(const RpakLoadAsset& Asset, const string& Path)
 
 	if (IsCompressed)
 	{
-		std::unique_ptr<IO::MemoryStream> DecompStream = RTech::DecompressStreamedBuffer(tmpBuf, Size, (uint8_t)CompressionType::OODLE);
-
 		uint8_t* outtmpBuf = new uint8_t[Size];
 
-		DecompStream->Read(outtmpBuf, 0, Size);
+		// If it fails it shouldn't be compressed?
+		if (!RTech::DecompressOodleBuffer(tmpBuf, Size, outtmpBuf, Size))
+			std::memcpy(outtmpBuf, tmpBuf, Size);
 
 		out.write((char*)outtmpBuf, Size);
 
-		DecompStream.release();
-
 		delete[] outtmpBuf;
 	}
 	else
 	{
 		out.write((char*)tmpBuf, Size);
-		delete[] tmpBuf;
 	}
 
+	delete[] tmpBuf;
+
 	out.close();
 };
\ No newline at end of file
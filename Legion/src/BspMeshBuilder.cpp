@@ -0,0 +1,78 @@
+#include "pch.h"
+#include "BspMeshBuilder.h"
+
+// Every corner of a mesh indexes the lump with 16 bits, so no mesh has more unique vertices than this
+constexpr uint32_t BspMaxMeshVertices = 0x10000;
+// Twice the vertices keeps the table at most half full
+constexpr uint32_t BspWeldTableSize = BspMaxMeshVertices * 2;
+
+BspMeshBuilder::BspMeshBuilder()
+	: _Mesh(nullptr), _Positions(nullptr), _Normals(nullptr), _Generation(0), _TableMask(0)
+{
+	this->_IndexVertices = std::make_unique<uint32_t[]>(BspMaxMeshVertices);
+	this->_IndexGenerations = std::make_unique<uint32_t[]>(BspMaxMeshVertices);
+	this->_Table = std::make_unique<WeldEntry[]>(BspWeldTableSize);
+}
+
+void BspMeshBuilder::Begin(Assets::Mesh& Mesh, const Math::Vector3* Positions, const Math::Vector3* Normals, uint32_t TriangleCount)
+{
+	this->_Mesh = &Mesh;
+	this->_Positions = Positions;
+	this->_Normals = Normals;
+	this->_Generation++;
+
+	// Small meshes only probe a small part of the table
+	const uint32_t MaxVertices = min(TriangleCount * 3, BspMaxMeshVertices);
+	uint32_t TableSize = 64;
+
+	while (TableSize < MaxVertices * 2)
+		TableSize <<= 1;
+
+	this->_TableMask = TableSize - 1;
+}
+
+uint32_t BspMeshBuilder::AddVertex(uint16_t Index, int32_t PositionIndex, int32_t NormalIndex, const Math::Vector2& UV)
+{
+	if (this->_IndexGenerations[Index] == this->_Generation)
+		return this->_IndexVertices[Index];
+
+	uint32_t U, V;
+	std::memcpy(&U, &UV.U, sizeof(uint32_t));
+	std::memcpy(&V, &UV.V, sizeof(uint32_t));
+
+	uint64_t Hash = ((uint64_t)(uint32_t)PositionIndex << 32) | (uint32_t)NormalIndex;
+	Hash ^= (((uint64_t)U << 32) | V) * 0x9E3779B97F4A7C15;
+	Hash *= 0xFF51AFD7ED558CCD;
+	Hash ^= Hash >> 32;
+
+	uint32_t Slot = (uint32_t)Hash & this->_TableMask;
+
+	while (true)
+	{
+		WeldEntry& Entry = this->_Table[Slot];
+
+		if (Entry.Generation != this->_Generation)
+		{
+			const uint32_t Vertex = this->_Mesh->Vertices.Count();
+
+			this->_Mesh->Vertices.EmplaceBack(this->_Positions[PositionIndex], this->_Normals[NormalIndex], Assets::VertexColor(), UV);
+
+			Entry = { PositionIndex, NormalIndex, U, V, Vertex, this->_Generation };
+
+			this->_IndexVertices[Index] = Vertex;
+			this->_IndexGenerations[Index] = this->_Generation;
+
+			return Vertex;
+		}
+
+		if (Entry.PositionIndex == PositionIndex && Entry.NormalIndex == NormalIndex && Entry.U == U && Entry.V == V)
+		{
+			this->_IndexVertices[Index] = Entry.Vertex;
+			this->_IndexGenerations[Index] = this->_Generation;
+
+			return Entry.Vertex;
+		}
+
+		Slot = (Slot + 1) & this->_TableMask;
+	}
+}
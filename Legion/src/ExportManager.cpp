@@ -1,12 +1,15 @@
 #include "pch.h"
 #include "ExportManager.h"
-#include "ParallelTask.h"
+#include "WorkStealingScheduler.h"
 #include "Path.h"
 #include "Directory.h"
 #include "File.h"
 #include "Environment.h"
 #include "LegionMain.h"
 
+#include <chrono>
+#include <algorithm>
+
 #define CONFIG_PATH "LegionPlus.cfg"
 
 #define INIT_SETTING(SType, Name, Val) \
@@ -51,6 +54,8 @@ void ExportManager::InitializeExporter()
 	INIT_SETTING(Integer, "ModelFormat", (uint32_t)ModelExportFormat_t::Cast);
 	INIT_SETTING(Integer, "AnimFormat", (uint32_t)AnimExportFormat_t::Cast);
 	INIT_SETTING(Integer, "ImageFormat", (uint32_t)ImageExportFormat_t::Png);
+	// Obj exports write every face corner as it's own vertex, instead of sharing them between faces
+	INIT_SETTING(Boolean, "ObjFlatVertices", false);
 
 	INIT_SETTING(Boolean, "LoadModels", true);
 	INIT_SETTING(Boolean, "LoadAnimations", true);
@@ -65,6 +70,9 @@ void ExportManager::InitializeExporter()
 	INIT_SETTING(Boolean, "LoadRSONs", false);
 	INIT_SETTING(Boolean, "LoadWrappedFiles", true);
 	INIT_SETTING(Boolean, "OverwriteExistingFiles", false);
+	INIT_SETTING(Boolean, "MapVpkArchives", true);
+	// Logs how long every exported asset took, not only the slowest ones
+	INIT_SETTING(Boolean, "LogAssetExportTimes", false);
 
 	Config.Save(ConfigPath);
 }
@@ -93,29 +101,93 @@ string ExportManager::GetMapExportPath()
 	return Result;
 }
 
+// Relative export cost of each rpak asset type, used to start the most expensive assets first
+static uint64_t GetRpakExportCost(uint32_t AssetType)
+{
+	switch (AssetType)
+	{
+	case (uint32_t)AssetType_t::Model:
+		return 100;
+	case (uint32_t)AssetType_t::AnimationRig:
+		return 60;
+	case (uint32_t)AssetType_t::Animation:
+		return 40;
+	case (uint32_t)AssetType_t::Material:
+		return 30;
+	case (uint32_t)AssetType_t::Texture:
+	case (uint32_t)AssetType_t::UIIA:
+		return 20;
+	case (uint32_t)AssetType_t::UIImageAtlas:
+		return 10;
+	default:
+		return 1;
+	}
+}
+
+// The count of slowest assets that are logged after an export
+constexpr uint32_t SlowestExportCount = 10;
+
+// Logs the total time and the slowest assets, every asset is logged in the order they were selected when enabled
+static void LogExportTimes(const List<string>& AssetNames, const std::vector<double>& AssetTimes, double TotalTime)
+{
+	if (ExportManager::Config.GetBool("LogAssetExportTimes"))
+	{
+		for (uint32_t i = 0; i < AssetNames.Count(); i++)
+			g_Logger.Info("Exported %s in %.2fms\n", AssetNames[i].ToCString(), AssetTimes[i]);
+	}
+
+	g_Logger.Info("Exported %d assets in %.2fms\n", AssetNames.Count(), TotalTime);
+
+	std::vector<uint32_t> Slowest(AssetNames.Count());
+
+	for (uint32_t i = 0; i < AssetNames.Count(); i++)
+		Slowest[i] = i;
+
+	const uint32_t SlowestCount = min(SlowestExportCount, AssetNames.Count());
+
+	std::partial_sort(Slowest.begin(), Slowest.begin() + SlowestCount, Slowest.end(), [&AssetTimes](uint32_t Lhs, uint32_t Rhs)
+	{
+		return AssetTimes[Lhs] > AssetTimes[Rhs];
+	});
+
+	for (uint32_t i = 0; i < SlowestCount; i++)
+		g_Logger.Info("Slowest #%d: %s in %.2fms\n", i + 1, AssetNames[Slowest[i]].ToCString(), AssetTimes[Slowest[i]]);
+}
+
 void ExportManager::ExportMilesAssets(const std::unique_ptr<MilesLib>& MilesFileSystem, List<ExportAsset> ExportAssets, ExportProgressCallback ProgressCallback, CheckStatusCallback StatusCallback, Forms::Form* MainForm)
 {
-	std::atomic<uint32_t> AssetIndex = 0;
+	std::atomic<bool> IsCancel = false;
+	std::atomic<uint32_t> AssetsDone = 0;
 
 	std::mutex UpdateMutex;
 	uint32_t CurrentProgress = 0;
 	string ExportDirectory = ExportPath;
 
+	List<string> AssetNames(ExportAssets.Count(), true);
+	std::vector<double> AssetTimes(ExportAssets.Count());
+
 	IO::Directory::CreateDirectory(IO::Path::Combine(ExportDirectory, "sounds"));
 
-	Threading::ParallelTask([&MilesFileSystem, &ExportAssets, &ProgressCallback, &StatusCallback, &MainForm, &AssetIndex, &CurrentProgress, &UpdateMutex, ExportDirectory]
+	MilesLib::BeginExport();
+
+	auto TotalStart = std::chrono::steady_clock::now();
+
+	Threading::WorkStealingScheduler Scheduler;
+
+	for (uint32_t i = 0; i < ExportAssets.Count(); i++)
 	{
-		bool IsCancel = false;
+		MilesAudioAsset& AudioAsset = MilesFileSystem->Assets[ExportAssets[i].AssetHash];
+		AssetNames[i] = AudioAsset.Name;
 
-		while (AssetIndex < ExportAssets.Count() && !IsCancel)
+		// Decoding time follows the size of the audio data
+		Scheduler.Schedule([&MilesFileSystem, &ExportAssets, &ProgressCallback, &StatusCallback, &MainForm, &IsCancel, &AssetsDone, &CurrentProgress, &UpdateMutex, &AssetTimes, &AssetNames, &ExportDirectory, &AudioAsset, i]
 		{
-			unsigned int AssetToConvert = AssetIndex++;
+			if (IsCancel)
+				return;
 
-			if (AssetToConvert >= ExportAssets.Count())
-				continue;
+			auto AssetStart = std::chrono::steady_clock::now();
 
-			ExportAsset& Asset = ExportAssets[AssetToConvert];
-			MilesAudioAsset& AudioAsset = MilesFileSystem->Assets[Asset.AssetHash];
+			ExportAsset& Asset = ExportAssets[i];
 			string  Path = IO::Path::Combine(ExportDirectory, "sounds");
 			bool  UseSubfolders = ExportManager::Config.Get<System::SettingType::Boolean>("AudioLanguageFolders");
 			if (UseSubfolders && AudioAsset.LocalizeIndex != -1) {
@@ -125,19 +197,32 @@ void ExportManager::ExportMilesAssets(const std::unique_ptr<MilesLib>& MilesFile
 			}
 			Path = IO::Path::Combine(Path, AudioAsset.Name + ".wav");
 
-			bool bSuccess = MilesFileSystem->ExtractAsset(AudioAsset, Path);
+			bool bSuccess = false;
+
+			// A failed asset is reported, the rest of the export carries on
+			try
+			{
+				bSuccess = MilesFileSystem->ExtractAsset(AudioAsset, Path);
+			}
+			catch (const std::exception& e)
+			{
+				g_Logger.Warning("Failed to export %s: %s\n", AssetNames[i].ToCString(), e.what());
+			}
+
+			AssetTimes[i] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - AssetStart).count();
 
 			if (!bSuccess)
 			{
 				((LegionMain*)MainForm)->SetAssetError(Asset.AssetIndex);
-				continue;
+				return;
 			}
 
-			IsCancel = StatusCallback(Asset.AssetIndex, MainForm);
+			if (StatusCallback(Asset.AssetIndex, MainForm))
+				IsCancel = true;
 
 			{
 				std::lock_guard<std::mutex> UpdateLock(UpdateMutex);
-				uint32_t NewProgress = (uint32_t)(((float)(AssetToConvert + 1) / (float)ExportAssets.Count()) * 100.f);
+				uint32_t NewProgress = (uint32_t)(((float)++AssetsDone / (float)ExportAssets.Count()) * 100.f);
 
 				if (NewProgress > CurrentProgress)
 				{
@@ -145,94 +230,116 @@ void ExportManager::ExportMilesAssets(const std::unique_ptr<MilesLib>& MilesFile
 					ProgressCallback(NewProgress, MainForm, false);
 				}
 			}
-		}
-		ProgressCallback(100, MainForm, true);
-	});
+		}, (uint64_t)AudioAsset.StreamSize + AudioAsset.PreloadSize);
+	}
+
+	Scheduler.Run();
+
+	LogExportTimes(AssetNames, AssetTimes, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - TotalStart).count());
 
+	ProgressCallback(100, MainForm, true);
 }
 
 void ExportManager::ExportRpakAssets(const std::unique_ptr<RpakLib>& RpakFileSystem, List<ExportAsset> ExportAssets, ExportProgressCallback ProgressCallback, CheckStatusCallback StatusCallback, Forms::Form* MainForm)
 {
-	std::atomic<uint32_t> AssetIndex = 0;
+	std::atomic<bool> IsCancel = false;
+	std::atomic<uint32_t> AssetsDone = 0;
 
 	std::mutex UpdateMutex;
 	uint32_t CurrentProgress = 0;
 	string ExportDirectory = ExportPath;
 
+	List<string> AssetNames(ExportAssets.Count(), true);
+	std::vector<double> AssetTimes(ExportAssets.Count());
+
 	RpakFileSystem->InitializeModelExporter((ModelExportFormat_t)Config.Get<System::SettingType::Integer>("ModelFormat"));
 	RpakFileSystem->InitializeAnimExporter((AnimExportFormat_t)Config.Get<System::SettingType::Integer>("AnimFormat"));
 	RpakFileSystem->InitializeImageExporter((ImageExportFormat_t)Config.Get<System::SettingType::Integer>("ImageFormat"));
 
-	Threading::ParallelTask([&RpakFileSystem, &ExportAssets, &ProgressCallback, &StatusCallback, &MainForm, &AssetIndex, &CurrentProgress, &UpdateMutex, ExportDirectory]
-	{
-		(void)CoInitializeEx(0, COINIT_MULTITHREADED);
+	auto TotalStart = std::chrono::steady_clock::now();
 
-		bool IsCancel = false;
+	Threading::WorkStealingScheduler Scheduler;
 
-		while (AssetIndex < ExportAssets.Count() && !IsCancel)
+	for (uint32_t i = 0; i < ExportAssets.Count(); i++)
+	{
+		auto& AssetToExport = RpakFileSystem->Assets[ExportAssets[i].AssetHash];
+		AssetNames[i] = string::Format("0x%llx", ExportAssets[i].AssetHash);
+
+		Scheduler.Schedule([&RpakFileSystem, &ExportAssets, &ProgressCallback, &StatusCallback, &MainForm, &IsCancel, &AssetsDone, &CurrentProgress, &UpdateMutex, &AssetTimes, &AssetNames, &ExportDirectory, &AssetToExport, i]
 		{
-			auto AssetToConvert = AssetIndex++;
+			if (IsCancel)
+				return;
 
-			if (AssetToConvert >= ExportAssets.Count())
-				continue;
+			auto AssetStart = std::chrono::steady_clock::now();
 
-			auto& Asset = ExportAssets[AssetToConvert];
-			auto& AssetToExport = RpakFileSystem->Assets[Asset.AssetHash];
+			auto& Asset = ExportAssets[i];
 
-			switch (AssetToExport.AssetType)
+			// A failed asset is reported, the rest of the export carries on
+			try
+			{
+				switch (AssetToExport.AssetType)
+				{
+				case (uint32_t)AssetType_t::Texture:
+					RpakFileSystem->ExportTexture(AssetToExport, IO::Path::Combine(ExportDirectory, "images"), true);
+					break;
+				case (uint32_t)AssetType_t::UIIA:
+					RpakFileSystem->ExportUIIA(AssetToExport, IO::Path::Combine(ExportDirectory, "images"));
+					break;
+				case (uint32_t)AssetType_t::Material:
+					RpakFileSystem->ExportMaterial(AssetToExport, IO::Path::Combine(ExportDirectory, "materials"));
+					break;
+				case (uint32_t)AssetType_t::Model:
+					RpakFileSystem->ExportModel(AssetToExport, IO::Path::Combine(ExportDirectory, "models"), IO::Path::Combine(ExportDirectory, "animations"));
+					break;
+				case (uint32_t)AssetType_t::AnimationRig:
+					RpakFileSystem->ExportAnimationRig(AssetToExport, IO::Path::Combine(ExportDirectory, "animations"));
+					break;
+				case (uint32_t)AssetType_t::Animation:
+					RpakFileSystem->ExportAnimationSeq(AssetToExport, IO::Path::Combine(ExportDirectory, "anim_sequences"));
+					break;
+				case (uint32_t)AssetType_t::DataTable:
+					RpakFileSystem->ExportDataTable(AssetToExport, IO::Path::Combine(ExportDirectory, "datatables"));
+					break;
+				case (uint32_t)AssetType_t::Subtitles:
+					RpakFileSystem->ExportSubtitles(AssetToExport, IO::Path::Combine(ExportDirectory, "subtitles"));
+					break;
+				case (uint32_t)AssetType_t::ShaderSet:
+					RpakFileSystem->ExportShaderSet(AssetToExport, IO::Path::Combine(ExportDirectory, "shadersets"));
+					break;
+				case (uint32_t)AssetType_t::UIImageAtlas:
+					RpakFileSystem->ExportUIImageAtlas(AssetToExport, IO::Path::Combine(ExportDirectory, "atlases"));
+					break;
+				case (uint32_t)AssetType_t::Settings:
+					RpakFileSystem->ExportSettings(AssetToExport, IO::Path::Combine(ExportDirectory, "settings"));
+					break;
+				case (uint32_t)AssetType_t::SettingsLayout:
+					RpakFileSystem->ExportSettingsLayout(AssetToExport, IO::Path::Combine(ExportDirectory, "settings_layouts"));
+					break;
+				case (uint32_t)AssetType_t::RSON:
+					RpakFileSystem->ExportRSON(AssetToExport, IO::Path::Combine(ExportDirectory, "rson"));
+					break;
+				case (uint32_t)AssetType_t::RUI:
+					RpakFileSystem->ExportRUI(AssetToExport, IO::Path::Combine(ExportDirectory, "rui"));
+					break;
+				case (uint32_t)AssetType_t::Wrap:
+					RpakFileSystem->ExportWrappedFile(AssetToExport, IO::Path::Combine(ExportDirectory, "wrap"));
+					break;
+				}
+			}
+			catch (const std::exception& e)
 			{
-			case (uint32_t)AssetType_t::Texture:
-				RpakFileSystem->ExportTexture(AssetToExport, IO::Path::Combine(ExportDirectory, "images"), true);
-				break;
-			case (uint32_t)AssetType_t::UIIA:
-				RpakFileSystem->ExportUIIA(AssetToExport, IO::Path::Combine(ExportDirectory, "images"));
-				break;
-			case (uint32_t)AssetType_t::Material:
-				RpakFileSystem->ExportMaterial(AssetToExport, IO::Path::Combine(ExportDirectory, "materials"));
-				break;
-			case (uint32_t)AssetType_t::Model:
-				RpakFileSystem->ExportModel(AssetToExport, IO::Path::Combine(ExportDirectory, "models"), IO::Path::Combine(ExportDirectory, "animations"));
-				break;
-			case (uint32_t)AssetType_t::AnimationRig:
-				RpakFileSystem->ExportAnimationRig(AssetToExport, IO::Path::Combine(ExportDirectory, "animations"));
-				break;
-			case (uint32_t)AssetType_t::Animation:
-				RpakFileSystem->ExportAnimationSeq(AssetToExport, IO::Path::Combine(ExportDirectory, "anim_sequences"));
-				break;
-			case (uint32_t)AssetType_t::DataTable:
-				RpakFileSystem->ExportDataTable(AssetToExport, IO::Path::Combine(ExportDirectory, "datatables"));
-				break;
-			case (uint32_t)AssetType_t::Subtitles:
-				RpakFileSystem->ExportSubtitles(AssetToExport, IO::Path::Combine(ExportDirectory, "subtitles"));
-				break;
-			case (uint32_t)AssetType_t::ShaderSet:
-				RpakFileSystem->ExportShaderSet(AssetToExport, IO::Path::Combine(ExportDirectory, "shadersets"));
-				break;
-			case (uint32_t)AssetType_t::UIImageAtlas:
-				RpakFileSystem->ExportUIImageAtlas(AssetToExport, IO::Path::Combine(ExportDirectory, "atlases"));
-				break;
-			case (uint32_t)AssetType_t::Settings:
-				RpakFileSystem->ExportSettings(AssetToExport, IO::Path::Combine(ExportDirectory, "settings"));
-				break;
-			case (uint32_t)AssetType_t::SettingsLayout:
-				RpakFileSystem->ExportSettingsLayout(AssetToExport, IO::Path::Combine(ExportDirectory, "settings_layouts"));
-				break;
-			case (uint32_t)AssetType_t::RSON:
-				RpakFileSystem->ExportRSON(AssetToExport, IO::Path::Combine(ExportDirectory, "rson"));
-				break;
-			case (uint32_t)AssetType_t::RUI:
-				RpakFileSystem->ExportRUI(AssetToExport, IO::Path::Combine(ExportDirectory, "rui"));
-				break;
-			case (uint32_t)AssetType_t::Wrap:
-				RpakFileSystem->ExportWrappedFile(AssetToExport, IO::Path::Combine(ExportDirectory, "wrap"));
-				break;
+				g_Logger.Warning("Failed to export %s: %s\n", AssetNames[i].ToCString(), e.what());
 			}
 
-			IsCancel = StatusCallback(Asset.AssetIndex, MainForm);
+			// Includes the sub-tasks, every asset waits for it's own before returning
+			AssetTimes[i] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - AssetStart).count();
+
+			if (StatusCallback(Asset.AssetIndex, MainForm))
+				IsCancel = true;
 
 			{
 				std::lock_guard<std::mutex> UpdateLock(UpdateMutex);
-				auto NewProgress = (uint32_t)(((float)AssetToConvert / (float)ExportAssets.Count()) * 100.f);
+				auto NewProgress = (uint32_t)(((float)++AssetsDone / (float)ExportAssets.Count()) * 100.f);
 
 				if (NewProgress > CurrentProgress)
 				{
@@ -240,47 +347,69 @@ void ExportManager::ExportRpakAssets(const std::unique_ptr<RpakLib>& RpakFileSys
 					ProgressCallback(NewProgress, MainForm, false);
 				}
 			}
-		}
+		}, GetRpakExportCost(AssetToExport.AssetType));
+	}
 
+	Scheduler.Run([]
+	{
+		(void)CoInitializeEx(0, COINIT_MULTITHREADED);
+	}, []
+	{
 		CoUninitialize();
 	});
 
+	RpakFileSystem->ReleaseStarpakHandles();
+
+	LogExportTimes(AssetNames, AssetTimes, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - TotalStart).count());
+
 	ProgressCallback(100, MainForm, true);
 }
 
 void ExportManager::ExportMdlAssets(const std::unique_ptr<MdlLib>& MdlFS, List<string>& ExportAssets)
 {
-	std::atomic<uint32_t> AssetIndex = 0;
-
-	std::mutex UpdateMutex;
-	uint32_t CurrentProgress = 0;
 	string ExportDirectory = ExportPath;
 
+	std::vector<double> AssetTimes(ExportAssets.Count());
+
 	IO::Directory::CreateDirectory(IO::Path::Combine(ExportDirectory, "models"));
 	IO::Directory::CreateDirectory(IO::Path::Combine(ExportDirectory, "animations"));
 
 	MdlFS->InitializeModelExporter((ModelExportFormat_t)Config.Get<System::SettingType::Integer>("ModelFormat"));
 	MdlFS->InitializeAnimExporter((AnimExportFormat_t)Config.Get<System::SettingType::Integer>("AnimFormat"));
 
-	Threading::ParallelTask([&MdlFS, &ExportAssets, &AssetIndex, &CurrentProgress, &UpdateMutex, ExportDirectory]
-	{
-		(void)CoInitializeEx(0, COINIT_MULTITHREADED);
+	auto TotalStart = std::chrono::steady_clock::now();
 
-		bool IsCancel = false;
+	Threading::WorkStealingScheduler Scheduler;
 
-		while (AssetIndex < ExportAssets.Count() && !IsCancel)
+	// Every mdl is weighted the same, they keep the order they were selected in
+	for (uint32_t i = 0; i < ExportAssets.Count(); i++)
+	{
+		Scheduler.Schedule([&MdlFS, &ExportAssets, &AssetTimes, &ExportDirectory, i]
 		{
-			auto AssetToConvert = AssetIndex++;
+			auto AssetStart = std::chrono::steady_clock::now();
 
-			if (AssetToConvert >= ExportAssets.Count())
-				continue;
+			try
+			{
+				MdlFS->ExportMDLv53(ExportAssets[i], ExportDirectory);
+			}
+			catch (const std::exception& e)
+			{
+				g_Logger.Warning("Failed to export %s: %s\n", ExportAssets[i].ToCString(), e.what());
+			}
 
-			auto& Asset = ExportAssets[AssetToConvert];
-			MdlFS->ExportMDLv53(Asset, ExportDirectory);
-		}
+			AssetTimes[i] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - AssetStart).count();
+		});
+	}
 
+	Scheduler.Run([]
+	{
+		(void)CoInitializeEx(0, COINIT_MULTITHREADED);
+	}, []
+	{
 		CoUninitialize();
 	});
+
+	LogExportTimes(ExportAssets, AssetTimes, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - TotalStart).count());
 }
 
 void ExportManager::ExportAssetList(std::unique_ptr<List<ApexAsset>>& AssetList, string RpakName, const string& FilePath)
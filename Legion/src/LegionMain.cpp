@@ -637,13 +637,6 @@ void LegionMain::OnLoadClick(Forms::Control* Sender)
 	if (OpenFileD.Count() == 0)
 		return;
 
-	else if (OpenFileD.Count() > MAX_LOADED_FILES)
-	{
-		string msg = string::Format("Please select %i or fewer files.", MAX_LOADED_FILES);
-		MessageBox::Show(msg, "Legion+", Forms::MessageBoxButtons::OK, Forms::MessageBoxIcon::Warning);
-		return;
-	}
-
 	ThisPtr->LoadApexFile(OpenFileD);
 }
 
@@ -9,6 +9,7 @@
 #include "KoreTheme.h"
 #include "bsplib.h"
 #include "CommandLine.h"
+#include "Directory.h"
 
 #pragma comment(linker,"/manifestdependency:\"type='win32' name='Microsoft.Windows.Common-Controls' version='6.0.0.0' processorArchitecture='*' publicKeyToken='6595b64144ccf1df' language='*'\"")
 
@@ -97,6 +98,17 @@ int APIENTRY WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLi
 			ExportManager::Config.SetBool("OverwriteExistingFiles", cmdline.HasParam(L"--overwrite"));
 			ExportManager::Config.SetBool("UseTxtrGuids", cmdline.HasParam(L"--usetxtrguids"));
 			ExportManager::Config.SetBool("SkinExport", cmdline.HasParam(L"--skinexport"));
+			ExportManager::Config.SetBool("ObjFlatVertices", cmdline.HasParam(L"--objflat"));
+			ExportManager::Config.SetBool("LogAssetExportTimes", cmdline.HasParam(L"--logexporttimes"));
+
+#ifdef LEGION_ANIM_CAPTURE
+			// Decoded animation sequences are also recorded for LegionBench, only debug builds have the flag
+			if (cmdline.HasParam(L"--animcapture"))
+			{
+				Rpak->AnimCapturePath = wstring(cmdline.GetParamValue(L"--animcapture")).ToString();
+				IO::Directory::CreateDirectory(Rpak->AnimCapturePath);
+			}
+#endif
 
 			// asset rpak formats flags
 			if (cmdline.HasParam(L"--mdlfmt"))
@@ -30,7 +30,7 @@ void MdlLib::InitializeModelExporter(ModelExportFormat_t Format)
 		ModelExporter = std::make_unique<Assets::Exporters::AutodeskMaya>();
 		break;
 	case ModelExportFormat_t::OBJ:
-		ModelExporter = std::make_unique<Assets::Exporters::WavefrontOBJ>();
+		ModelExporter = std::make_unique<Assets::Exporters::WavefrontOBJ>(!ExportManager::Config.GetBool("ObjFlatVertices"));
 		break;
 	case ModelExportFormat_t::XNALaraText:
 		ModelExporter = std::make_unique<Assets::Exporters::XNALaraAscii>();
@@ -344,6 +344,99 @@ MilesLib::~MilesLib()
 {
 }
 
+// Holds the part of a bank's name table that it's sources use, read in one go so names are parsed from memory
+struct MilesNameTable
+{
+	std::unique_ptr<char[]> Names;
+	uint64_t Length;
+
+	MilesNameTable(IO::Stream* Stream, uint64_t TableOffset, uint32_t LastNameOffset)
+		: Names(nullptr), Length(0)
+	{
+		const uint64_t StreamLength = Stream->GetLength();
+		const uint64_t Available = (TableOffset < StreamLength) ? StreamLength - TableOffset : 0;
+
+		// Names are short, so a small tail past the last offset almost always holds it's terminator
+		uint64_t Wanted = min((uint64_t)LastNameOffset + 0x200, Available);
+
+		while (true)
+		{
+			auto Grown = std::make_unique<char[]>(Wanted + 1);
+
+			if (this->Names)
+				std::memcpy(Grown.get(), this->Names.get(), this->Length);
+
+			Stream->Read((uint8_t*)Grown.get(), this->Length, Wanted - this->Length, TableOffset + this->Length);
+
+			this->Names = std::move(Grown);
+			this->Length = Wanted;
+
+			if (Wanted == Available || (LastNameOffset < Wanted && std::memchr(this->Names.get() + LastNameOffset, 0, Wanted - LastNameOffset)))
+				break;
+
+			Wanted = min(Wanted * 2, Available);
+		}
+
+		// Names running past the end of the file stop at it
+		this->Names[this->Length] = 0;
+	}
+
+	string GetName(uint32_t NameOffset) const
+	{
+		if (NameOffset >= this->Length)
+			return "";
+
+		return string(this->Names.get() + NameOffset, strnlen(this->Names.get() + NameOffset, this->Length - NameOffset));
+	}
+};
+
+template<typename TEntry>
+static uint32_t MilesLastNameOffset(const List<TEntry>& Sources)
+{
+	uint32_t LastNameOffset = 0;
+
+	for (auto& Entry : Sources)
+		LastNameOffset = max(LastNameOffset, Entry.NameOffset);
+
+	return LastNameOffset;
+}
+
+// The name a stream bank of a given language uses after the bank name, or nullptr for languages without one
+static const char* MilesStreamBankLanguage(MilesLanguageID Language)
+{
+	switch (Language)
+	{
+	case MilesLanguageID::None:
+		return "stream";
+	case MilesLanguageID::English:
+		return "english";
+	case MilesLanguageID::French:
+		return "french";
+	case MilesLanguageID::German:
+		return "german";
+	case MilesLanguageID::Spanish:
+		return "spanish";
+	case MilesLanguageID::Italian:
+		return "italian";
+	case MilesLanguageID::Japanese:
+		return "japanese";
+	case MilesLanguageID::Polish:
+		return "polish";
+	case MilesLanguageID::Russian:
+		return "russian";
+	case MilesLanguageID::Mandarin:
+		return "mandarin";
+	case MilesLanguageID::Korean:
+		return "korean";
+	case MilesLanguageID::FAKEPORTUGUESE:
+		return "portuguese";
+	case MilesLanguageID::FAKELATINSPAN:
+		return "mspanish";
+	default:
+		return nullptr;
+	}
+}
+
 void MilesLib::MountBank(const string& Path)
 {
 	auto BasePath = IO::Path::GetDirectoryName(Path);
@@ -359,6 +452,15 @@ void MilesLib::MountBank(const string& Path)
 
 	auto SelectedLanguage = (MilesLanguageID)ExportManager::Config.Get<System::SettingType::Integer>("AudioLanguage");
 
+	// Stream banks the mounted assets point to, they're resolved by name once the sources are parsed
+	Dictionary<uint32_t, bool> RequiredStreamBanks;
+
+	auto AddAsset = [this, &RequiredStreamBanks](const MilesAudioAsset& Asset)
+	{
+		Assets.Add(Hashing::XXHash::HashString(Asset.Name), Asset);
+		RequiredStreamBanks.Add(((uint32_t)Asset.LocalizeIndex << 16) + Asset.PatchIndex, true);
+	};
+
 	if (BankHeader.Version == 0xB)
 	{
 		// R2TT - only english audio exists
@@ -368,14 +470,14 @@ void MilesLib::MountBank(const string& Path)
 		List<MilesTitanfallSourceEntry> Sources(SourcesCount, true);
 		ReaderStream->Read((uint8_t*)&Sources[0], 0, sizeof(MilesTitanfallSourceEntry) * SourcesCount);
 
+		MilesNameTable NameTable(ReaderStream, NameTableOffset, MilesLastNameOffset(Sources));
+
 		for (auto& Entry : Sources)
 		{
-			ReaderStream->SetPosition(NameTableOffset + Entry.NameOffset);
-
-			auto Name = Reader.ReadCString();
+			auto Name = NameTable.GetName(Entry.NameOffset);
 
 			MilesAudioAsset Asset{ Name, Entry.SampleRate, Entry.ChannelCount, Entry.StreamHeaderOffset, Entry.StreamHeaderSize, Entry.StreamDataOffset, Entry.StreamDataSize, Entry.PatchIndex, (int32_t)Entry.EntryLocal };
-			Assets.Add(Hashing::XXHash::HashString(Name), Asset);
+			AddAsset(Asset);
 		}
 	}
 	else if (BankHeader.Version > 0xB && BankHeader.Version <= 0xD)
@@ -391,19 +493,17 @@ void MilesLib::MountBank(const string& Path)
 		List<MilesTitanfallSourceEntry> Sources(SourcesCount, true);
 		ReaderStream->Read((uint8_t*)&Sources[0], 0, sizeof(MilesTitanfallSourceEntry) * SourcesCount);
 
+		MilesNameTable NameTable(ReaderStream, NameTableOffset, MilesLastNameOffset(Sources));
+
 		for (auto& Entry : Sources)
 		{
-			ReaderStream->SetPosition(NameTableOffset + Entry.NameOffset);
-
-			auto Name = Reader.ReadCString();
-
 			// fix lang because titanfall is slightly different
 			MilesLanguageID fixedLang = ApexLangFromTF(static_cast<MilesLanguageIDTitanfall>(Entry.EntryLocal));
 
 			if (fixedLang == MilesLanguageID::None || fixedLang == SelectedLanguage)
 			{
-				MilesAudioAsset Asset{ Name, Entry.SampleRate, Entry.ChannelCount, Entry.StreamHeaderOffset, Entry.StreamHeaderSize, Entry.StreamDataOffset, Entry.StreamDataSize, Entry.PatchIndex, (int32_t)fixedLang};
-				Assets.Add(Hashing::XXHash::HashString(Name), Asset);
+				MilesAudioAsset Asset{ NameTable.GetName(Entry.NameOffset), Entry.SampleRate, Entry.ChannelCount, Entry.StreamHeaderOffset, Entry.StreamHeaderSize, Entry.StreamDataOffset, Entry.StreamDataSize, Entry.PatchIndex, (int32_t)fixedLang};
+				AddAsset(Asset);
 			}
 		}
 	}
@@ -412,32 +512,29 @@ void MilesLib::MountBank(const string& Path)
 		if (BankHeader.Version >= 40) {
 			// S11.1
 			auto SoundCount = BankHeader.SourcesCount - BankHeader.DialogueCount;
-			{ 
-				// Gather non-voiced audio files
-				List<MilesApexSourceEntry> SoundSources(SoundCount, true);
-				ReaderStream->SetPosition(BankHeader.SourceEntryOffset);
-				ReaderStream->Read((uint8_t*)&SoundSources[0], 0, sizeof(MilesApexSourceEntry) * SoundCount);
-				for (auto& Entry : SoundSources)
-				{
-					ReaderStream->SetPosition(BankHeader.NameTableOffset + Entry.NameOffset);
-					auto Name = Reader.ReadCString();
-					MilesAudioAsset Asset{ Name, Entry.SampleRate, Entry.ChannelCount, Entry.StreamHeaderOffset, Entry.StreamHeaderSize, Entry.StreamDataOffset, Entry.StreamDataSize, Entry.PatchIndex, (int32_t)Entry.EntryLocal };
-					Assets.Add(Hashing::XXHash::HashString(Name), Asset);
-				}
+
+			// Gather non-voiced audio files
+			List<MilesApexSourceEntry> SoundSources(SoundCount, true);
+			ReaderStream->SetPosition(BankHeader.SourceEntryOffset);
+			ReaderStream->Read((uint8_t*)&SoundSources[0], 0, sizeof(MilesApexSourceEntry) * SoundCount);
+
+			// Gather voiced audio files in the selected language
+			List<MilesApexSourceEntry> DialogueSources(BankHeader.DialogueCount, true);
+			ReaderStream->SetPosition(BankHeader.SourceEntryOffset + sizeof(MilesApexSourceEntry) * (SoundCount + (int32_t)SelectedLanguage * BankHeader.DialogueCount));
+			ReaderStream->Read((uint8_t*)&DialogueSources[0], 0, sizeof(MilesApexSourceEntry) * BankHeader.DialogueCount);
+
+			MilesNameTable NameTable(ReaderStream, BankHeader.NameTableOffset, max(MilesLastNameOffset(SoundSources), MilesLastNameOffset(DialogueSources)));
+
+			for (auto& Entry : SoundSources)
+			{
+				MilesAudioAsset Asset{ NameTable.GetName(Entry.NameOffset), Entry.SampleRate, Entry.ChannelCount, Entry.StreamHeaderOffset, Entry.StreamHeaderSize, Entry.StreamDataOffset, Entry.StreamDataSize, Entry.PatchIndex, (int32_t)Entry.EntryLocal };
+				AddAsset(Asset);
 			}
 
+			for (auto& Entry : DialogueSources)
 			{
-				// Gather voiced audio files in the selected language
-				List<MilesApexSourceEntry> DialogueSources(BankHeader.DialogueCount, true);
-				ReaderStream->SetPosition(BankHeader.SourceEntryOffset + sizeof(MilesApexSourceEntry) * (SoundCount + (int32_t)SelectedLanguage * BankHeader.DialogueCount));
-				ReaderStream->Read((uint8_t*)&DialogueSources[0], 0, sizeof(MilesApexSourceEntry) * BankHeader.DialogueCount);
-				for (auto& Entry : DialogueSources)
-				{
-					ReaderStream->SetPosition(BankHeader.NameTableOffset + Entry.NameOffset);
-					auto Name = Reader.ReadCString();
-					MilesAudioAsset Asset{ Name, Entry.SampleRate, Entry.ChannelCount, Entry.StreamHeaderOffset, Entry.StreamHeaderSize, Entry.StreamDataOffset, Entry.StreamDataSize, Entry.PatchIndex, (int32_t)Entry.EntryLocal };
-					Assets.Add(Hashing::XXHash::HashString(Name), Asset);
-				}
+				MilesAudioAsset Asset{ NameTable.GetName(Entry.NameOffset), Entry.SampleRate, Entry.ChannelCount, Entry.StreamHeaderOffset, Entry.StreamHeaderSize, Entry.StreamDataOffset, Entry.StreamDataSize, Entry.PatchIndex, (int32_t)Entry.EntryLocal };
+				AddAsset(Asset);
 			}
 		}
 		else if (BankHeader.Version >= 28 && BankHeader.Version <= 36) {
@@ -457,16 +554,14 @@ void MilesLib::MountBank(const string& Path)
 			List<MilesApexS3SourceEntry> Sources(SourcesCount, true);
 			ReaderStream->Read((uint8_t*)&Sources[0], 0, sizeof(MilesApexS3SourceEntry) * SourcesCount);
 
+			MilesNameTable NameTable(ReaderStream, NameTableOffset, MilesLastNameOffset(Sources));
+
 			for (auto& Entry : Sources)
 			{
-				ReaderStream->SetPosition(NameTableOffset + Entry.NameOffset);
-
-				auto Name = Reader.ReadCString();
-
 				if (Entry.EntryLocal == MilesLanguageID::None || Entry.EntryLocal == SelectedLanguage)
 				{
-					MilesAudioAsset Asset{ Name, Entry.SampleRate, Entry.ChannelCount, Entry.StreamHeaderOffset, Entry.StreamHeaderSize, Entry.StreamDataOffset, Entry.StreamDataSize, Entry.PatchIndex, (uint32_t)Entry.EntryLocal };
-					Assets.Add(Hashing::XXHash::HashString(Name), Asset);
+					MilesAudioAsset Asset{ NameTable.GetName(Entry.NameOffset), Entry.SampleRate, Entry.ChannelCount, Entry.StreamHeaderOffset, Entry.StreamHeaderSize, Entry.StreamDataOffset, Entry.StreamDataSize, Entry.PatchIndex, (uint32_t)Entry.EntryLocal };
+					AddAsset(Asset);
 				}
 			}
 		}
@@ -476,89 +571,122 @@ void MilesLib::MountBank(const string& Path)
 		}
 	}
 
-	auto Language = LanguageName(SelectedLanguage);
-
-	struct MStrFile {
-		MilesLanguageID languageID;
-		int32_t patch;
-		string filename;
-	};
+	// Stream banks are named after the bank, their language and patch, e.g. general_english_patch_1.mstr
+	auto BankName = IO::Path::GetFileNameWithoutExtension(Path);
+	bool MissingStreamBanks = false;
 
-	auto Paths = IO::Directory::GetFiles(BasePath, "*.mstr");
-
-	for (auto& Path : Paths)
+	for (auto& Required : RequiredStreamBanks)
 	{
-		MilesStreamBankHeader StreamHeader;
-		try {
-			auto StreamReader = IO::BinaryReader(IO::File::OpenRead(Path));
-			StreamHeader = StreamReader.Read<MilesStreamBankHeader>();
-		}
-		catch (...) { continue; }
+		const uint32_t KeyIndex = Required.Key();
 
-		if (this->MbnkVersion >= 11 && this->MbnkVersion <= 13)
-			StreamHeader.LocalizeIndex = ApexLangFromTF(static_cast<MilesLanguageIDTitanfall>(StreamHeader.LocalizeIndex));
+		if (StreamBanks.ContainsKey(KeyIndex))
+			continue;
 
-		if (StreamHeader.Magic != 0x43535452) {
-			g_Logger.Warning("File %s has .mstr extension but wrong magic number\n", Path.ToCString());
+		const auto Language = (MilesLanguageID)(int16_t)(KeyIndex >> 16);
+		const auto PatchIndex = (uint16_t)(KeyIndex & 0xFFFF);
+		const char* LanguageName = MilesStreamBankLanguage(Language);
+
+		if (LanguageName == nullptr)
+		{
+			MissingStreamBanks = true;
 			continue;
 		}
-		if (StreamHeader.LocalizeIndex != MilesLanguageID::None && StreamHeader.LocalizeIndex != SelectedLanguage) continue;
 
-		g_Logger.Info("Loaded %s (patch %d) audio bank: %s\n", LanguageName(StreamHeader.LocalizeIndex).ToCString(), StreamHeader.PatchIndex, Path.ToCString());
+		string StreamName = (PatchIndex == 0) ? string::Format("%s_%s.mstr", BankName.ToCString(), LanguageName) : string::Format("%s_%s_patch_%d.mstr", BankName.ToCString(), LanguageName, PatchIndex);
+		string StreamPath = IO::Path::Combine(BasePath, StreamName);
 
-		uint32_t KeyIndex = ((uint32_t)StreamHeader.LocalizeIndex << 16) + StreamHeader.PatchIndex;
+		if (!IO::File::Exists(StreamPath) || !this->MountStreamBank(StreamPath, SelectedLanguage) || !StreamBanks.ContainsKey(KeyIndex))
+			MissingStreamBanks = true;
+	}
+
+	// Anything not named like the game ships it is found by reading every stream bank's header
+	if (MissingStreamBanks)
+	{
+		auto Paths = IO::Directory::GetFiles(BasePath, "*.mstr");
 
-		MilesStreamBank NewBank{ Path, StreamHeader.StreamDataOffset };
-		StreamBanks.Add(KeyIndex, NewBank);
+		for (auto& StreamPath : Paths)
+			this->MountStreamBank(StreamPath, SelectedLanguage);
 	}
 }
 
-bool MilesLib::ExtractAsset(const MilesAudioAsset& Asset, const string& FilePath)
+bool MilesLib::MountStreamBank(const string& Path, MilesLanguageID SelectedLanguage)
 {
-	uint32_t KeyIndex = ((uint32_t)Asset.LocalizeIndex << 16) + Asset.PatchIndex;
+	MilesStreamBankHeader StreamHeader;
+	try {
+		auto StreamReader = IO::BinaryReader(IO::File::OpenRead(Path));
+		StreamHeader = StreamReader.Read<MilesStreamBankHeader>();
+	}
+	catch (...) { return false; }
 
-	if (!StreamBanks.ContainsKey(KeyIndex))
+	if (this->MbnkVersion >= 11 && this->MbnkVersion <= 13)
+		StreamHeader.LocalizeIndex = ApexLangFromTF(static_cast<MilesLanguageIDTitanfall>(StreamHeader.LocalizeIndex));
+
+	if (StreamHeader.Magic != 0x43535452) {
+		g_Logger.Warning("File %s has .mstr extension but wrong magic number\n", Path.ToCString());
 		return false;
-	
-	const auto& Bank = StreamBanks[KeyIndex];
-	auto Reader = IO::BinaryReader(IO::File::OpenRead(Bank.Path));
-	auto ReaderStream = Reader.GetBaseStream();
+	}
+	if (StreamHeader.LocalizeIndex != MilesLanguageID::None && StreamHeader.LocalizeIndex != SelectedLanguage) return false;
+
+	uint32_t KeyIndex = ((uint32_t)StreamHeader.LocalizeIndex << 16) + StreamHeader.PatchIndex;
+
+	// Already mounted, either by name or by an earlier scan
+	if (StreamBanks.ContainsKey(KeyIndex))
+		return true;
+
+	g_Logger.Info("Loaded %s (patch %d) audio bank: %s\n", LanguageName(StreamHeader.LocalizeIndex).ToCString(), StreamHeader.PatchIndex, Path.ToCString());
+
+	MilesStreamBank NewBank{ Path, StreamHeader.StreamDataOffset };
+	StreamBanks.Add(KeyIndex, NewBank);
+
+	return true;
+}
+
+// The Bink audio decoder table from binkawin64.dll, shared by every export thread once it's resolved
+struct MilesBinkDecoder
+{
+	uintptr_t Module;
+	uintptr_t Table;
+
+	bool VersionTF2;
+	bool VersionRetail;
+};
 
-	static uintptr_t binkawin = 0;
-	if (!binkawin) {
-		if ((binkawin = (uintptr_t)LoadLibraryA("binkawin64.dll")) == 0)
+// Loads binkawin64.dll and finds it's decoder table
+static bool MilesResolveBinkDecoder(MilesBinkDecoder& Result)
+{
+	uintptr_t binkawin = 0;
+	if ((binkawin = (uintptr_t)LoadLibraryA("binkawin64.dll")) == 0)
+	{
+		HKEY hKey = HKEY_LOCAL_MACHINE;
+		HKEY resKey;
+		string installDir;
+		char buf[1024]{};
+		DWORD BufferSize = 1025;
+
+		// check origin for the apex installation directory
+		if (RegGetValueA(hKey, "SOFTWARE\\Respawn\\Apex", "Install Dir", RRF_RT_ANY, NULL, (PVOID)&buf, &BufferSize) != ERROR_SUCCESS)
 		{
-			HKEY hKey = HKEY_LOCAL_MACHINE;
-			HKEY resKey;
-			string installDir;
-			char buf[1024]{};
-			DWORD BufferSize = 1025;
-
-			// check origin for the apex installation directory
-			if (RegGetValueA(hKey, "SOFTWARE\\Respawn\\Apex", "Install Dir", RRF_RT_ANY, NULL, (PVOID)&buf, &BufferSize) != ERROR_SUCCESS)
+			// origin apex was not found; check steam
+			// this is bad. users can have apex installed on steam on a different drive to the steam installation and this won't find it
+			if (RegGetValueA(HKEY_CURRENT_USER, "SOFTWARE\\Valve\\Steam", "SteamPath", RRF_RT_ANY, NULL, (PVOID)&buf, &BufferSize) != ERROR_SUCCESS)
 			{
-				// origin apex was not found; check steam
-				// this is bad. users can have apex installed on steam on a different drive to the steam installation and this won't find it
-				if (RegGetValueA(HKEY_CURRENT_USER, "SOFTWARE\\Valve\\Steam", "SteamPath", RRF_RT_ANY, NULL, (PVOID)&buf, &BufferSize) != ERROR_SUCCESS)
-				{
-					g_Logger.Warning("no apex installation found. please bug this if you have apex and provide your installation path\n");
-					return false;
-				}
-				else {
-					installDir = IO::Path::Combine(buf, "steamapps");
-					installDir = IO::Path::Combine(installDir, "common");
-					installDir = IO::Path::Combine(installDir, "Apex Legends");
-				}
+				g_Logger.Warning("no apex installation found. please bug this if you have apex and provide your installation path\n");
+				return false;
 			}
 			else {
-				installDir = buf;
+				installDir = IO::Path::Combine(buf, "steamapps");
+				installDir = IO::Path::Combine(installDir, "common");
+				installDir = IO::Path::Combine(installDir, "Apex Legends");
 			}
-
-			SetDllDirectoryA(installDir.ToCString());
-			binkawin = (uintptr_t)LoadLibraryA("binkawin64.dll");
-
 		}
+		else {
+			installDir = buf;
+		}
+
+		SetDllDirectoryA(installDir.ToCString());
+		binkawin = (uintptr_t)LoadLibraryA("binkawin64.dll");
 	}
+
 	if (!binkawin)
 	{
 		//throw new std::exception("Failed to load binkawin64.dll!");
@@ -567,34 +695,97 @@ bool MilesLib::ExtractAsset(const MilesAudioAsset& Asset, const string& FilePath
 	}
 
 	// Dynamically get a table
-	static uintptr_t binka = 0;
-	if (!binka) {
-		const auto proc = uintptr_t(GetProcAddress(HMODULE(binkawin), "MilesDriverRegisterBinkAudio")) + 3;
+	const auto proc = uintptr_t(GetProcAddress(HMODULE(binkawin), "MilesDriverRegisterBinkAudio")) + 3;
 
-		if (proc == 3)
-			return false;
+	if (proc == 3)
+		return false;
 
-		const auto offset = *(uint32_t*)proc;
-		binka = proc + 4 + offset;
-	}
+	const auto offset = *(uint32_t*)proc;
+	const auto binka = proc + 4 + offset;
 
 	// Determine if version is supported or not...
-	static bool check = false;
-	static bool version_tf2 = false;
-	static bool version_retail = false;
-	if (!check) {
-		if ((*(uintptr_t*)(binka + 7 * 8) != 0) && (*(uintptr_t*)(binka + 7 * 8) != 0x0A09080605040302)) {
-			version_retail = true;
-			check = true;
-		}
-		else {
-			const auto dosHeader = PIMAGE_DOS_HEADER(binkawin);
-			const auto imageNTHeaders = PIMAGE_NT_HEADERS(binkawin + dosHeader->e_lfanew);
-			version_tf2 = (imageNTHeaders->FileHeader.TimeDateStamp <= 0x57E48A0C);
-			check = true;
+	if ((*(uintptr_t*)(binka + 7 * 8) != 0) && (*(uintptr_t*)(binka + 7 * 8) != 0x0A09080605040302)) {
+		Result.VersionRetail = true;
+	}
+	else {
+		const auto dosHeader = PIMAGE_DOS_HEADER(binkawin);
+		const auto imageNTHeaders = PIMAGE_NT_HEADERS(binkawin + dosHeader->e_lfanew);
+		Result.VersionTF2 = (imageNTHeaders->FileHeader.TimeDateStamp <= 0x57E48A0C);
+	}
+
+	Result.Module = binkawin;
+	Result.Table = binka;
+	return true;
+}
+
+// The decoder is resolved the first time it's available and kept, a failure is kept until the next export
+// starts so installing apex or the dll doesn't need a restart, and it's only tried and logged once per export
+static std::mutex BinkDecoderLock;
+static std::atomic<bool> BinkDecoderResolved = false;
+static std::atomic<bool> BinkDecoderFailed = false;
+static MilesBinkDecoder BinkDecoder{};
+
+static bool MilesGetBinkDecoder(MilesBinkDecoder& Decoder)
+{
+	if (!BinkDecoderResolved)
+	{
+		if (BinkDecoderFailed)
+			return false;
+
+		std::lock_guard<std::mutex> Lock(BinkDecoderLock);
+
+		if (!BinkDecoderResolved)
+		{
+			if (BinkDecoderFailed || !MilesResolveBinkDecoder(BinkDecoder))
+			{
+				BinkDecoderFailed = true;
+				return false;
+			}
+
+			BinkDecoderResolved = true;
 		}
 	}
 
+	Decoder = BinkDecoder;
+	return true;
+}
+
+void MilesLib::BeginExport()
+{
+	std::lock_guard<std::mutex> Lock(BinkDecoderLock);
+	BinkDecoderFailed = false;
+}
+
+// Every export thread keeps a stream open for each bank it read from, so a bank is opened once per thread instead of once per asset
+static IO::BinaryReader& MilesGetBankReader(const string& Path)
+{
+	static thread_local Dictionary<string, std::shared_ptr<IO::BinaryReader>> BankReaders;
+
+	if (!BankReaders.ContainsKey(Path))
+		BankReaders.Add(Path, std::make_shared<IO::BinaryReader>(IO::File::OpenRead(Path)));
+
+	return *BankReaders[Path];
+}
+
+bool MilesLib::ExtractAsset(const MilesAudioAsset& Asset, const string& FilePath)
+{
+	uint32_t KeyIndex = ((uint32_t)Asset.LocalizeIndex << 16) + Asset.PatchIndex;
+
+	if (!StreamBanks.ContainsKey(KeyIndex))
+		return false;
+	
+	const auto& Bank = StreamBanks[KeyIndex];
+	auto& Reader = MilesGetBankReader(Bank.Path);
+	auto ReaderStream = Reader.GetBaseStream();
+
+	MilesBinkDecoder Decoder{};
+	if (!MilesGetBinkDecoder(Decoder))
+		return false;
+
+	const auto binka = Decoder.Table;
+	const bool version_tf2 = Decoder.VersionTF2;
+	const bool version_retail = Decoder.VersionRetail;
+
 	// function types in the table
 	using metadata_f_t = uintptr_t(__fastcall*)(void* data, size_t size, uint16_t* channels, uint32_t* sample_rate, uint32_t* samples_count, uint32_t* adw4);
 	
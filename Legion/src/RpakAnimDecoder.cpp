@@ -0,0 +1,651 @@
+#include "pch.h"
+#include "RpakAnimDecoder.h"
+#include "File.h"
+#include "Half.h"
+#include <rtech.h>
+
+RpakAnimDecoder::RpakAnimDecoder(Assets::Animation& Anim, uint32_t BoneCount, bool Additive)
+	: _Anim(Anim), _BoneCount(BoneCount), _Additive(Additive), _Tracks(BoneCount), _SectionData(nullptr), _SectionSize(0), _StaticHalves(nullptr), _StaticFloats(nullptr), _StaticQuats(nullptr), _StaticRotations(nullptr), _StaticHalfCapacity(0), _StaticQuatCapacity(0), _Scratch(nullptr), _ScratchFrames(0), _Buffer(nullptr), _BufferSize(0)
+{
+}
+
+List<RpakAnimSection> RpakAnimDecoder::BuildSections(const RpakAnimLayout& Layout)
+{
+	List<RpakAnimSection> Result;
+
+	for (uint32_t Frame = 0; Frame < Layout.FrameCount; Frame++)
+	{
+		uint32_t SectionIndex = 0;
+		uint32_t SectionFrame = Frame;
+
+		if (Layout.SectionFrames && Frame >= Layout.SplitFrames)
+		{
+			const uint32_t FrameAfterSplit = Frame - Layout.SplitFrames;
+
+			if (Layout.FrameCount <= Layout.SplitFrames || Frame != Layout.FrameCount - 1)
+			{
+				SectionIndex = FrameAfterSplit / Layout.SectionFrames + 1;
+				SectionFrame = FrameAfterSplit % Layout.SectionFrames;
+			}
+			else
+			{
+				// The last frame is stored in it's own section
+				SectionIndex = (Layout.FrameCount - Layout.SplitFrames - 1) / Layout.SectionFrames + 2;
+				SectionFrame = 0;
+			}
+		}
+
+		if (Result.Count() > 0)
+		{
+			auto& Run = Result[Result.Count() - 1];
+
+			if (Run.Index == SectionIndex && (Run.FirstSectionFrame + Run.FrameCount) == SectionFrame)
+			{
+				Run.FrameCount++;
+				continue;
+			}
+		}
+
+		Result.Add({ SectionIndex, Frame, SectionFrame, 1 });
+	}
+
+	return Result;
+}
+
+void RpakAnimDecoder::ResolveSection(uint8_t* Data, uint64_t Size)
+{
+	this->_Tracks.Clear();
+
+	// Every bone has 4 bits of flags, padded to an even count of bytes
+	const uint64_t FlagSize = ((4 * (uint64_t)this->_BoneCount + 7) / 8 + 1) & 0xFFFFFFFFFFFFFFFE;
+
+	if (FlagSize > Size)
+		throw std::exception("Animation section is outside of the stream");
+
+	uint64_t Offset = FlagSize;
+
+	for (uint32_t b = 0; b < this->_BoneCount; b++)
+	{
+		const uint8_t BoneFlags = (Data[b / 2] >> (4 * (b % 2))) & (STUDIO_ANIM_BONEPOS | STUDIO_ANIM_BONEROT | STUDIO_ANIM_BONESCALE);
+
+		if (!BoneFlags)
+			continue;
+
+		if (Offset + sizeof(mstudio_rle_anim_t) > Size)
+			throw std::exception("Animation section is outside of the stream");
+
+		mstudio_rle_anim_t Header = *(mstudio_rle_anim_t*)(Data + Offset);
+		Offset += sizeof(mstudio_rle_anim_t);
+
+		const uint64_t TrackSize = (Header.size > sizeof(mstudio_rle_anim_t)) ? (Header.size - sizeof(mstudio_rle_anim_t)) : 0;
+
+		if (Offset + TrackSize > Size)
+			throw std::exception("Animation section is outside of the stream");
+
+		// this flag does not exist, it tells the decoder not to add the rest position
+		Header.bAdditiveCustom = this->_Additive;
+
+		BoneTrack Track{ Header, BoneFlags, b, (uint16_t*)(Data + Offset) };
+
+		// Each channel follows the previous one, animated positions are 4 shorts, static ones 3 halves,
+		// animated rotations and scales are 2 shorts, static rotations a packed 64bit quaternion and static scales 3 halves
+		Track.Position = Track.Data;
+		Track.Rotation = Track.Position + ((BoneFlags & STUDIO_ANIM_BONEPOS) ? (Header.bAnimPosition ? 4 : 3) : 0);
+		Track.Scale = Track.Rotation + ((BoneFlags & STUDIO_ANIM_BONEROT) ? (Header.bAnimRotation ? 2 : 4) : 0);
+
+		this->_Tracks.Add(Track);
+
+		Offset += TrackSize;
+	}
+
+	this->_SectionData = Data;
+	this->_SectionSize = Offset;
+
+	this->ResolveStaticValues();
+}
+
+void RpakAnimDecoder::ResolveStaticValues()
+{
+	uint32_t HalfCount = 0;
+	uint32_t QuatCount = 0;
+
+	for (auto& Track : this->_Tracks)
+	{
+		if ((Track.Flags & STUDIO_ANIM_BONEPOS) && !Track.Header.bAnimPosition)
+			HalfCount += 3;
+		if ((Track.Flags & STUDIO_ANIM_BONEROT) && !Track.Header.bAnimRotation)
+			QuatCount++;
+		if ((Track.Flags & STUDIO_ANIM_BONESCALE) && !Track.Header.bAnimScale)
+			HalfCount += 3;
+	}
+
+	this->EnsureStatic(HalfCount, QuatCount);
+
+	uint16_t* Halves = this->_StaticHalves.get();
+	uint64_t* Quats = this->_StaticQuats.get();
+
+	for (auto& Track : this->_Tracks)
+	{
+		if ((Track.Flags & STUDIO_ANIM_BONEPOS) && !Track.Header.bAnimPosition)
+		{
+			std::memcpy(Halves, Track.Position, sizeof(uint16_t) * 3);
+			Halves += 3;
+		}
+		if ((Track.Flags & STUDIO_ANIM_BONEROT) && !Track.Header.bAnimRotation)
+		{
+			std::memcpy(Quats, Track.Rotation, sizeof(uint64_t));
+			Quats++;
+		}
+		if ((Track.Flags & STUDIO_ANIM_BONESCALE) && !Track.Header.bAnimScale)
+		{
+			std::memcpy(Halves, Track.Scale, sizeof(uint16_t) * 3);
+			Halves += 3;
+		}
+	}
+
+	Math::Half::ToFloat(this->_StaticHalves.get(), this->_StaticFloats.get(), HalfCount);
+	RTech::UnpackQuat64Batch(this->_StaticQuats.get(), this->_StaticRotations.get(), QuatCount);
+
+	const float* Floats = this->_StaticFloats.get();
+	const Math::Quaternion* Rotations = this->_StaticRotations.get();
+
+	for (auto& Track : this->_Tracks)
+	{
+		if ((Track.Flags & STUDIO_ANIM_BONEPOS) && !Track.Header.bAnimPosition)
+		{
+			std::memcpy(Track.StaticPosition, Floats, sizeof(float) * 3);
+			Floats += 3;
+		}
+		if ((Track.Flags & STUDIO_ANIM_BONEROT) && !Track.Header.bAnimRotation)
+		{
+			Track.StaticRotation = *Rotations;
+			Rotations++;
+		}
+		if ((Track.Flags & STUDIO_ANIM_BONESCALE) && !Track.Header.bAnimScale)
+		{
+			std::memcpy(Track.StaticScale, Floats, sizeof(float) * 3);
+			Floats += 3;
+		}
+	}
+}
+
+void RpakAnimDecoder::ReadSection(IO::Stream* Stream)
+{
+	const uint64_t FlagSize = ((4 * (uint64_t)this->_BoneCount + 7) / 8 + 1) & 0xFFFFFFFFFFFFFFFE;
+
+	this->EnsureBuffer(FlagSize);
+	Stream->Read(this->_Buffer.get(), 0, FlagSize);
+
+	uint64_t Size = FlagSize;
+
+	for (uint32_t b = 0; b < this->_BoneCount; b++)
+	{
+		const uint8_t BoneFlags = (this->_Buffer[b / 2] >> (4 * (b % 2))) & (STUDIO_ANIM_BONEPOS | STUDIO_ANIM_BONEROT | STUDIO_ANIM_BONESCALE);
+
+		if (!BoneFlags)
+			continue;
+
+		this->EnsureBuffer(Size + sizeof(mstudio_rle_anim_t));
+		Stream->Read(this->_Buffer.get(), Size, sizeof(mstudio_rle_anim_t));
+
+		const mstudio_rle_anim_t Header = *(mstudio_rle_anim_t*)(this->_Buffer.get() + Size);
+		const uint64_t TrackSize = (Header.size > sizeof(mstudio_rle_anim_t)) ? (Header.size - sizeof(mstudio_rle_anim_t)) : 0;
+
+		Size += sizeof(mstudio_rle_anim_t);
+
+		this->EnsureBuffer(Size + TrackSize);
+		Stream->Read(this->_Buffer.get(), Size, TrackSize);
+
+		Size += TrackSize;
+	}
+
+	this->ResolveSection(this->_Buffer.get(), Size);
+}
+
+void RpakAnimDecoder::DecodeSection(const RpakAnimSection& Section)
+{
+#ifdef LEGION_ANIM_CAPTURE
+	if (this->_Capture)
+	{
+		this->_Capture->Write<RpakAnimSection>(Section);
+		this->_Capture->Write<uint64_t>(this->_SectionSize);
+		this->_Capture->Write(this->_SectionData, 0, this->_SectionSize);
+	}
+#endif
+
+	this->EnsureScratch(Section.FrameCount);
+
+	// Each channel is decoded for the whole run before moving on, so it's frames are written in order
+	for (auto& Track : this->_Tracks)
+	{
+		if (Track.Flags & STUDIO_ANIM_BONEPOS)
+			this->DecodePositions(Track, Section);
+		if (Track.Flags & STUDIO_ANIM_BONEROT)
+			this->DecodeRotations(Track, Section);
+		if (Track.Flags & STUDIO_ANIM_BONESCALE)
+			this->DecodeScales(Track, Section);
+	}
+}
+
+// Same as CalcBonePosition, for every frame of the run
+void RpakAnimDecoder::DecodePositions(const BoneTrack& Track, const RpakAnimSection& Section)
+{
+	auto& Tracks = this->_Anim.Tracks;
+
+	float* Results[] =
+	{
+		Tracks.Track(Assets::AnimationTrackComponent::TranslateX, Track.BoneIndex) + Section.FirstFrame,
+		Tracks.Track(Assets::AnimationTrackComponent::TranslateY, Track.BoneIndex) + Section.FirstFrame,
+		Tracks.Track(Assets::AnimationTrackComponent::TranslateZ, Track.BoneIndex) + Section.FirstFrame
+	};
+
+	if (!Track.Header.bAnimPosition)
+	{
+		for (uint32_t i = 0; i < 3; i++)
+			std::fill_n(Results[i], Section.FrameCount, Track.StaticPosition[i]);
+	}
+	else
+	{
+		uint16_t TranslationFlags = Track.Position[2];
+		float TranslationScale = *(float*)Track.Position;
+
+		uint8_t* TranslationDataX = (uint8_t*)Track.Position + (TranslationFlags & 0x1FFF) + 4;
+
+		uint8_t* DataPtrs[] = { TranslationDataX, &TranslationDataX[2 * (uint64_t)*((uint8_t*)Track.Position + 6)], &TranslationDataX[2 * (uint64_t)*((uint8_t*)Track.Position + 7)] };
+
+		const Math::Vector3& Bone = this->_Anim.Bones[Track.BoneIndex].LocalPosition();
+		const float Rest[3]{ Bone.X, Bone.Y, Bone.Z };
+
+		float* Values = this->_Scratch.get();
+		float* NextValues = Values + this->_ScratchFrames;
+
+		const float Time = 0;
+
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			if (!(TranslationFlags & (1 << (15 - i))))
+			{
+				std::fill_n(Results[i], Section.FrameCount, Rest[i]);
+				continue;
+			}
+
+			RTech::ExtractAnimValues(Section.FirstSectionFrame, Section.FrameCount, DataPtrs[i], TranslationScale, Values, NextValues);
+
+			if (Track.Header.bAdditiveCustom)
+			{
+				for (uint32_t f = 0; f < Section.FrameCount; f++)
+					Results[i][f] = (float)((float)((float)(1.0 - Time) * Values[f]) + (float)(NextValues[f] * Time));
+			}
+			else
+			{
+				for (uint32_t f = 0; f < Section.FrameCount; f++)
+					Results[i][f] = (float)((float)((float)(1.0 - Time) * Values[f]) + (float)(NextValues[f] * Time)) + Rest[i];
+			}
+		}
+	}
+
+	Tracks.MarkChannels(Track.BoneIndex, Section.FirstFrame, Section.FrameCount, Assets::AnimationTrackChannel::Translation);
+}
+
+// Same as CalcBoneQuaternion, for every frame of the run
+void RpakAnimDecoder::DecodeRotations(const BoneTrack& Track, const RpakAnimSection& Section)
+{
+	auto& Tracks = this->_Anim.Tracks;
+
+	float* Results[] =
+	{
+		Tracks.Track(Assets::AnimationTrackComponent::RotateX, Track.BoneIndex) + Section.FirstFrame,
+		Tracks.Track(Assets::AnimationTrackComponent::RotateY, Track.BoneIndex) + Section.FirstFrame,
+		Tracks.Track(Assets::AnimationTrackComponent::RotateZ, Track.BoneIndex) + Section.FirstFrame,
+		Tracks.Track(Assets::AnimationTrackComponent::RotateW, Track.BoneIndex) + Section.FirstFrame
+	};
+
+	if (!Track.Header.bAnimRotation)
+	{
+		std::fill_n(Results[0], Section.FrameCount, Track.StaticRotation.X);
+		std::fill_n(Results[1], Section.FrameCount, Track.StaticRotation.Y);
+		std::fill_n(Results[2], Section.FrameCount, Track.StaticRotation.Z);
+		std::fill_n(Results[3], Section.FrameCount, Track.StaticRotation.W);
+	}
+	else
+	{
+		const mstudioanim_valueptr_t* animValuePtr = reinterpret_cast<const mstudioanim_valueptr_t*>(Track.Rotation);
+
+		mstudioanimvalue_t* pAnimValues = reinterpret_cast<mstudioanimvalue_t*>((uint8_t*)Track.Rotation + animValuePtr->offset);
+
+		uint8_t* DataPtrs[] = { (uint8_t*)pAnimValues, (uint8_t*)&pAnimValues[animValuePtr->axisIdx1], (uint8_t*)&pAnimValues[animValuePtr->axisIdx2] };
+
+		Math::Vector3 BoneRotation = this->_Anim.Bones[Track.BoneIndex].LocalRotation().ToEulerAngles();
+
+		const float Rest[3]{ Math::MathHelper::DegreesToRadians(BoneRotation.X), Math::MathHelper::DegreesToRadians(BoneRotation.Y), Math::MathHelper::DegreesToRadians(BoneRotation.Z) };
+
+		// The euler angles of every frame, followed by the next values which aren't used
+		float* Angles[] = { this->_Scratch.get(), this->_Scratch.get() + this->_ScratchFrames, this->_Scratch.get() + this->_ScratchFrames * 2 };
+		float* NextValues = this->_Scratch.get() + this->_ScratchFrames * 3;
+
+		const uint16_t RotationFlags = *(uint16_t*)Track.Rotation;
+
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			if (RotationFlags & (1 << (15 - i)))
+				RTech::ExtractAnimValues(Section.FirstSectionFrame, Section.FrameCount, DataPtrs[i], 0.00019175345f, Angles[i], NextValues);
+			else
+				std::fill_n(Angles[i], Section.FrameCount, Rest[i]);
+		}
+
+		for (uint32_t f = 0; f < Section.FrameCount; f++)
+		{
+			Vector3 EulerResult = { Angles[0][f], Angles[1][f], Angles[2][f] };
+			Math::Quaternion Result;
+
+			RTech::AngleQuaternion(EulerResult, Result);
+
+			Results[0][f] = Result.X;
+			Results[1][f] = Result.Y;
+			Results[2][f] = Result.Z;
+			Results[3][f] = Result.W;
+		}
+	}
+
+	Tracks.MarkChannels(Track.BoneIndex, Section.FirstFrame, Section.FrameCount, Assets::AnimationTrackChannel::Rotation);
+}
+
+// Same as CalcBoneScale, for every frame of the run
+void RpakAnimDecoder::DecodeScales(const BoneTrack& Track, const RpakAnimSection& Section)
+{
+	auto& Tracks = this->_Anim.Tracks;
+
+	float* Results[] =
+	{
+		Tracks.Track(Assets::AnimationTrackComponent::ScaleX, Track.BoneIndex) + Section.FirstFrame,
+		Tracks.Track(Assets::AnimationTrackComponent::ScaleY, Track.BoneIndex) + Section.FirstFrame,
+		Tracks.Track(Assets::AnimationTrackComponent::ScaleZ, Track.BoneIndex) + Section.FirstFrame
+	};
+
+	if (!Track.Header.bAnimScale)
+	{
+		for (uint32_t i = 0; i < 3; i++)
+			std::fill_n(Results[i], Section.FrameCount, Track.StaticScale[i]);
+	}
+	else
+	{
+		const mstudioanim_valueptr_t* animValuePtr = reinterpret_cast<const mstudioanim_valueptr_t*>(Track.Scale);
+
+		mstudioanimvalue_t* pAnimValues = reinterpret_cast<mstudioanimvalue_t*>((uint8_t*)Track.Scale + animValuePtr->offset);
+
+		uint8_t* DataPtrs[] = { (uint8_t*)pAnimValues, (uint8_t*)&pAnimValues[animValuePtr->axisIdx1], (uint8_t*)&pAnimValues[animValuePtr->axisIdx2] };
+
+		const Math::Vector3& BoneScale = this->_Anim.Bones[Track.BoneIndex].Scale();
+		const float Rest[3]{ BoneScale.X, BoneScale.Y, BoneScale.Z };
+
+		float* Values = this->_Scratch.get();
+		float* NextValues = Values + this->_ScratchFrames;
+
+		const uint16_t ScaleFlags = *(uint16_t*)Track.Scale;
+
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			if (!(ScaleFlags & (1 << (15 - i))))
+			{
+				std::fill_n(Results[i], Section.FrameCount, Rest[i]);
+				continue;
+			}
+
+			RTech::ExtractAnimValues(Section.FirstSectionFrame, Section.FrameCount, DataPtrs[i], 0.0030518509f, Values, NextValues);
+
+			for (uint32_t f = 0; f < Section.FrameCount; f++)
+				Results[i][f] = (float)((float)((float)(1.0 - 0) * Values[f]) + (float)(NextValues[f] * 0)) + Rest[i];
+		}
+	}
+
+	Tracks.MarkChannels(Track.BoneIndex, Section.FirstFrame, Section.FrameCount, Assets::AnimationTrackChannel::Scale);
+}
+
+#ifdef LEGION_ANIM_CAPTURE
+void RpakAnimDecoder::BeginCapture(const string& Path, const RpakAnimLayout& Layout)
+{
+	this->_Capture = std::make_unique<IO::BinaryWriter>(IO::File::Create(Path));
+
+	this->_Capture->Write<uint32_t>(AnimCaptureMagic);
+	this->_Capture->Write<uint32_t>(AnimCaptureVersion);
+	this->_Capture->Write<RpakAnimLayout>(Layout);
+	this->_Capture->Write<uint8_t>(this->_Additive);
+	this->_Capture->Write<uint32_t>(this->_BoneCount);
+
+	for (uint32_t b = 0; b < this->_BoneCount; b++)
+	{
+		auto& Bone = this->_Anim.Bones[b];
+
+		this->_Capture->WriteCString(Bone.Name());
+		this->_Capture->Write<int32_t>(Bone.Parent());
+		this->_Capture->Write<Math::Vector3>(Bone.LocalPosition());
+		this->_Capture->Write<Math::Quaternion>(Bone.LocalRotation());
+	}
+}
+#endif
+
+void RpakAnimDecoder::EnsureBuffer(uint64_t Size)
+{
+	if (Size <= this->_BufferSize)
+		return;
+
+	uint64_t NewSize = max(Size, this->_BufferSize * 2);
+	auto NewBuffer = std::make_unique<uint8_t[]>(NewSize);
+
+	if (this->_Buffer)
+		std::memcpy(NewBuffer.get(), this->_Buffer.get(), this->_BufferSize);
+
+	this->_Buffer = std::move(NewBuffer);
+	this->_BufferSize = NewSize;
+}
+
+void RpakAnimDecoder::EnsureStatic(uint32_t HalfCount, uint32_t QuatCount)
+{
+	if (HalfCount > this->_StaticHalfCapacity)
+	{
+		this->_StaticHalves = std::make_unique<uint16_t[]>(HalfCount);
+		this->_StaticFloats = std::make_unique<float[]>(HalfCount);
+		this->_StaticHalfCapacity = HalfCount;
+	}
+
+	if (QuatCount > this->_StaticQuatCapacity)
+	{
+		this->_StaticQuats = std::make_unique<uint64_t[]>(QuatCount);
+		this->_StaticRotations = std::make_unique<Math::Quaternion[]>(QuatCount);
+		this->_StaticQuatCapacity = QuatCount;
+	}
+}
+
+void RpakAnimDecoder::EnsureScratch(uint32_t FrameCount)
+{
+	if (FrameCount <= this->_ScratchFrames)
+		return;
+
+	// Three components and the next values
+	this->_Scratch = std::make_unique<float[]>((uint64_t)FrameCount * 4);
+	this->_ScratchFrames = FrameCount;
+}
+
+// CalcBonePosition - 0x1401C97B0 - CL456479
+void RpakAnimDecoder::CalcBonePosition(const mstudio_rle_anim_t& pAnim, uint16_t** BoneTrackData, uint32_t BoneIndex, uint32_t Frame, uint32_t FrameIndex)
+{
+	uint16_t* TranslationDataPtr = *BoneTrackData;
+
+	if (!pAnim.bAnimPosition)
+	{
+		// TranslateX/Y/Z
+		this->_Anim.Tracks.SetTranslation(BoneIndex, FrameIndex, Math::Half(TranslationDataPtr[0]).ToFloat(), Math::Half(TranslationDataPtr[1]).ToFloat(), Math::Half(TranslationDataPtr[2]).ToFloat());
+
+		*BoneTrackData += 3;	// Advance over the size of the data
+	}
+	else
+	{
+		uint16_t TranslationFlags = TranslationDataPtr[2];
+		float TranslationScale = *(float*)TranslationDataPtr;
+
+		uint8_t* TranslationDataX = (uint8_t*)TranslationDataPtr + (TranslationFlags & 0x1FFF) + 4;	// Data for x
+
+		uint64_t DataYOffset = *((uint8_t*)TranslationDataPtr + 6);
+		uint64_t DataZOffset = *((uint8_t*)TranslationDataPtr + 7);
+
+		uint8_t* TranslationDataY = &TranslationDataX[2 * DataYOffset];	// Data for y
+		uint8_t* TranslationDataZ = &TranslationDataX[2 * DataZOffset];	// Data for z
+
+		const Math::Vector3& Bone = this->_Anim.Bones[BoneIndex].LocalPosition();
+
+		float Result[3]{ Bone.X, Bone.Y, Bone.Z };
+
+		uint32_t TranslationIndex = 0;
+		uint32_t v32 = 0xF;
+
+		uint8_t* dataPtrs[] = { TranslationDataX,TranslationDataY,TranslationDataZ };
+
+		float TranslationFinal = 0, TimeScale = 0; // might not be TimeScale
+		float Time = 0;	// time but doesn't matter
+		do
+		{
+			// 0x1401C9AA4 - CL456479
+			if (_bittest((const long*)&TranslationFlags, v32))
+			{
+				RTech::ExtractAnimValue(Frame, dataPtrs[TranslationIndex], TranslationScale, &TranslationFinal, &TimeScale);
+
+				if (pAnim.bAdditiveCustom)
+					Result[TranslationIndex] = (float)((float)((float)(1.0 - Time) * TranslationFinal) + (float)(TimeScale * Time));
+				else
+					Result[TranslationIndex] = (float)((float)((float)(1.0 - Time) * TranslationFinal) + (float)(TimeScale * Time)) + Result[TranslationIndex];
+			}
+
+			--v32;
+			++TranslationIndex;
+		} while (TranslationIndex < 3);
+
+		// TranslateX/Y/Z
+		this->_Anim.Tracks.SetTranslation(BoneIndex, FrameIndex, Result[0], Result[1], Result[2]);
+
+		*BoneTrackData += 4;	// Advance over the size of the data
+	}
+}
+
+void RpakAnimDecoder::CalcBoneQuaternion(const mstudio_rle_anim_t& pAnim, uint16_t** BoneTrackData, uint32_t BoneIndex, uint32_t Frame, uint32_t FrameIndex)
+{
+	uint16_t* RotationDataPtr = *BoneTrackData;
+
+	struct Quat64
+	{
+		uint64_t X : 21;
+		uint64_t Y : 21;
+		uint64_t Z : 21;
+		uint64_t WNeg : 1;
+	};
+
+	if (!pAnim.bAnimRotation)
+	{
+		Quat64 PackedQuat = *(Quat64*)RotationDataPtr;
+
+		Math::Quaternion Quat;
+
+		Quat.X = ((int)PackedQuat.X - 0x100000) * (1 / 1048576.5f);
+		Quat.Y = ((int)PackedQuat.Y - 0x100000) * (1 / 1048576.5f);
+		Quat.Z = ((int)PackedQuat.Z - 0x100000) * (1 / 1048576.5f);
+		Quat.W = std::sqrt(1 - Quat.X * Quat.X - Quat.Y * Quat.Y - Quat.Z * Quat.Z);
+
+		if (PackedQuat.WNeg)
+			Quat.W = -Quat.W;
+
+		// RotateQuaternion
+		this->_Anim.Tracks.SetRotation(BoneIndex, FrameIndex, Quat);
+
+		*BoneTrackData += 4; // Advance over the size of the data
+	}
+	else
+	{
+		mstudioanim_valueptr_t* animValuePtr = *reinterpret_cast<mstudioanim_valueptr_t**>(BoneTrackData);
+
+		mstudioanimvalue_t* pAnimValues = reinterpret_cast<mstudioanimvalue_t*>((uint8_t*)RotationDataPtr + animValuePtr->offset); // Data for x
+
+		// index into anim values array for the second and third axes. these axes are not necessarily y,z because:
+		// if only x,z flags are set, offset will point to data for X, axisIndex1 will point to data for Z
+		uint8_t axisIndex1 = animValuePtr->axisIdx1;
+		uint8_t axisIndex2 = animValuePtr->axisIdx2;
+
+		// get actual animvalue pointers from index
+		mstudioanimvalue_t* pAnimValues_Axis1 = &pAnimValues[axisIndex1];
+		mstudioanimvalue_t* pAnimValues_Axis2 = &pAnimValues[axisIndex2];
+
+		Math::Vector3 BoneRotation = this->_Anim.Bones[BoneIndex].LocalRotation().ToEulerAngles();
+
+		Vector3 EulerResult = { Math::MathHelper::DegreesToRadians(BoneRotation.X),Math::MathHelper::DegreesToRadians(BoneRotation.Y),Math::MathHelper::DegreesToRadians(BoneRotation.Z) };
+
+		uint8_t* dataPtrs[] = { (uint8_t*)pAnimValues,(uint8_t*)pAnimValues_Axis1,(uint8_t*)pAnimValues_Axis2 };
+
+		// this loop is weird. the game does this slightly differently, so i'm not sure how this even functions
+		float v1 = 0, v2 = 0;
+		for(int i = 0; i < 3; ++i)
+		{
+			if (_bittest((const long*)animValuePtr, 15 - i))
+			{
+				RTech::ExtractAnimValue(Frame, dataPtrs[i], 0.00019175345f, &v1, &v2);
+				EulerResult[i] = v1;
+			}
+		};
+
+		Math::Quaternion Result;
+
+		RTech::AngleQuaternion(EulerResult, Result);
+
+		// RotateQuaternion
+		this->_Anim.Tracks.SetRotation(BoneIndex, FrameIndex, Result);
+
+		*BoneTrackData += 2; // Advance over the size of the data
+	}
+}
+
+void RpakAnimDecoder::CalcBoneScale(const mstudio_rle_anim_t& pAnim, uint16_t** BoneTrackData, uint32_t BoneIndex, uint32_t Frame, uint32_t FrameIndex)
+{
+	uint16_t* ScaleDataPtr = *BoneTrackData;
+
+	if (!pAnim.bAnimScale)
+	{
+		// ScaleX/Y/Z
+		this->_Anim.Tracks.SetScale(BoneIndex, FrameIndex, Math::Half(ScaleDataPtr[0]).ToFloat(), Math::Half(ScaleDataPtr[1]).ToFloat(), Math::Half(ScaleDataPtr[2]).ToFloat());
+
+		*BoneTrackData += 3; // Advance over the size of the data
+	}
+	else
+	{
+		mstudioanim_valueptr_t* animValuePtr = *reinterpret_cast<mstudioanim_valueptr_t**>(BoneTrackData);
+
+		mstudioanimvalue_t* pAnimValues = reinterpret_cast<mstudioanimvalue_t*>((uint8_t*)ScaleDataPtr + animValuePtr->offset); // Data for x
+
+		// index into anim values array for the second and third axes. these axes are not necessarily y,z because:
+		// if only x,z flags are set, offset will point to data for X, axisIndex1 will point to data for Z
+		uint8_t axisIndex1 = animValuePtr->axisIdx1;
+		uint8_t axisIndex2 = animValuePtr->axisIdx2;
+
+		// get actual animvalue pointers from index
+		mstudioanimvalue_t* pAnimValues_Axis1 = &pAnimValues[axisIndex1];
+		mstudioanimvalue_t* pAnimValues_Axis2 = &pAnimValues[axisIndex2];
+
+		const Math::Vector3& BoneScale = this->_Anim.Bones[BoneIndex].Scale();
+
+		float Result[3]{ BoneScale.X, BoneScale.Y, BoneScale.Z };
+
+		uint8_t* dataPtrs[] = { (uint8_t*)pAnimValues,(uint8_t*)pAnimValues_Axis1,(uint8_t*)pAnimValues_Axis2 };
+
+		// this loop is weird. the game does this slightly differently, so i'm not sure how this even functions
+		float v1 = 0, v2 = 0;
+		for (int i = 0; i < 3; ++i)
+		{
+			if (_bittest((const long*)animValuePtr, 15 - i))
+			{
+				RTech::ExtractAnimValue(Frame, dataPtrs[i], 0.0030518509f, &v1, &v2);
+				Result[i] = (float)((float)((float)(1.0 - 0) * v1) + (float)(v2 * 0)) + Result[i];
+			}
+		};
+
+		// Scale X/Y/Z
+		this->_Anim.Tracks.SetScale(BoneIndex, FrameIndex, Result[0], Result[1], Result[2]);
+
+		*BoneTrackData += 2; // Advance over the size of the data
+	}
+}
@@ -9,6 +9,7 @@
 #include "Texture.h"
 #include "Model.h"
 #include "BinaryReader.h"
+#include "ParallelTask.h"
 
 // Asset export formats
 #include "CoDXAssetExport.h"
@@ -26,40 +27,144 @@
 #include "RpakImageTiles.h"
 
 RpakFile::RpakFile()
-	: SegmentData(nullptr), StartSegmentIndex(0), SegmentDataSize(0), PatchData(nullptr), PatchDataSize(0), Version(RpakGameVersion::Apex), EmbeddedStarpakOffset(0), EmbeddedStarpakSize(0)
+	: SegmentBuffer(nullptr), MappedFile(nullptr), SegmentData(nullptr), StartSegmentIndex(0), SegmentDataSize(0), PatchData(nullptr), PatchDataSize(0), Version(RpakGameVersion::Apex), EmbeddedStarpakOffset(0), EmbeddedStarpakSize(0)
 {
 }
 
 RpakLib::RpakLib()
-	: LoadedFileIndex(0), ImageExtension(".dds"), ImageSaveType(Assets::SaveFileType::Dds)
+	: ImageExtension(".dds"), ImageSaveType(Assets::SaveFileType::Dds)
 {
 }
 
 void RpakLib::LoadRpaks(const List<string>& Paths)
 {
+	List<string> ChainPaths;
+
 	for (auto& Rpak : Paths)
 	{
 		// Ignore duplicate files triggered by loading multiple rpaks at once.
-		if (this->LoadedFilePaths.Contains(Rpak))
+		if (this->LoadedFilePaths.Contains(Rpak) || ChainPaths.Contains(Rpak))
 			continue;
 
-		this->LoadRpak(Rpak, false);
+		ChainPaths.EmplaceBack(Rpak);
+	}
+
+	// Every pak is decompressed and parsed on the worker pool along with it's patches,
+	// nothing is written to the loaded files until the chains are merged below.
+	std::vector<std::vector<RpakMountContext>> Chains(ChainPaths.Count());
+	std::atomic<uint32_t> ChainIndex = 0;
+	bool IsFirstLoad = this->LoadedFiles.empty();
+
+	Threading::ParallelTask([this, &ChainPaths, &Chains, &ChainIndex, IsFirstLoad]
+	{
+		uint32_t Index = 0;
 
-		// Copy over to loaded, clear for next file
-		for (auto& Loaded : this->LoadFileQueue)
+		while ((Index = ChainIndex++) < ChainPaths.Count())
 		{
-			this->LoadedFilePaths.EmplaceBack(Loaded);
+			this->MountRpakChain(ChainPaths[Index], false, IsFirstLoad && Index == 0, Chains[Index]);
 		}
-		this->LoadFileQueue.Clear();
+	}, min(ChainPaths.Count(), std::thread::hardware_concurrency()));
+
+	// Merge in the order the paths were given, so patch precedence matches a serial load
+	for (uint32_t i = 0; i < ChainPaths.Count(); i++)
+	{
+		// Already loaded as a patch of a previous pak
+		if (this->LoadedFilePaths.Contains(ChainPaths[i]))
+			continue;
+
+		this->CommitRpakChain(ChainPaths[i], false, Chains[i]);
 	}
 }
 
 void RpakLib::LoadRpak(const string& Path, bool Dump)
 {
-	this->LoadFileQueue.EmplaceBack(Path);
-	uint32_t LoadFileQueue = 0;
+	std::vector<RpakMountContext> Chain;
 
-	while (LoadFileQueue < this->LoadFileQueue.Count() && this->MountRpak(this->LoadFileQueue[LoadFileQueue++], Dump));
+	this->MountRpakChain(Path, Dump, this->LoadedFiles.empty(), Chain);
+	this->CommitRpakChain(Path, Dump, Chain);
+}
+
+void RpakLib::MountRpakChain(const string& Path, bool Dump, bool IsFirstChain, std::vector<RpakMountContext>& Chain)
+{
+	List<string> LoadFileQueue;
+	LoadFileQueue.EmplaceBack(Path);
+
+	for (uint32_t i = 0; i < LoadFileQueue.Count(); i++)
+	{
+		auto& Context = Chain.emplace_back(LoadFileQueue[i], Dump);
+
+		try
+		{
+			if (!this->MountRpak(Context))
+				break;
+		}
+		catch (...)
+		{
+			Context.File = nullptr;
+			Context.Error = std::current_exception();
+			break;
+		}
+
+		// Titanfall paks only follow patches of the first loaded pak,
+		// anything this guesses wrong is mounted while committing instead.
+		if (Context.File->Version != RpakGameVersion::Apex && !(IsFirstChain && i == 0))
+			continue;
+
+		for (auto& PatchPath : Context.PatchPaths)
+		{
+			if (this->LoadedFilePaths.Contains(PatchPath) || LoadFileQueue.Contains(PatchPath))
+				continue;
+
+			LoadFileQueue.EmplaceBack(PatchPath);
+		}
+	}
+}
+
+void RpakLib::CommitRpakChain(const string& Path, bool Dump, std::vector<RpakMountContext>& Chain)
+{
+	List<string> LoadFileQueue;
+	LoadFileQueue.EmplaceBack(Path);
+
+	for (uint32_t i = 0; i < LoadFileQueue.Count(); i++)
+	{
+		const string& QueuedPath = LoadFileQueue[i];
+
+		auto Mounted = std::find_if(Chain.begin(), Chain.end(), [&QueuedPath](const RpakMountContext& Context) { return Context.Path == QueuedPath; });
+
+		// Wasn't mounted ahead of time, do it now
+		if (Mounted == Chain.end())
+		{
+			Chain.emplace_back(QueuedPath, Dump);
+			Mounted = Chain.end() - 1;
+
+			this->MountRpak(*Mounted);
+		}
+
+		if (Mounted->Error)
+			std::rethrow_exception(Mounted->Error);
+		if (!Mounted->File)
+			break;
+
+		RpakFile& File = *this->LoadedFiles.emplace_back(std::move(Mounted->File));
+
+		// Titanfall paks only follow patches of the first loaded pak
+		if (File.Version != RpakGameVersion::Apex && this->LoadedFiles.size() != 1)
+			continue;
+
+		for (auto& PatchPath : Mounted->PatchPaths)
+		{
+			if (this->LoadedFilePaths.Contains(PatchPath) || LoadFileQueue.Contains(PatchPath))
+				continue;
+
+			LoadFileQueue.EmplaceBack(PatchPath);
+		}
+	}
+
+	// Copy over to loaded
+	for (auto& Loaded : LoadFileQueue)
+	{
+		this->LoadedFilePaths.EmplaceBack(Loaded);
+	}
 }
 
 void RpakLib::PatchAssets()
@@ -68,9 +173,9 @@ void RpakLib::PatchAssets()
 	Dictionary<uint64_t, RpakLoadAsset> PatchedStreamAssets;
 
 	// We must load this way...
-	for (uint32_t i = 0; i < this->LoadedFileIndex; i++)
+	for (uint32_t i = 0; i < (uint32_t)this->LoadedFiles.size(); i++)
 	{
-		RpakFile& LoadedFile = this->LoadedFiles[i];
+		RpakFile& LoadedFile = *this->LoadedFiles[i];
 
 		for (auto& Kvp : LoadedFile.AssetHashmap)
 		{
@@ -89,7 +194,7 @@ void RpakLib::PatchAssets()
 					Kvp.second.OptimalStarpakOffset,
 					LoadedFile.Version,
 					Kvp.second.Version,
-					&this->LoadedFiles[i]
+					this->LoadedFiles[i].get()
 				);
 
 				// All assets must follow this patch sequence
@@ -121,12 +226,12 @@ void RpakLib::PatchAssets()
 	// We will attempt to brute force patch assets...
 	for (auto& Kvp : PatchedStreamAssets)
 	{
-		for (uint32_t i = 0; i < this->LoadedFileIndex; i++)
+		for (uint32_t i = 0; i < (uint32_t)this->LoadedFiles.size(); i++)
 		{
 			if (i == Kvp.second.FileIndex)
 				continue;
 
-			RpakFile& File = this->LoadedFiles[i];
+			RpakFile& File = *this->LoadedFiles[i];
 
 			if (File.AssetHashmap.ContainsKey(Kvp.first))
 			{
@@ -146,10 +251,14 @@ void RpakLib::PatchAssets()
 	}
 
 	// Clean up the old cache of assets
-	for (uint32_t i = 0; i < this->LoadedFileIndex; i++)
+	for (uint32_t i = 0; i < (uint32_t)this->LoadedFiles.size(); i++)
 	{
-		this->LoadedFiles[i].AssetHashmap.Clear();
+		this->LoadedFiles[i]->AssetHashmap.Clear();
 	}
+
+	// Assets were added, the name indices are rebuilt on their next use
+	std::lock_guard<std::mutex> Lock(this->AssetNameIndexLock);
+	this->AssetNameIndex.Clear();
 }
 
 //std::unique_ptr<List<ApexAsset>> RpakLib::BuildAssetList(bool Models, bool Anims, bool Images, bool Materials, bool UIImages, bool DataTables)
@@ -163,7 +272,7 @@ std::unique_ptr<List<ApexAsset>> RpakLib::BuildAssetList(const std::array<bool,
 
 		ApexAsset NewAsset;
 		NewAsset.Hash = AssetKvp.first;
-		NewAsset.FileCreatedTime = this->LoadedFiles[Asset.RpakFileIndex].CreatedTime;
+		NewAsset.FileCreatedTime = this->LoadedFiles[Asset.RpakFileIndex]->CreatedTime;
 
 		switch (Asset.AssetType)
 		{
@@ -259,6 +368,57 @@ std::unique_ptr<List<ApexAsset>> RpakLib::BuildAssetList(const std::array<bool,
 	return std::move(Result);
 }
 
+const RpakLoadAsset* RpakLib::FindAssetByName(AssetType_t Type, const string& Name)
+{
+	std::shared_ptr<Dictionary<string, uint64_t>> Index;
+
+	{
+		std::lock_guard<std::mutex> Lock(this->AssetNameIndexLock);
+
+		if (!this->AssetNameIndex.ContainsKey((uint32_t)Type))
+			this->AssetNameIndex.Add((uint32_t)Type, this->BuildAssetNameIndex(Type));
+
+		Index = this->AssetNameIndex[(uint32_t)Type];
+	}
+
+	if (!Index->ContainsKey(Name))
+		return nullptr;
+
+	return &this->Assets[(*Index)[Name]];
+}
+
+std::shared_ptr<Dictionary<string, uint64_t>> RpakLib::BuildAssetNameIndex(AssetType_t Type)
+{
+	auto Index = std::make_shared<Dictionary<string, uint64_t>>();
+
+	for (auto& AssetKvp : Assets)
+	{
+		RpakLoadAsset& Asset = AssetKvp.Value();
+
+		if (Asset.AssetType != (uint32_t)Type)
+			continue;
+
+		string AssetName;
+
+		switch (Type)
+		{
+		case AssetType_t::Model:
+			AssetName = this->ReadModelName(Asset);
+			break;
+		case AssetType_t::Material:
+			AssetName = this->ReadMaterialName(Asset);
+			break;
+		default:
+			continue;
+		}
+
+		// The first asset with a name wins, the same as the lookups built from the asset list
+		Index->Add(IO::Path::GetFileNameWithoutExtension(AssetName).ToLower(), AssetKvp.first);
+	}
+
+	return Index;
+}
+
 void RpakLib::InitializeModelExporter(ModelExportFormat_t Format)
 {
 	switch (Format)
@@ -267,7 +427,7 @@ void RpakLib::InitializeModelExporter(ModelExportFormat_t Format)
 		ModelExporter = std::make_unique<Assets::Exporters::AutodeskMaya>();
 		break;
 	case ModelExportFormat_t::OBJ:
-		ModelExporter = std::make_unique<Assets::Exporters::WavefrontOBJ>();
+		ModelExporter = std::make_unique<Assets::Exporters::WavefrontOBJ>(!ExportManager::Config.GetBool("ObjFlatVertices"));
 		break;
 	case ModelExportFormat_t::XNALaraText:
 		ModelExporter = std::make_unique<Assets::Exporters::XNALaraAscii>();
@@ -334,13 +494,31 @@ void RpakLib::InitializeImageExporter(ImageExportFormat_t Format)
 	}
 
 	m_bImageExporterInitialized = true;
+
+	// Every export starts by picking the image format, so a new export session starts here
+	this->ResetExportCache();
+}
+
+void RpakLib::ResetExportCache()
+{
+	std::lock_guard<std::mutex> CacheLock(this->ExportCacheLock);
+
+	this->ExportedImages.Clear();
+	this->ExportedMaterials.Clear();
+}
+
+void RpakLib::ReleaseStarpakHandles()
+{
+	std::lock_guard<std::mutex> HandleLock(this->StarpakHandleLock);
+
+	this->StarpakHandles.Clear();
 }
 
 std::unique_ptr<IO::MemoryStream> RpakLib::GetFileStream(const RpakLoadAsset& Asset)
 {
-	RpakFile& File = this->LoadedFiles[Asset.FileIndex];
+	RpakFile& File = *this->LoadedFiles[Asset.FileIndex];
 
-	return std::move(std::make_unique<IO::MemoryStream>(File.SegmentData.get(), 0, File.SegmentDataSize, false, true));
+	return std::move(std::make_unique<IO::MemoryStream>(File.SegmentData, 0, File.SegmentDataSize, false, true));
 }
 
 uint64_t RpakLib::GetFileOffset(const RpakLoadAsset& Asset, uint32_t SegmentIndex, uint32_t SegmentOffset)
@@ -362,234 +540,48 @@ uint64_t RpakLib::GetEmbeddedStarpakOffset(const RpakLoadAsset& Asset)
 	return Asset.PakFile->EmbeddedStarpakOffset;
 }
 
-std::unique_ptr<IO::FileStream> RpakLib::GetStarpakStream(const RpakLoadAsset& Asset, bool Optimal)
+std::unique_ptr<IO::Stream> RpakLib::GetStarpakStream(const RpakLoadAsset& Asset, bool Optimal)
 {
-	if (Optimal)
-	{
-		uint64_t OptStarpakIndex = Asset.OptimalStarpakOffset & 0xFF;
-#if _DEBUG
-		//g_Logger.Info("Load starpak: %s\n", this->LoadedFiles[Asset.RpakFileIndex].OptimalStarpakReferences[OptStarpakIndex].ToCString());
-#endif
-		if (!IO::File::Exists(this->LoadedFiles[Asset.RpakFileIndex].OptimalStarpakReferences[OptStarpakIndex]))
-			return nullptr;
-
-		return std::move(IO::File::OpenRead(this->LoadedFiles[Asset.RpakFileIndex].OptimalStarpakReferences[OptStarpakIndex]));
-	}
-	else
-	{
-		uint64_t StarpakPatchIndex = Asset.StarpakOffset & 0xFF;
-#if _DEBUG
-		//g_Logger.Info("Load starpak: %s\n", this->LoadedFiles[Asset.RpakFileIndex].StarpakReferences[StarpakPatchIndex].ToCString());
-#endif
-		if (!IO::File::Exists(this->LoadedFiles[Asset.RpakFileIndex].StarpakReferences[StarpakPatchIndex]))
-			return nullptr;
-		return std::move(IO::File::OpenRead(this->LoadedFiles[Asset.RpakFileIndex].StarpakReferences[StarpakPatchIndex]));
-	}
-}
-
-
-// CalcBonePosition - 0x1401C97B0 - CL456479
-void RpakLib::CalcBonePosition(const mstudio_rle_anim_t& pAnim, uint16_t** BoneTrackData, const std::unique_ptr<Assets::Animation>& Anim, uint32_t BoneIndex, uint32_t Frame, uint32_t FrameIndex)
-{
-	uint16_t* TranslationDataPtr = *BoneTrackData;
-
-	if (!pAnim.bAnimPosition)
-	{
-		List<Assets::Curve>& Curves = Anim->GetNodeCurves(Anim->Bones[BoneIndex].Name());
+	uint32_t StarpakIndex = (uint32_t)((Optimal ? Asset.OptimalStarpakOffset : Asset.StarpakOffset) & 0xFF);
+	uint64_t HandleKey = ((uint64_t)Asset.RpakFileIndex << 32) | ((uint64_t)StarpakIndex << 1) | (Optimal ? 1 : 0);
 
-		// TranslateX/Y/Z
-		Curves[1].Keyframes.EmplaceBack(FrameIndex, Math::Half(TranslationDataPtr[0]).ToFloat());
-		Curves[2].Keyframes.EmplaceBack(FrameIndex, Math::Half(TranslationDataPtr[1]).ToFloat());
-		Curves[3].Keyframes.EmplaceBack(FrameIndex, Math::Half(TranslationDataPtr[2]).ToFloat());
+	std::shared_ptr<IO::RandomAccessFile> Handle = nullptr;
 
-		*BoneTrackData += 3;	// Advance over the size of the data
-	}
-	else
 	{
-		uint16_t TranslationFlags = TranslationDataPtr[2];
-		float TranslationScale = *(float*)TranslationDataPtr;
-
-		uint8_t* TranslationDataX = (uint8_t*)TranslationDataPtr + (TranslationFlags & 0x1FFF) + 4;	// Data for x
-
-		uint64_t DataYOffset = *((uint8_t*)TranslationDataPtr + 6);
-		uint64_t DataZOffset = *((uint8_t*)TranslationDataPtr + 7);
-
-		uint8_t* TranslationDataY = &TranslationDataX[2 * DataYOffset];	// Data for y
-		uint8_t* TranslationDataZ = &TranslationDataX[2 * DataZOffset];	// Data for z
-
-		const Math::Vector3& Bone = Anim->Bones[BoneIndex].LocalPosition();
-
-		float Result[3]{ Bone.X, Bone.Y, Bone.Z };
-
-		uint32_t TranslationIndex = 0;
-		uint32_t v32 = 0xF;	
-
-		uint8_t* dataPtrs[] = { TranslationDataX,TranslationDataY,TranslationDataZ };
+		std::lock_guard<std::mutex> HandleLock(this->StarpakHandleLock);
 
-		float TranslationFinal = 0, TimeScale = 0; // might not be TimeScale
-		float Time = 0;	// time but doesn't matter
-		do
+		if (this->StarpakHandles.ContainsKey(HandleKey))
 		{
-			// 0x1401C9AA4 - CL456479
-			if (_bittest((const long*)&TranslationFlags, v32))
-			{
-				RTech::ExtractAnimValue(Frame, dataPtrs[TranslationIndex], TranslationScale, &TranslationFinal, &TimeScale);
-
-				if (pAnim.bAdditiveCustom)
-					Result[TranslationIndex] = (float)((float)((float)(1.0 - Time) * TranslationFinal) + (float)(TimeScale * Time));
-				else
-					Result[TranslationIndex] = (float)((float)((float)(1.0 - Time) * TranslationFinal) + (float)(TimeScale * Time)) + Result[TranslationIndex];
-			}
-
-			--v32;
-			++TranslationIndex;
-		} while (TranslationIndex < 3);
-
-		List<Assets::Curve>& Curves = Anim->GetNodeCurves(Anim->Bones[BoneIndex].Name());
-
-		// TranslateX/Y/Z
-		Curves[1].Keyframes.EmplaceBack(FrameIndex, Result[0]);
-		Curves[2].Keyframes.EmplaceBack(FrameIndex, Result[1]);
-		Curves[3].Keyframes.EmplaceBack(FrameIndex, Result[2]);
-
-		*BoneTrackData += 4;	// Advance over the size of the data
-	}
-}
-
-void RpakLib::CalcBoneQuaternion(const mstudio_rle_anim_t& pAnim, uint16_t** BoneTrackData, const std::unique_ptr<Assets::Animation>& Anim, uint32_t BoneIndex, uint32_t Frame, uint32_t FrameIndex)
-{
-	uint16_t* RotationDataPtr = *BoneTrackData;
-
-	struct Quat64
-	{
-		uint64_t X : 21;
-		uint64_t Y : 21;
-		uint64_t Z : 21;
-		uint64_t WNeg : 1;
-	};
-
-	if (!pAnim.bAnimRotation)
-	{
-		Quat64 PackedQuat = *(Quat64*)RotationDataPtr;
-
-		Math::Quaternion Quat;
-
-		Quat.X = ((int)PackedQuat.X - 0x100000) * (1 / 1048576.5f);
-		Quat.Y = ((int)PackedQuat.Y - 0x100000) * (1 / 1048576.5f);
-		Quat.Z = ((int)PackedQuat.Z - 0x100000) * (1 / 1048576.5f);
-		Quat.W = std::sqrt(1 - Quat.X * Quat.X - Quat.Y * Quat.Y - Quat.Z * Quat.Z);
-
-		if (PackedQuat.WNeg)
-			Quat.W = -Quat.W;
-
-		// RotateQuaternion
-		Anim->GetNodeCurves(Anim->Bones[BoneIndex].Name())[0].Keyframes.Emplace(FrameIndex, Math::Quaternion(Quat[0], Quat[1], Quat[2], Quat[3]));
-
-		*BoneTrackData += 4; // Advance over the size of the data
-	}
-	else
-	{
-		mstudioanim_valueptr_t* animValuePtr = *reinterpret_cast<mstudioanim_valueptr_t**>(BoneTrackData);
-
-		mstudioanimvalue_t* pAnimValues = reinterpret_cast<mstudioanimvalue_t*>((uint8_t*)RotationDataPtr + animValuePtr->offset); // Data for x
-
-		// index into anim values array for the second and third axes. these axes are not necessarily y,z because:
-		// if only x,z flags are set, offset will point to data for X, axisIndex1 will point to data for Z
-		uint8_t axisIndex1 = animValuePtr->axisIdx1;
-		uint8_t axisIndex2 = animValuePtr->axisIdx2;
-
-		// get actual animvalue pointers from index
-		mstudioanimvalue_t* pAnimValues_Axis1 = &pAnimValues[axisIndex1];
-		mstudioanimvalue_t* pAnimValues_Axis2 = &pAnimValues[axisIndex2];
-
-		Math::Vector3 BoneRotation = Anim->Bones[BoneIndex].LocalRotation().ToEulerAngles();
-
-		Vector3 EulerResult = { Math::MathHelper::DegreesToRadians(BoneRotation.X),Math::MathHelper::DegreesToRadians(BoneRotation.Y),Math::MathHelper::DegreesToRadians(BoneRotation.Z) };
-
-		uint8_t* dataPtrs[] = { (uint8_t*)pAnimValues,(uint8_t*)pAnimValues_Axis1,(uint8_t*)pAnimValues_Axis2 };
-
-		// this loop is weird. the game does this slightly differently, so i'm not sure how this even functions
-		float v1 = 0, v2 = 0;
-		for(int i = 0; i < 3; ++i)
+			Handle = this->StarpakHandles[HandleKey];
+		}
+		else
 		{
-			if (_bittest((const long*)animValuePtr, 15 - i))
-			{
-				RTech::ExtractAnimValue(Frame, dataPtrs[i], 0.00019175345f, &v1, &v2);
-				EulerResult[i] = v1;
-			}
-		};
-
-		Math::Quaternion Result;
-
-		RTech::AngleQuaternion(EulerResult, Result);
+			RpakFile& File = *this->LoadedFiles[Asset.RpakFileIndex];
+			const string& StarpakPath = Optimal ? File.OptimalStarpakReferences[StarpakIndex] : File.StarpakReferences[StarpakIndex];
 
-		Anim->GetNodeCurves(Anim->Bones[BoneIndex].Name())[0].Keyframes.Emplace(FrameIndex, Result);
-
-		*BoneTrackData += 2; // Advance over the size of the data
-	}
-}
-
-void RpakLib::CalcBoneScale(const mstudio_rle_anim_t& pAnim, uint16_t** BoneTrackData, const std::unique_ptr<Assets::Animation>& Anim, uint32_t BoneIndex, uint32_t Frame, uint32_t FrameIndex)
-{
-	uint16_t* ScaleDataPtr = *BoneTrackData;
-
-	if (!pAnim.bAnimScale)
-	{
-		List<Assets::Curve>& Curves = Anim->GetNodeCurves(Anim->Bones[BoneIndex].Name());
-
-		// ScaleX/Y/Z
-		Curves[4].Keyframes.EmplaceBack(FrameIndex, Math::Half(ScaleDataPtr[0]).ToFloat());
-		Curves[5].Keyframes.EmplaceBack(FrameIndex, Math::Half(ScaleDataPtr[1]).ToFloat());
-		Curves[6].Keyframes.EmplaceBack(FrameIndex, Math::Half(ScaleDataPtr[2]).ToFloat());
-
-		*BoneTrackData += 3; // Advance over the size of the data
-	}
-	else
-	{
-		mstudioanim_valueptr_t* animValuePtr = *reinterpret_cast<mstudioanim_valueptr_t**>(BoneTrackData);
-
-		mstudioanimvalue_t* pAnimValues = reinterpret_cast<mstudioanimvalue_t*>((uint8_t*)ScaleDataPtr + animValuePtr->offset); // Data for x
-
-		// index into anim values array for the second and third axes. these axes are not necessarily y,z because:
-		// if only x,z flags are set, offset will point to data for X, axisIndex1 will point to data for Z
-		uint8_t axisIndex1 = animValuePtr->axisIdx1;
-		uint8_t axisIndex2 = animValuePtr->axisIdx2;
-
-		// get actual animvalue pointers from index
-		mstudioanimvalue_t* pAnimValues_Axis1 = &pAnimValues[axisIndex1];
-		mstudioanimvalue_t* pAnimValues_Axis2 = &pAnimValues[axisIndex2];
-
-		const Math::Vector3& BoneScale = Anim->Bones[BoneIndex].Scale();
-
-		float Result[3]{ BoneScale.X, BoneScale.Y, BoneScale.Z };
-
-		uint8_t* dataPtrs[] = { (uint8_t*)pAnimValues,(uint8_t*)pAnimValues_Axis1,(uint8_t*)pAnimValues_Axis2 };
-
-		// this loop is weird. the game does this slightly differently, so i'm not sure how this even functions
-		float v1 = 0, v2 = 0;
-		for (int i = 0; i < 3; ++i)
-		{
-			if (_bittest((const long*)animValuePtr, 15 - i))
+#if _DEBUG
+			//g_Logger.Info("Load starpak: %s\n", StarpakPath.ToCString());
+#endif
+			// Missing starpaks aren't cached, so they're found once they're added
+			if (IO::File::Exists(StarpakPath))
 			{
-				RTech::ExtractAnimValue(Frame, dataPtrs[i], 0.0030518509f, &v1, &v2);
-				Result[i] = (float)((float)((float)(1.0 - 0) * v1) + (float)(v2 * 0)) + Result[i];
+				Handle = IO::RandomAccessFile::OpenRead(StarpakPath);
+				this->StarpakHandles.Add(HandleKey, Handle);
 			}
-		};
-
-		List<Assets::Curve>& Curves = Anim->GetNodeCurves(Anim->Bones[BoneIndex].Name());
+		}
+	}
 
-		// Scale X/Y/Z
-		Curves[4].Keyframes.EmplaceBack(FrameIndex, Result[0]);
-		Curves[5].Keyframes.EmplaceBack(FrameIndex, Result[1]);
-		Curves[6].Keyframes.EmplaceBack(FrameIndex, Result[2]);
+	if (!Handle)
+		return nullptr;
 
-		*BoneTrackData += 2; // Advance over the size of the data
-	}
+	// Each caller gets it's own position, reads don't need the lock
+	return std::make_unique<IO::RandomAccessStream>(std::move(Handle));
 }
 
+
 bool RpakLib::ValidateAssetPatchStatus(const RpakLoadAsset& Asset)
 {
-	auto& LoadedFile = this->LoadedFiles[Asset.FileIndex];
+	auto& LoadedFile = *this->LoadedFiles[Asset.FileIndex];
 
 	if (Asset.SubHeaderIndex >= LoadedFile.StartSegmentIndex)
 	{
@@ -687,22 +679,22 @@ bool RpakLib::ValidateAssetStreamStatus(const RpakLoadAsset& Asset)
 
 	if (Asset.OptimalStarpakOffset != -1 && Asset.OptimalStarpakOffset != 0)
 	{
-		if (!this->LoadedFiles[Asset.RpakFileIndex].OptimalStarpakMap.ContainsKey(Asset.OptimalStarpakOffset))
+		if (!this->LoadedFiles[Asset.RpakFileIndex]->OptimalStarpakMap.ContainsKey(Asset.OptimalStarpakOffset))
 			return false;
 	}
 
 	if (Asset.StarpakOffset != -1 && Asset.StarpakOffset != 0)
 	{
-		if (!this->LoadedFiles[Asset.RpakFileIndex].StarpakMap.ContainsKey(Asset.StarpakOffset))
+		if (!this->LoadedFiles[Asset.RpakFileIndex]->StarpakMap.ContainsKey(Asset.StarpakOffset))
 			return false;
 	}
 
 	return true;
 }
 
-bool RpakLib::MountRpak(const string& Path, bool Dump)
+bool RpakLib::MountRpak(RpakMountContext& Context)
 {
-	IO::BinaryReader Reader = IO::BinaryReader(IO::File::OpenRead(Path));
+	IO::BinaryReader Reader = IO::BinaryReader(IO::File::OpenRead(Context.Path));
 	RpakBaseHeader BaseHeader = Reader.Read<RpakBaseHeader>();
 
 	if (BaseHeader.Magic != 0x6B615052)
@@ -711,22 +703,25 @@ bool RpakLib::MountRpak(const string& Path, bool Dump)
 	switch (BaseHeader.Version)
 	{
 	case (uint32_t)RpakGameVersion::Apex:
-		return this->MountApexRpak(Path, Dump);
+		return this->MountApexRpak(Context);
 	case (uint32_t)RpakGameVersion::Titanfall:
-		return this->MountTitanfallRpak(Path, Dump);
+		return this->MountTitanfallRpak(Context);
 	case (uint32_t)RpakGameVersion::R2TT:
-		return this->MountR2TTRpak(Path, Dump);
+		return this->MountR2TTRpak(Context);
 	default:
 		return false;
 	}
 }
 
-bool RpakLib::ParseApexRpak(const string& RpakPath, std::unique_ptr<IO::MemoryStream>& ParseStream)
+bool RpakLib::ParseApexRpak(RpakMountContext& Context, std::unique_ptr<IO::MemoryStream>& ParseStream, std::unique_ptr<IO::MemoryMappedFile> MappedFile)
 {
 	IO::BinaryReader Reader = IO::BinaryReader(ParseStream.get(), true);
+	const string& RpakPath = Context.Path;
 	string RpakRoot = IO::Path::GetDirectoryName(RpakPath);
 	RpakApexHeader Header = Reader.Read<RpakApexHeader>();
-	RpakFile* File = &this->LoadedFiles[this->LoadedFileIndex++];
+
+	Context.File = std::make_unique<RpakFile>();
+	RpakFile* File = Context.File.get();
 
 	File->CreatedTime = Header.CreatedFileTime;
 	File->Hash = Header.Hash;
@@ -753,7 +748,7 @@ bool RpakLib::ParseApexRpak(const string& RpakPath, std::unique_ptr<IO::MemorySt
 		if (Starpak.Length() > 0)
 		{
 			string Path = IO::Path::Combine(RpakRoot, IO::Path::GetFileName(Starpak));
-			this->MountStarpak(Path, this->LoadedFileIndex - 1, File->StarpakReferences.Count(), false);
+			this->MountStarpak(Path, *File, File->StarpakReferences.Count(), false);
 			File->StarpakReferences.EmplaceBack(Path);
 		}
 
@@ -767,7 +762,7 @@ bool RpakLib::ParseApexRpak(const string& RpakPath, std::unique_ptr<IO::MemorySt
 		if (Starpak.Length() > 0)
 		{
 			string Path = IO::Path::Combine(RpakRoot, IO::Path::GetFileName(Starpak));
-			this->MountStarpak(Path, this->LoadedFileIndex - 1, File->OptimalStarpakReferences.Count(), true);
+			this->MountStarpak(Path, *File, File->OptimalStarpakReferences.Count(), true);
 			File->OptimalStarpakReferences.EmplaceBack(Path);
 		}
 
@@ -813,8 +808,6 @@ bool RpakLib::ParseApexRpak(const string& RpakPath, std::unique_ptr<IO::MemorySt
 		new_index = RTech::PakPatch_DecodeData((char*)File->PatchData.get() + new_index, 8, nullptr, unk_buffer_2, some_buffer_2);
 	}
 
-	uint64_t BufferRemaining = ParseStream->GetLength() - ParseStream->GetPosition();
-
 	uint64_t Offset = Header.PageOffset;
 	for (uint32_t i = PatchHeader.PatchSegmentIndex; i < Header.MemPageCount; i++)
 	{
@@ -828,13 +821,10 @@ bool RpakLib::ParseApexRpak(const string& RpakPath, std::unique_ptr<IO::MemorySt
 	}
 
 	File->StartSegmentIndex = PatchHeader.PatchSegmentIndex;
-	File->SegmentData = std::make_unique<uint8_t[]>(BufferRemaining);
-	File->SegmentDataSize = BufferRemaining;
 	File->EmbeddedStarpakOffset = Header.EmbeddedStarpakOffset - ParseStream->GetPosition();
 	File->EmbeddedStarpakSize = Header.EmbeddedStarpakSize;
 
-	ParseStream->Read(File->SegmentData.get(), 0, BufferRemaining);
-
+	this->LoadSegmentData(File, ParseStream, MappedFile);
 
 	string BasePath = IO::Path::GetDirectoryName(RpakPath);
 	string FileNameNoExt = IO::Path::GetFileNameWithoutExtension(RpakPath);
@@ -850,21 +840,21 @@ bool RpakLib::ParseApexRpak(const string& RpakPath, std::unique_ptr<IO::MemorySt
 		uint16_t PatchIndexToFile = PatchIndicesToFile[i];
 		string AdditionalRpakToLoad = string::Format(PatchIndexToFile == 0 ? "%s.rpak" : "%s(%02d).rpak", FinalPath.ToCString(), PatchIndexToFile);
 
-		if (this->LoadedFilePaths.Contains(AdditionalRpakToLoad) || this->LoadFileQueue.Contains(AdditionalRpakToLoad))
-			continue;
-		
-		this->LoadFileQueue.EmplaceBack(AdditionalRpakToLoad);
+		Context.PatchPaths.EmplaceBack(AdditionalRpakToLoad);
 	}
 
 	return true;
 }
 
-bool RpakLib::ParseTitanfallRpak(const string& RpakPath, std::unique_ptr<IO::MemoryStream>& ParseStream)
+bool RpakLib::ParseTitanfallRpak(RpakMountContext& Context, std::unique_ptr<IO::MemoryStream>& ParseStream, std::unique_ptr<IO::MemoryMappedFile> MappedFile)
 {
 	IO::BinaryReader Reader = IO::BinaryReader(ParseStream.get(), true);
+	const string& RpakPath = Context.Path;
 	string RpakRoot = IO::Path::GetDirectoryName(RpakPath);
 	RpakTitanfallHeader Header = Reader.Read<RpakTitanfallHeader>();
-	RpakFile* File = &this->LoadedFiles[this->LoadedFileIndex++];
+
+	Context.File = std::make_unique<RpakFile>();
+	RpakFile* File = Context.File.get();
 
 	File->CreatedTime = Header.CreatedFileTime;
 	File->Hash = Header.Hash;
@@ -891,7 +881,7 @@ bool RpakLib::ParseTitanfallRpak(const string& RpakPath, std::unique_ptr<IO::Mem
 		if (Starpak.Length() > 0)
 		{
 			string Path = IO::Path::Combine(RpakRoot, IO::Path::GetFileName(Starpak));
-			this->MountStarpak(Path, this->LoadedFileIndex - 1, File->StarpakReferences.Count(), false);
+			this->MountStarpak(Path, *File, File->StarpakReferences.Count(), false);
 			File->StarpakReferences.EmplaceBack(Path);
 		}
 
@@ -937,8 +927,6 @@ bool RpakLib::ParseTitanfallRpak(const string& RpakPath, std::unique_ptr<IO::Mem
 		ParseStream->Read(File->PatchData.get(), 0, PatchHeader.PatchDataSize);
 	}
 
-	uint64_t BufferRemaining = ParseStream->GetLength() - ParseStream->GetPosition();
-
 	uint64_t Offset = 0;
 	for (uint32_t i = PatchHeader.PatchSegmentIndex; i < Header.MemPageCount; i++)
 	{
@@ -957,41 +945,40 @@ bool RpakLib::ParseTitanfallRpak(const string& RpakPath, std::unique_ptr<IO::Mem
 		File->AssetHashmap.Add(Asset.NameHash, NewAsset);
 	}
 	File->StartSegmentIndex = PatchHeader.PatchSegmentIndex;
-	File->SegmentData = std::make_unique<uint8_t[]>(BufferRemaining);
-	File->SegmentDataSize = BufferRemaining;
 
-	ParseStream->Read(File->SegmentData.get(), 0, BufferRemaining);
+	this->LoadSegmentData(File, ParseStream, MappedFile);
 
-	if (this->LoadedFileIndex == 1)
-	{
-		string BasePath = IO::Path::GetDirectoryName(RpakPath);
-		string FileNameNoExt = IO::Path::GetFileNameWithoutExtension(RpakPath);
+	// Whether or not these are followed is decided when the chain is committed
+	string BasePath = IO::Path::GetDirectoryName(RpakPath);
+	string FileNameNoExt = IO::Path::GetFileNameWithoutExtension(RpakPath);
 
-		// Trim off the () if exists
-		if (FileNameNoExt.Contains("("))
-			FileNameNoExt = FileNameNoExt.Substring(0, FileNameNoExt.IndexOf("("));
+	// Trim off the () if exists
+	if (FileNameNoExt.Contains("("))
+		FileNameNoExt = FileNameNoExt.Substring(0, FileNameNoExt.IndexOf("("));
 
-		string FinalPath = IO::Path::Combine(BasePath, FileNameNoExt);
+	string FinalPath = IO::Path::Combine(BasePath, FileNameNoExt);
 
-		for (uint32_t i = 0; i < Header.PatchIndex; i++)
-		{
-			uint16_t PatchIndexToFile = PatchIndicesToFile[i];
-			if (PatchIndexToFile == 0)
-				this->LoadFileQueue.EmplaceBack(string::Format("%s.rpak", FinalPath.ToCString()));
-			else
-				this->LoadFileQueue.EmplaceBack(string::Format("%s(%02d).rpak", FinalPath.ToCString(), PatchIndexToFile));
-		}
+	for (uint32_t i = 0; i < Header.PatchIndex; i++)
+	{
+		uint16_t PatchIndexToFile = PatchIndicesToFile[i];
+		if (PatchIndexToFile == 0)
+			Context.PatchPaths.EmplaceBack(string::Format("%s.rpak", FinalPath.ToCString()));
+		else
+			Context.PatchPaths.EmplaceBack(string::Format("%s(%02d).rpak", FinalPath.ToCString(), PatchIndexToFile));
 	}
 
 	return true;
 }
 
-bool RpakLib::ParseR2TTRpak(const string& RpakPath, std::unique_ptr<IO::MemoryStream>& ParseStream)
+bool RpakLib::ParseR2TTRpak(RpakMountContext& Context, std::unique_ptr<IO::MemoryStream>& ParseStream, std::unique_ptr<IO::MemoryMappedFile> MappedFile)
 {
 	IO::BinaryReader Reader = IO::BinaryReader(ParseStream.get(), true);
+	const string& RpakPath = Context.Path;
 	string RpakRoot = IO::Path::GetDirectoryName(RpakPath);
 	RpakHeaderV6 Header = Reader.Read<RpakHeaderV6>();
-	RpakFile* File = &this->LoadedFiles[this->LoadedFileIndex++];
+
+	Context.File = std::make_unique<RpakFile>();
+	RpakFile* File = Context.File.get();
 
 	File->CreatedTime = Header.CreatedFileTime;
 	File->Hash = Header.Hash;
@@ -1007,7 +994,7 @@ bool RpakLib::ParseR2TTRpak(const string& RpakPath, std::unique_ptr<IO::MemorySt
 		if (Starpak.Length() > 0)
 		{
 			string Path = IO::Path::Combine(RpakRoot, IO::Path::GetFileName(Starpak));
-			this->MountStarpak(Path, this->LoadedFileIndex - 1, File->StarpakReferences.Count(), false);
+			this->MountStarpak(Path, *File, File->StarpakReferences.Count(), false);
 			File->StarpakReferences.EmplaceBack(Path);
 		}
 
@@ -1042,8 +1029,6 @@ bool RpakLib::ParseR2TTRpak(const string& RpakPath, std::unique_ptr<IO::MemorySt
 	ParseStream->Seek(sizeof(uint32_t) * Header.UnknownSeventhBlockCount, IO::SeekOrigin::Current);
 	ParseStream->Seek(Header.UnknownEighthBlockCount, IO::SeekOrigin::Current);
 
-	uint64_t BufferRemaining = ParseStream->GetLength() - ParseStream->GetPosition();
-
 	uint64_t Offset = 0;
 	for (uint32_t i = 0; i < Header.MemPageCount; i++)
 	{
@@ -1062,32 +1047,26 @@ bool RpakLib::ParseR2TTRpak(const string& RpakPath, std::unique_ptr<IO::MemorySt
 		File->AssetHashmap.Add(Asset.NameHash, NewAsset);
 	}
 	File->StartSegmentIndex = 0;
-	File->SegmentData = std::make_unique<uint8_t[]>(BufferRemaining);
-	File->SegmentDataSize = BufferRemaining;
 
-	ParseStream->Read(File->SegmentData.get(), 0, BufferRemaining);
+	this->LoadSegmentData(File, ParseStream, MappedFile);
 
-	if (this->LoadedFileIndex == 1)
-	{
-		string BasePath = IO::Path::GetDirectoryName(RpakPath);
-		string FileNameNoExt = IO::Path::GetFileNameWithoutExtension(RpakPath);
+	// Whether or not this is followed is decided when the chain is committed
+	string BasePath = IO::Path::GetDirectoryName(RpakPath);
+	string FileNameNoExt = IO::Path::GetFileNameWithoutExtension(RpakPath);
 
-		// Trim off the () if exists
-		if (FileNameNoExt.Contains("("))
-			FileNameNoExt = FileNameNoExt.Substring(0, FileNameNoExt.IndexOf("("));
+	// Trim off the () if exists
+	if (FileNameNoExt.Contains("("))
+		FileNameNoExt = FileNameNoExt.Substring(0, FileNameNoExt.IndexOf("("));
 
-		string FinalPath = IO::Path::Combine(BasePath, FileNameNoExt);
+	string FinalPath = IO::Path::Combine(BasePath, FileNameNoExt);
 
-		this->LoadFileQueue.EmplaceBack(string::Format("%s.rpak", FinalPath.ToCString()));
-	}
+	Context.PatchPaths.EmplaceBack(string::Format("%s.rpak", FinalPath.ToCString()));
 
 	return true;
 }
 
-void RpakLib::MountStarpak(const string& Path, uint32_t FileIndex, uint32_t StarpakIndex, bool Optimal)
+void RpakLib::MountStarpak(const string& Path, RpakFile& File, uint32_t StarpakIndex, bool Optimal)
 {
-	RpakFile& File = this->LoadedFiles[FileIndex];
-
 	if (!IO::File::Exists(Path))
 	{
 		g_Logger.Warning("Missing streaming file %s\n", Path.ToCString());
@@ -1118,20 +1097,28 @@ void RpakLib::MountStarpak(const string& Path, uint32_t FileIndex, uint32_t Star
 	}
 }
 
-bool RpakLib::MountApexRpak(const string& Path, bool Dump)
+bool RpakLib::MountApexRpak(RpakMountContext& Context)
 {
+	const string& Path = Context.Path;
+
 	IO::BinaryReader Reader = IO::BinaryReader(IO::File::OpenRead(Path));
 	RpakApexHeader Header = Reader.Read<RpakApexHeader>();
 
 	if (Header.CompressionType == RpakCompressionType::None && Header.CompressedSize == Header.DecompressedSize)
 	{
+		std::unique_ptr<IO::MemoryMappedFile> MappedFile = nullptr;
+		auto MappedStream = this->MapRpak(Path, MappedFile);
+
+		if (MappedStream)
+			return ParseApexRpak(Context, MappedStream, std::move(MappedFile));
+
 		auto Stream = std::make_unique<IO::MemoryStream>();
 
 		Reader.GetBaseStream()->SetPosition(0);
 		Reader.GetBaseStream()->CopyTo(Stream.get());
 		Stream->SetPosition(0);
 
-		return ParseApexRpak(Path, Stream);
+		return ParseApexRpak(Context, Stream);
 	}
 
 	std::unique_ptr<IO::MemoryStream> ResultStream = nullptr;
@@ -1160,16 +1147,16 @@ bool RpakLib::MountApexRpak(const string& Path, bool Dump)
 	}
 	case RpakCompressionType::Oodle:
 	{
-		auto CompressedBuffer = new uint8_t[Header.CompressedSize];
-		Reader.Read(CompressedBuffer, 0, Header.CompressedSize);
+		auto CompressedBuffer = std::make_unique<uint8_t[]>(Header.CompressedSize);
+		Reader.Read(CompressedBuffer.get(), 0, Header.CompressedSize);
 
 		// there are 520 unk bytes at the end of the archive
 
-		ResultStream = RTech::DecompressStreamedBuffer(CompressedBuffer, Header.DecompressedSize, (uint8_t)CompressionType::OODLE, false, sizeof(RpakApexHeader));
+		ResultStream = RTech::DecompressStreamedBuffer(CompressedBuffer.get(), Header.DecompressedSize, (uint8_t)CompressionType::OODLE, false, sizeof(RpakApexHeader));
 
 		if (!ResultStream) {  // ???
 			Header.DecompressedSize -= sizeof(RpakApexHeader);
-			ResultStream = RTech::DecompressStreamedBuffer(CompressedBuffer, Header.DecompressedSize, (uint8_t)CompressionType::OODLE, true, sizeof(RpakApexHeader));
+			ResultStream = RTech::DecompressStreamedBuffer(CompressedBuffer.get(), Header.DecompressedSize, (uint8_t)CompressionType::OODLE, true, sizeof(RpakApexHeader));
 		}
 		break;
 	}
@@ -1185,7 +1172,7 @@ bool RpakLib::MountApexRpak(const string& Path, bool Dump)
 	ResultStream->SetPosition(0);
 
 #if _DEBUG
-	if (Dump)
+	if (Context.Dump)
 	{
 		auto OutStream = IO::File::Create(IO::Path::Combine("D:\\", IO::Path::GetFileName(Path)));
 		ResultStream->CopyTo(OutStream.get());
@@ -1193,23 +1180,31 @@ bool RpakLib::MountApexRpak(const string& Path, bool Dump)
 	}
 #endif
 
-	return ParseApexRpak(Path, ResultStream);
+	return ParseApexRpak(Context, ResultStream);
 }
 
-bool RpakLib::MountTitanfallRpak(const string& Path, bool Dump)
+bool RpakLib::MountTitanfallRpak(RpakMountContext& Context)
 {
+	const string& Path = Context.Path;
+
 	IO::BinaryReader Reader = IO::BinaryReader(IO::File::OpenRead(Path));
 	RpakTitanfallHeader Header = Reader.Read<RpakTitanfallHeader>();
 
 	if (Header.CompressedSize == Header.DecompressedSize)
 	{
+		std::unique_ptr<IO::MemoryMappedFile> MappedFile = nullptr;
+		auto MappedStream = this->MapRpak(Path, MappedFile);
+
+		if (MappedStream)
+			return ParseTitanfallRpak(Context, MappedStream, std::move(MappedFile));
+
 		auto Stream = std::make_unique<IO::MemoryStream>();
 
 		Reader.GetBaseStream()->SetPosition(0);
 		Reader.GetBaseStream()->CopyTo(Stream.get());
 		Stream->SetPosition(0);
 
-		return ParseTitanfallRpak(Path, Stream);
+		return ParseTitanfallRpak(Context, Stream);
 	}
 
 	auto CompressedBuffer = std::make_unique<uint8_t[]>(Header.CompressedSize);
@@ -1233,22 +1228,29 @@ bool RpakLib::MountTitanfallRpak(const string& Path, bool Dump)
 	auto ResultStream = std::make_unique<IO::MemoryStream>(pakbuf.data(), 0, Header.DecompressedSize, true, true, true);
 
 #if _DEBUG
-	if (Dump)
+	if (Context.Dump)
 	{
 		auto OutStream = IO::File::Create(IO::Path::Combine("D:\\", IO::Path::GetFileName(Path)));
 		ResultStream->CopyTo(OutStream.get());
 		ResultStream->SetPosition(0);
 	}
 #endif
-	return ParseTitanfallRpak(Path, ResultStream);
+	return ParseTitanfallRpak(Context, ResultStream);
 }
 
-bool RpakLib::MountR2TTRpak(const string& Path, bool Dump)
+bool RpakLib::MountR2TTRpak(RpakMountContext& Context)
 {
+	const string& Path = Context.Path;
+
 	IO::BinaryReader Reader = IO::BinaryReader(IO::File::OpenRead(Path));
 	RpakHeaderV6 Header = Reader.Read<RpakHeaderV6>();
 
 	// rpak v6 doesn't seem to support compression
+	std::unique_ptr<IO::MemoryMappedFile> MappedFile = nullptr;
+	auto MappedStream = this->MapRpak(Path, MappedFile);
+
+	if (MappedStream)
+		return ParseR2TTRpak(Context, MappedStream, std::move(MappedFile));
 
 	auto Stream = std::make_unique<IO::MemoryStream>();
 
@@ -1257,7 +1259,41 @@ bool RpakLib::MountR2TTRpak(const string& Path, bool Dump)
 
 	Stream.get()->SetPosition(0);
 
-	return ParseR2TTRpak(Path, Stream);
+	return ParseR2TTRpak(Context, Stream);
+}
+
+std::unique_ptr<IO::MemoryStream> RpakLib::MapRpak(const string& Path, std::unique_ptr<IO::MemoryMappedFile>& MappedFile)
+{
+	if (!this->m_bMapUncompressedPaks)
+		return nullptr;
+
+	MappedFile = IO::MemoryMappedFile::OpenRead(Path);
+
+	if (!MappedFile->GetData())
+		return nullptr;
+
+	// The view is read-only, and the stream must never free it
+	return std::make_unique<IO::MemoryStream>(MappedFile->GetData(), 0, MappedFile->GetLength(), false, true);
+}
+
+void RpakLib::LoadSegmentData(RpakFile* File, std::unique_ptr<IO::MemoryStream>& ParseStream, std::unique_ptr<IO::MemoryMappedFile>& MappedFile)
+{
+	uint64_t BufferRemaining = ParseStream->GetLength() - ParseStream->GetPosition();
+
+	File->SegmentDataSize = BufferRemaining;
+
+	if (MappedFile)
+	{
+		// Segments are used in place, the mapping lives as long as the file
+		File->SegmentData = MappedFile->GetData() + ParseStream->GetPosition();
+		File->MappedFile = std::move(MappedFile);
+		return;
+	}
+
+	File->SegmentBuffer = std::make_unique<uint8_t[]>(BufferRemaining);
+	File->SegmentData = File->SegmentBuffer.get();
+
+	ParseStream->Read(File->SegmentData, 0, BufferRemaining);
 }
 
 string RpakLib::ReadStringFromPointer(const RpakLoadAsset& Asset, const RPakPtr& ptr)
@@ -1297,6 +1333,11 @@ RpakLoadAsset::RpakLoadAsset(uint64_t NameHash, uint32_t FileIndex, uint32_t Ass
 {
 }
 
+RpakMountContext::RpakMountContext(const string& Path, bool Dump)
+	: Path(Path), Dump(Dump), File(nullptr), Error(nullptr)
+{
+}
+
 RpakSegmentBlock::RpakSegmentBlock(uint64_t Offset, uint64_t Size)
 	: Offset(Offset), Size(Size)
 {
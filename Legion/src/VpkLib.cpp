@@ -3,6 +3,7 @@
 #include "CRC32.h"
 #include "BinaryReader.h"
 #include "VpkLib.h"
+#include "ParallelTask.h"
 #include <File.h>
 
 /***********************************************************************
@@ -182,102 +183,274 @@ void CPackedStore::ValidateCRC32PostDecomp(std::string svDirAsset)
 	m_vHashBuffer.clear();
 }
 
+//-----------------------------------------------------------------------------
+// Purpose: sets whether archive chunks are mapped, or read with positional reads
+//-----------------------------------------------------------------------------
+void CPackedStore::SetMapArchives(bool bMapArchives)
+{
+	m_bMapArchives = bMapArchives;
+}
+
 //-----------------------------------------------------------------------------
 // Purpose: extracts all files from specified vpk file
 //-----------------------------------------------------------------------------
 void CPackedStore::UnpackAll(vpk_dir_h vpk_dir, std::string svPathOut)
 {
-	for (int i = 0; i < vpk_dir.m_vsvArchives.size(); i++)
+	// Blocks are claimed in archive and offset order, so every archive chunk is read mostly front to back.
+	std::vector<size_t> vBlockOrder;
+	vBlockOrder.reserve(vpk_dir.m_vvEntryBlocks.size());
+
+	for (size_t i = 0; i < vpk_dir.m_vvEntryBlocks.size(); i++)
+	{
+		if (!vpk_dir.m_vvEntryBlocks[i].m_vvEntries.empty()) // Blocks without entries have nothing to extract.
+		{
+			vBlockOrder.push_back(i);
+		}
+	}
+
+	std::stable_sort(vBlockOrder.begin(), vBlockOrder.end(), [&vpk_dir](size_t a, size_t b)
+	{
+		const vpk_entry_block& blockA = vpk_dir.m_vvEntryBlocks[a];
+		const vpk_entry_block& blockB = vpk_dir.m_vvEntryBlocks[b];
+
+		if (blockA.m_iArchiveIndex != blockB.m_iArchiveIndex)
+			return blockA.m_iArchiveIndex < blockB.m_iArchiveIndex;
+
+		return blockA.m_vvEntries.front().m_nArchiveOffset < blockB.m_vvEntries.front().m_nArchiveOffset;
+	});
+
+	// Every archive chunk is opened once, workers share the handles through positional reads.
+	vpk_archive_table_h archives(vpk_dir, m_bMapArchives);
+	std::atomic<size_t> nBlockIndex = 0;
+
+	// Blocks are independent, every worker extracts them with it's own decompressor and buffers.
+	Threading::ParallelTask([this, &vpk_dir, &archives, &svPathOut, &vBlockOrder, &nBlockIndex]
+	{
+		vpk_unpack_ctx_h ctx(&m_lzDecompParams);
+		size_t i = 0;
+
+		while ((i = nBlockIndex++) < vBlockOrder.size())
+		{
+			UnpackBlock(archives, vpk_dir.m_vvEntryBlocks[vBlockOrder[i]], svPathOut, ctx);
+		}
+	}, (uint32_t)min(vBlockOrder.size(), (size_t)std::thread::hardware_concurrency()));
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: extracts a single entry block with the calling thread's context
+//-----------------------------------------------------------------------------
+void CPackedStore::UnpackBlock(const vpk_archive_table_h& archives, const vpk_entry_block& block, const std::string& svPathOut, vpk_unpack_ctx_h& ctx)
+{
+	if (!archives.IsOpen(block.m_iArchiveIndex))
+	{
+		printf("Error: skipping block '%s', archive '%d' couldn't be opened!\n", block.m_svBlockPath.c_str(), block.m_iArchiveIndex);
+		return;
+	}
+
+	std::string svFilePath = create_directories(svPathOut + "\\" + block.m_svBlockPath);
+	std::ofstream outFileStream(svFilePath, std::ios_base::binary | std::ios_base::out);
+
+	if (!outFileStream.is_open())
+	{
+		printf("Error: unable to access file '%s'!\n", svFilePath.c_str());
+	}
+
+	uint64_t nCompressedSize   = 0;
+	uint64_t nUncompressedSize = 0;
+	uint32_t nCrc32            = 0; // Crc32 of the whole block, entries are written in order.
+	bool     bFailed           = false;
+
+	for (const vpk_entry_h& entry : block.m_vvEntries)
 	{
-		std::filesystem::path fspVpkPath(vpk_dir.m_svDirPath);
-		std::string svPath = fspVpkPath.parent_path().u8string() + "\\" + vpk_dir.m_vsvArchives[i];
-		std::ifstream packChunkStream(svPath, std::ios_base::binary); // Create stream to read from each archive.
+		// Points into the mapped archive, or into the compressed buffer when the entry had to be read.
+		const uint8_t* pEntryData = archives.Read(block.m_iArchiveIndex, entry.m_nArchiveOffset, entry.m_nCompressedSize, ctx.m_vCompressedBuf);
+
+		if (!pEntryData)
+		{
+			printf("Error: skipping block '%s', an entry lies outside of archive '%d'!\n", block.m_svBlockPath.c_str(), block.m_iArchiveIndex);
+			bFailed = true;
+			break;
+		}
 
-		for (vpk_entry_block block : vpk_dir.m_vvEntryBlocks)
+		if (entry.m_bIsCompressed)
 		{
-			if (block.m_iArchiveIndex != i)
+			if (ctx.m_vDecompressedBuf.size() < entry.m_nUncompressedSize)
 			{
-				// Continue if block archive index is not part of the extracting archive chunk index.
-				goto cont;
+				ctx.m_vDecompressedBuf.resize(entry.m_nUncompressedSize);
 			}
-			else
+
+			size_t nInSize  = entry.m_nCompressedSize;
+			size_t nOutSize = entry.m_nUncompressedSize;
+			lzham_decompress_status_t lzDecompStatus = lzham_decompress_status_t::LZHAM_DECOMP_STATUS_FAILED_INITIALIZING;
+
+			ctx.m_pLzDecompState = ctx.m_pLzDecompState ? lzham_decompress_reinit(ctx.m_pLzDecompState, &ctx.m_lzDecompParams) : lzham_decompress_init(&ctx.m_lzDecompParams);
+
+			if (ctx.m_pLzDecompState)
 			{
-				std::string svFilePath = create_directories(svPathOut + "\\" + block.m_svBlockPath);
-				std::ofstream outFileStream(svFilePath, std::ios_base::binary | std::ios_base::out);
+				lzDecompStatus = lzham_decompress(ctx.m_pLzDecompState, pEntryData, &nInSize, ctx.m_vDecompressedBuf.data(), &nOutSize, true);
+			}
 
-				if (!outFileStream.is_open())
-				{
-					printf("Error: unable to access file '%s'!\n", svFilePath.c_str());
-				}
-				outFileStream.clear(); // Make sure file is empty before writing.
-				for (vpk_entry_h entry : block.m_vvEntries)
-				{
-					char* pCompressedData = new char[entry.m_nCompressedSize];
-					memset(pCompressedData, 0, entry.m_nCompressedSize); // Compressed region.
+			if (lzDecompStatus != lzham_decompress_status_t::LZHAM_DECOMP_STATUS_SUCCESS)
+			{
+				printf("Error: failed decompression for an entry within block '%s' in archive '%d'!\n", block.m_svBlockPath.c_str(), block.m_iArchiveIndex);
+				printf("'lzham_decompress' returned with status '%d'.\n", lzDecompStatus);
+				bFailed = true;
+				break;
+			}
 
-					packChunkStream.seekg(entry.m_nArchiveOffset);       // Seek to entry offset in archive.
-					packChunkStream.read(pCompressedData, entry.m_nCompressedSize); // Read compressed data from archive.
+			pEntryData = ctx.m_vDecompressedBuf.data();
+		}
 
-					if (entry.m_bIsCompressed)
-					{
-						lzham_uint8* pLzOutputBuf = new lzham_uint8[entry.m_nUncompressedSize];
-						m_lzDecompStatus = lzham_decompress_memory(&m_lzDecompParams, pLzOutputBuf, (size_t*)&entry.m_nUncompressedSize, (lzham_uint8*)pCompressedData, entry.m_nCompressedSize, &m_nAdler32_Internal, &m_nCrc32_Internal);
-
-						//if (fs_packedstore_entryblock_stats->m_iValue > 0)
-						{
-							printf("--------------------------------------------------------------\n");
-							printf("] Block path            : '%s'\n", block.m_svBlockPath.c_str());
-							printf("] Entry count           : '%llu'\n", block.m_vvEntries.size());
-							printf("] Compressed size       : '%llu'\n", entry.m_nCompressedSize);
-							printf("] Uncompressed size     : '%llu'\n", entry.m_nUncompressedSize);
-							printf("] Static CRC32 hash     : '0x%lX'\n", block.m_nCrc32);
-							printf("] Computed CRC32 hash   : '0x%lX'\n", m_nCrc32_Internal);
-							printf("] Computed ADLER32 hash : '0x%lX'\n", m_nAdler32_Internal);
-							printf("--------------------------------------------------------------\n");
-						}
-
-						if (block.m_vvEntries.size() == 1) // Internal checksum can only match block checksum if entry size is 1.
-						{
-							if (block.m_nCrc32 != m_nCrc32_Internal)
-							{
-								printf("Warning: CRC32 checksum mismatch for entry '%s' computed value '0x%lX' doesn't match expected value '0x%lX'!\n", block.m_svBlockPath.c_str(), m_nCrc32_Internal, block.m_nCrc32);
-							}
-						}
-						else
-						{
-							// Set internal hash to precomputed entry hash for post decompress validation.
-							m_nCrc32_Internal = block.m_nCrc32;
-							m_nEntryCount++;
-						}
-
-						if (m_lzDecompStatus != lzham_decompress_status_t::LZHAM_DECOMP_STATUS_SUCCESS)
-						{
-							printf("Error: failed decompression for an entry within block '%s' in archive '%d'!\n", block.m_svBlockPath.c_str(), i);
-							printf("'lzham_decompress_memory_func' returned with status '%d'.\n", m_lzDecompStatus);
-						}
-						else
-						{
-							// If successfully decompressed, write to file.
-							outFileStream.write((char*)pLzOutputBuf, entry.m_nUncompressedSize);
-							delete[] pLzOutputBuf, pCompressedData;
-						}
-					}
-					else
-					{
-						// If not compressed, write raw data into output file.
-						outFileStream.write(pCompressedData, entry.m_nUncompressedSize);
-					}
-				}
-				outFileStream.close();
-				if (m_nEntryCount == block.m_vvEntries.size()) // Only validate after last entry in block had been written.
+		// If successfully decompressed or not compressed, write to file.
+		outFileStream.write((char*)pEntryData, entry.m_nUncompressedSize);
+		nCrc32 = Hashing::CRC32::ComputeHash((uint8_t*)pEntryData, 0, entry.m_nUncompressedSize, nCrc32);
+
+		nCompressedSize   += entry.m_nCompressedSize;
+		nUncompressedSize += entry.m_nUncompressedSize;
+	}
+	outFileStream.close();
+
+	// Don't leave a truncated file behind, the error was already reported.
+	if (bFailed)
+	{
+		std::error_code ec;
+		std::filesystem::remove(svFilePath, ec);
+		return;
+	}
+
+	// One call per block, so blocks extracted at the same time don't interleave.
+	printf("--------------------------------------------------------------\n"
+		"] Block path            : '%s'\n"
+		"] Entry count           : '%llu'\n"
+		"] Compressed size       : '%llu'\n"
+		"] Uncompressed size     : '%llu'\n"
+		"] Static CRC32 hash     : '0x%lX'\n"
+		"] Computed CRC32 hash   : '0x%lX'\n"
+		"--------------------------------------------------------------\n",
+		block.m_svBlockPath.c_str(), block.m_vvEntries.size(), nCompressedSize, nUncompressedSize, block.m_nCrc32, nCrc32);
+
+	if (block.m_nCrc32 != nCrc32)
+	{
+		printf("Warning: CRC32 checksum mismatch for entry '%s' computed value '0x%lX' doesn't match expected value '0x%lX'!\n", block.m_svBlockPath.c_str(), nCrc32, block.m_nCrc32);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: 'vpk_archive_table_h' constructor
+//-----------------------------------------------------------------------------
+vpk_archive_table_h::vpk_archive_table_h(const vpk_dir_h& vpk_dir, bool bMapArchives)
+{
+	std::filesystem::path fspVpkPath(vpk_dir.m_svDirPath);
+	std::string svBasePath = fspVpkPath.parent_path().u8string() + "\\";
+
+	m_vArchives.resize(vpk_dir.m_vsvArchives.size());
+
+	for (size_t i = 0; i < vpk_dir.m_vsvArchives.size(); i++)
+	{
+		string svPath = (svBasePath + vpk_dir.m_vsvArchives[i]).c_str();
+
+		if (!IO::File::Exists(svPath))
+		{
+			printf("Error: unable to access archive '%s'!\n", svPath.ToCString());
+			continue;
+		}
+
+		if (bMapArchives)
+		{
+			try
+			{
+				m_vArchives[i].m_pMappedChunk = IO::MemoryMappedFile::OpenRead(svPath);
+
+				if (m_vArchives[i].m_pMappedChunk->GetData())
 				{
-					ValidateCRC32PostDecomp(svFilePath);
-					//ValidateAdler32PostDecomp(svFilePath);
-					m_nEntryCount = 0;
+					continue;
 				}
-			}cont:;
+			}
+			catch (const std::exception&)
+			{
+				// Falls back to reading the archive below.
+			}
+
+			m_vArchives[i].m_pMappedChunk.reset(); // Empty archives can't be mapped, they're read like any other.
+		}
+
+		try
+		{
+			m_vArchives[i].m_pChunk = IO::RandomAccessFile::OpenRead(svPath);
+		}
+		catch (const std::exception& e)
+		{
+			printf("Error: unable to open archive '%s': %s!\n", svPath.ToCString(), e.what());
+			m_vArchives[i].m_pChunk.reset(); // Left closed, the blocks that live in it are skipped while unpacking.
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: returns whether an archive chunk could be opened
+//-----------------------------------------------------------------------------
+bool vpk_archive_table_h::IsOpen(uint16_t iArchiveIndex) const
+{
+	return iArchiveIndex < m_vArchives.size() && (m_vArchives[iArchiveIndex].m_pMappedChunk || m_vArchives[iArchiveIndex].m_pChunk);
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: reads an entry from an archive chunk, thread safe
+// Output : pointer into the mapped archive, or 'vBuffer' when the entry had to be read,
+//          nullptr when the entry doesn't lie completely within an open archive
+//-----------------------------------------------------------------------------
+const uint8_t* vpk_archive_table_h::Read(uint16_t iArchiveIndex, uint64_t nOffset, uint64_t nSize, std::vector<uint8_t>& vBuffer) const
+{
+	if (!IsOpen(iArchiveIndex))
+	{
+		return nullptr;
+	}
+
+	const vpk_archive_h& archive = m_vArchives[iArchiveIndex];
+
+	if (archive.m_pMappedChunk)
+	{
+		uint64_t nLength = archive.m_pMappedChunk->GetLength();
+
+		if (nOffset > nLength || nSize > nLength - nOffset)
+		{
+			return nullptr;
 		}
-		packChunkStream.close();
+
+		return archive.m_pMappedChunk->GetData() + nOffset;
+	}
+
+	if (vBuffer.size() < nSize)
+	{
+		vBuffer.resize(nSize);
+	}
+
+	if (archive.m_pChunk->Read(vBuffer.data(), 0, nSize, nOffset) != nSize)
+	{
+		return nullptr;
+	}
+
+	return vBuffer.data();
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: 'vpk_unpack_ctx_h' constructor
+//-----------------------------------------------------------------------------
+vpk_unpack_ctx_h::vpk_unpack_ctx_h(const lzham_decompress_params* pParams)
+{
+	this->m_lzDecompParams = *pParams;
+	this->m_lzDecompParams.m_decompress_flags &= ~LZHAM_DECOMP_FLAG_COMPUTE_CRC32; // The block checksum is computed over the written data instead.
+	this->m_pLzDecompState = lzham_decompress_init(&this->m_lzDecompParams);
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: 'vpk_unpack_ctx_h' destructor
+//-----------------------------------------------------------------------------
+vpk_unpack_ctx_h::~vpk_unpack_ctx_h()
+{
+	if (this->m_pLzDecompState)
+	{
+		lzham_decompress_deinit(this->m_pLzDecompState);
 	}
 }
 
@@ -380,6 +553,7 @@ void VPK_Decompress_Callback()
 	vpk_dir_h vpk = g_pPackedStore->GetPackDirFile(szPathIn);
 
 	g_pPackedStore->InitLzParams();
+	g_pPackedStore->SetMapArchives(ExportManager::Config.GetBool("MapVpkArchives"));
 	g_pPackedStore->UnpackAll(vpk, szPathOut);
 
 	std::chrono::milliseconds msEnd = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch());
@@ -25,7 +25,7 @@ void InitializeBSPModelExporter(ModelExportFormat_t Format)
 		s_BSPModelExporter = std::make_unique<Assets::Exporters::AutodeskMaya>();
 		break;
 	case ModelExportFormat_t::OBJ:
-		s_BSPModelExporter = std::make_unique<Assets::Exporters::WavefrontOBJ>();
+		s_BSPModelExporter = std::make_unique<Assets::Exporters::WavefrontOBJ>(!ExportManager::Config.GetBool("ObjFlatVertices"));
 		break;
 	case ModelExportFormat_t::XNALaraText:
 		s_BSPModelExporter = std::make_unique<Assets::Exporters::XNALaraAscii>();
@@ -99,6 +99,81 @@ List<string> ExportPropContainer(std::unique_ptr<IO::MemoryStream>& Stream, cons
 	return propNames;
 }
 
+void ExtractBspMaterials(Threading::TaskGroup& Group, const std::unique_ptr<RpakLib>& RpakFileSystem, const List<string>& MaterialNames, List<RMdlMaterial>& Materials, List<uint8_t>& Extracted, const string& TexturePath)
+{
+	Materials = List<RMdlMaterial>(MaterialNames.Count(), true);
+	Extracted = List<uint8_t>(MaterialNames.Count(), true);
+
+	// make sure that RpakFileSystem actually exists (i.e. an rpak is loaded)
+	if (!RpakFileSystem)
+		return;
+
+	for (uint32_t i = 0; i < MaterialNames.Count(); i++)
+	{
+		const RpakLoadAsset* MaterialAsset = RpakFileSystem->FindAssetByName(AssetType_t::Material, MaterialNames[i]);
+
+		if (!MaterialAsset)
+			continue;
+
+		// Each task writes it's own slot, so the results don't depend on which one finishes first
+		Threading::WorkStealingScheduler::Spawn(Group, [&RpakFileSystem, &Materials, &Extracted, &TexturePath, MaterialAsset, i]
+		{
+			Materials[i] = RpakFileSystem->ExtractMaterial(*MaterialAsset, TexturePath, true, false);
+			Extracted[i] = true;
+		});
+	}
+}
+
+uint32_t AddBspMaterial(Assets::Model& Model, const string& MaterialName, const RMdlMaterial* ParsedMaterial)
+{
+	if (!ParsedMaterial)
+		return Model.AddMaterial(MaterialName, 0xDEADBEEF);
+
+	uint32_t MaterialIndex = Model.AddMaterial(ParsedMaterial->MaterialName, ParsedMaterial->AlbedoHash);
+
+	Assets::Material& MaterialInstance = Model.Materials[MaterialIndex];
+
+	if (ParsedMaterial->AlbedoMapName != "")
+		MaterialInstance.Slots.Add(Assets::MaterialSlotType::Albedo, { "_images\\" + ParsedMaterial->AlbedoMapName, ParsedMaterial->AlbedoHash });
+	if (ParsedMaterial->NormalMapName != "")
+		MaterialInstance.Slots.Add(Assets::MaterialSlotType::Normal, { "_images\\" + ParsedMaterial->NormalMapName, ParsedMaterial->NormalHash });
+	if (ParsedMaterial->GlossMapName != "")
+		MaterialInstance.Slots.Add(Assets::MaterialSlotType::Gloss, { "_images\\" + ParsedMaterial->GlossMapName, ParsedMaterial->GlossHash });
+	if (ParsedMaterial->SpecularMapName != "")
+		MaterialInstance.Slots.Add(Assets::MaterialSlotType::Specular, { "_images\\" + ParsedMaterial->SpecularMapName, ParsedMaterial->SpecularHash });
+	if (ParsedMaterial->EmissiveMapName != "")
+		MaterialInstance.Slots.Add(Assets::MaterialSlotType::Emissive, { "_images\\" + ParsedMaterial->EmissiveMapName, ParsedMaterial->EmissiveHash });
+	if (ParsedMaterial->AmbientOcclusionMapName != "")
+		MaterialInstance.Slots.Add(Assets::MaterialSlotType::AmbientOcclusion, { "_images\\" + ParsedMaterial->AmbientOcclusionMapName, ParsedMaterial->AmbientOcclusionHash });
+	if (ParsedMaterial->CavityMapName != "")
+		MaterialInstance.Slots.Add(Assets::MaterialSlotType::Cavity, { "_images\\" + ParsedMaterial->CavityMapName, ParsedMaterial->CavityHash });
+
+	return MaterialIndex;
+}
+
+void ScheduleBspPropExports(Threading::WorkStealingScheduler& Scheduler, const std::unique_ptr<RpakLib>& RpakFileSystem, const List<string>& PropNames, const string& ModelPath)
+{
+	if (!RpakFileSystem)
+		return;
+
+	string ExportedModelsPath = IO::Path::Combine(ModelPath, "_models");
+	string ExportedModelAnimsPath = IO::Path::Combine(ExportedModelsPath, "_animations");
+
+	for (auto& ModelName : PropNames)
+	{
+		const RpakLoadAsset* ModelAsset = RpakFileSystem->FindAssetByName(AssetType_t::Model, ModelName);
+
+		if (!ModelAsset)
+			continue;
+
+		// Props are exported independently of each other and of the world model
+		Scheduler.Schedule([&RpakFileSystem, ModelAsset, ExportedModelsPath, ExportedModelAnimsPath]
+		{
+			RpakFileSystem->ExportModel(*ModelAsset, ExportedModelsPath, ExportedModelAnimsPath);
+		}, 100);
+	}
+}
+
 // generic export func. decides which version to export as
 void ExportBsp(const std::unique_ptr<RpakLib>& RpakFileSystem, const string& Asset, const string& Path)
 {
@@ -117,6 +192,9 @@ void ExportBsp(const std::unique_ptr<RpakLib>& RpakFileSystem, const string& Ass
 				// call defined export func for this version
 				g_Logger.Info("Exporting bsp for '%s'\n", it.name);
 				it.exportFunc(RpakFileSystem, stream, header, Asset, Path);
+
+				if (RpakFileSystem)
+					RpakFileSystem->ReleaseStarpakHandles();
 				return;
 			}
 		}
@@ -1,5 +1,7 @@
 #include "pch.h"
 #include "bsplib.h"
+#include "BspMeshBuilder.h"
+#include "WorkStealingScheduler.h"
 
 #include "MdlLib.h"
 #include "File.h"
@@ -64,34 +66,16 @@ void ExportApexBsp(const std::unique_ptr<RpakLib>& RpakFileSystem, std::unique_p
 	auto vertUnlitLumpData = ReadLump<dvertUnlit>(helper, LUMP_VERTEX_UNLIT);
 	auto vertUnlitTSLumpData = ReadLump<dvertUnlitTS>(helper, LUMP_VERTEX_UNLIT_TS);
 
-	std::unique_ptr<List<ApexAsset>> assetList;
-	Dictionary<string, RpakLoadAsset> loadedMaterials;
-
-	// make sure that RpakFileSystem actually exists (i.e. an rpak is loaded)
-	if (RpakFileSystem)
+	// Meshes are added in lump order and built concurrently into their own slot, so the model is the same on every run
+	struct BspMeshJob
 	{
-		std::array<bool, 12> bAssets = {
-			false, // Model
-			false, // Animation
-			false, // Animation Req
-			false, // Texture/Images
-			true,  // Material
-			false, // UIIA
-			false, // Datatables
-			false, // ShaderSets
-			false, // SettingsSets
-			false, // RSONs
-			false, // Effects,
-			false, // Wrapped Files,
-		};
-
-		assetList = RpakFileSystem->BuildAssetList(bAssets);
-
-		for (auto& Mat : *assetList)
-		{
-			loadedMaterials.Add(Mat.Name, RpakFileSystem->Assets[Mat.Hash]);
-		}
-	}
+		uint32_t BspMesh;
+		uint32_t Material;
+	};
+
+	List<BspMeshJob> MeshJobs;
+	List<string> MaterialNames;
+	Dictionary<string, uint32_t> MaterialLookup;
 
 	for (auto& model : modelsLumpData)
 	{
@@ -102,8 +86,6 @@ void ExportApexBsp(const std::unique_ptr<RpakLib>& RpakFileSystem, std::unique_p
 			if (mesh.triCount <= 0)
 				continue;
 
-			int meshVertType = mesh.flags & 0x600;
-
 			dmaterialsort_t& material = materialsLumpData[mesh.mtlSortIdx];
 
 			dtexdata_t& tex = texLumpData[material.texdata];
@@ -111,121 +93,17 @@ void ExportApexBsp(const std::unique_ptr<RpakLib>& RpakFileSystem, std::unique_p
 
 			string CleanedMaterialName = IO::Path::GetFileNameWithoutExtension(MaterialName).ToLower();
 
-			Assets::Mesh& newMesh = Model->Meshes.Emplace(0, 1);
-			if (loadedMaterials.ContainsKey(CleanedMaterialName))
+			if (!MaterialLookup.ContainsKey(CleanedMaterialName))
 			{
-
-				RpakLoadAsset& MaterialAsset = loadedMaterials[CleanedMaterialName];
-
-				RMdlMaterial ParsedMaterial = RpakFileSystem->ExtractMaterial(MaterialAsset, TexturePath, true, false);
-				uint32_t MaterialIndex = Model->AddMaterial(ParsedMaterial.MaterialName, ParsedMaterial.AlbedoHash);
-
-				Assets::Material& MaterialInstance = Model->Materials[MaterialIndex];
-
-				if (ParsedMaterial.AlbedoMapName != "")
-					MaterialInstance.Slots.Add(Assets::MaterialSlotType::Albedo, { "_images\\" + ParsedMaterial.AlbedoMapName, ParsedMaterial.AlbedoHash });
-				if (ParsedMaterial.NormalMapName != "")
-					MaterialInstance.Slots.Add(Assets::MaterialSlotType::Normal, { "_images\\" + ParsedMaterial.NormalMapName, ParsedMaterial.NormalHash });
-				if (ParsedMaterial.GlossMapName != "")
-					MaterialInstance.Slots.Add(Assets::MaterialSlotType::Gloss, { "_images\\" + ParsedMaterial.GlossMapName, ParsedMaterial.GlossHash });
-				if (ParsedMaterial.SpecularMapName != "")
-					MaterialInstance.Slots.Add(Assets::MaterialSlotType::Specular, { "_images\\" + ParsedMaterial.SpecularMapName, ParsedMaterial.SpecularHash });
-				if (ParsedMaterial.EmissiveMapName != "")
-					MaterialInstance.Slots.Add(Assets::MaterialSlotType::Emissive, { "_images\\" + ParsedMaterial.EmissiveMapName, ParsedMaterial.EmissiveHash });
-				if (ParsedMaterial.AmbientOcclusionMapName != "")
-					MaterialInstance.Slots.Add(Assets::MaterialSlotType::AmbientOcclusion, { "_images\\" + ParsedMaterial.AmbientOcclusionMapName, ParsedMaterial.AmbientOcclusionHash });
-				if (ParsedMaterial.CavityMapName != "")
-					MaterialInstance.Slots.Add(Assets::MaterialSlotType::Cavity, { "_images\\" + ParsedMaterial.CavityMapName, ParsedMaterial.CavityHash });
-
-				newMesh.MaterialIndices.EmplaceBack(MaterialIndex);
-			}
-			else
-			{
-				newMesh.MaterialIndices.EmplaceBack(Model->AddMaterial(CleanedMaterialName, 0xDEADBEEF));
-			}
-
-			uint32_t FaceIndex = 0;
-
-			switch (meshVertType)
-			{
-			case MESH_VERTEX_LIT_FLAT:
-			{
-				for (uint32_t v = mesh.firstIdx; v < (mesh.firstIdx + (mesh.triCount * 3)); v += 3)
-				{
-					dvertLitFlat& V1 = vertLitFlatLumpData[facesLumpData[v + 0] + material.firstVertex];
-					dvertLitFlat& V2 = vertLitFlatLumpData[facesLumpData[v + 1] + material.firstVertex];
-					dvertLitFlat& V3 = vertLitFlatLumpData[facesLumpData[v + 2] + material.firstVertex];
-
-					newMesh.Vertices.EmplaceBack(vertLumpData[V1.posIdx], vertNormalsLumpData[V1.nmlIdx], Assets::VertexColor(), V1.tex);
-					newMesh.Vertices.EmplaceBack(vertLumpData[V2.posIdx], vertNormalsLumpData[V2.nmlIdx], Assets::VertexColor(), V2.tex);
-					newMesh.Vertices.EmplaceBack(vertLumpData[V3.posIdx], vertNormalsLumpData[V3.nmlIdx], Assets::VertexColor(), V3.tex);
-
-					newMesh.Faces.EmplaceBack(FaceIndex, FaceIndex + 1, FaceIndex + 2);
-					FaceIndex += 3;
-				}
-				break;
-			}
-
-			case MESH_VERTEX_LIT_BUMP:
-			{
-				for (uint32_t v = mesh.firstIdx; v < (mesh.firstIdx + (mesh.triCount * 3)); v += 3)
-				{
-					dvertLitBump& V1 = vertLitBumpLumpData[facesLumpData[v + 0] + material.firstVertex];
-					dvertLitBump& V2 = vertLitBumpLumpData[facesLumpData[v + 1] + material.firstVertex];
-					dvertLitBump& V3 = vertLitBumpLumpData[facesLumpData[v + 2] + material.firstVertex];
-
-					newMesh.Vertices.EmplaceBack(vertLumpData[V1.posIdx], vertNormalsLumpData[V1.nmlIdx], Assets::VertexColor(), V1.tex);
-					newMesh.Vertices.EmplaceBack(vertLumpData[V2.posIdx], vertNormalsLumpData[V2.nmlIdx], Assets::VertexColor(), V2.tex);
-					newMesh.Vertices.EmplaceBack(vertLumpData[V3.posIdx], vertNormalsLumpData[V3.nmlIdx], Assets::VertexColor(), V3.tex);
-
-					newMesh.Faces.EmplaceBack(FaceIndex, FaceIndex + 1, FaceIndex + 2);
-					FaceIndex += 3;
-				}
-				break;
-			}
-
-			case MESH_VERTEX_UNLIT:
-			{
-				for (uint32_t v = mesh.firstIdx; v < (mesh.firstIdx + (mesh.triCount * 3)); v += 3)
-				{
-					dvertUnlit& V1 = vertUnlitLumpData[facesLumpData[v + 0] + material.firstVertex];
-					dvertUnlit& V2 = vertUnlitLumpData[facesLumpData[v + 1] + material.firstVertex];
-					dvertUnlit& V3 = vertUnlitLumpData[facesLumpData[v + 2] + material.firstVertex];
-
-					newMesh.Vertices.EmplaceBack(vertLumpData[V1.posIdx], vertNormalsLumpData[V1.nmlIdx], Assets::VertexColor(), V1.tex);
-					newMesh.Vertices.EmplaceBack(vertLumpData[V2.posIdx], vertNormalsLumpData[V2.nmlIdx], Assets::VertexColor(), V2.tex);
-					newMesh.Vertices.EmplaceBack(vertLumpData[V3.posIdx], vertNormalsLumpData[V3.nmlIdx], Assets::VertexColor(), V3.tex);
-
-					newMesh.Faces.EmplaceBack(FaceIndex, FaceIndex + 1, FaceIndex + 2);
-					FaceIndex += 3;
-				}
-				break;
+				MaterialLookup.Add(CleanedMaterialName, MaterialNames.Count());
+				MaterialNames.EmplaceBack(CleanedMaterialName);
 			}
 
-			case MESH_VERTEX_UNLIT_TS:
-			{
-				for (uint32_t v = mesh.firstIdx; v < (mesh.firstIdx + (mesh.triCount * 3)); v += 3)
-				{
-					dvertUnlitTS& V1 = vertUnlitTSLumpData[facesLumpData[v + 0] + material.firstVertex];
-					dvertUnlitTS& V2 = vertUnlitTSLumpData[facesLumpData[v + 1] + material.firstVertex];
-					dvertUnlitTS& V3 = vertUnlitTSLumpData[facesLumpData[v + 2] + material.firstVertex];
-
-					newMesh.Vertices.EmplaceBack(vertLumpData[V1.posIdx], vertNormalsLumpData[V1.nmlIdx], Assets::VertexColor(), V1.tex);
-					newMesh.Vertices.EmplaceBack(vertLumpData[V2.posIdx], vertNormalsLumpData[V2.nmlIdx], Assets::VertexColor(), V2.tex);
-					newMesh.Vertices.EmplaceBack(vertLumpData[V3.posIdx], vertNormalsLumpData[V3.nmlIdx], Assets::VertexColor(), V3.tex);
-
-					newMesh.Faces.EmplaceBack(FaceIndex, FaceIndex + 1, FaceIndex + 2);
-					FaceIndex += 3;
-				}
-				break;
-			}
-
-			}
+			MeshJobs.EmplaceBack(BspMeshJob{ m, MaterialLookup[CleanedMaterialName] });
+			Model->Meshes.Emplace(0, mesh.triCount, 0, 1);
 		}
 	}
 
-	s_BSPModelExporter->ExportModel(*Model.get(), IO::Path::Combine(ModelPath, Model->Name + "_LOD0" + (const char*)s_BSPModelExporter->ModelExtension()));
-
 	uint8_t* Buffer = new uint8_t[header.lumps[LUMP_GAME_LUMPS].filelen];
 	if (header.bExternal)
 	{
@@ -239,46 +117,88 @@ void ExportApexBsp(const std::unique_ptr<RpakLib>& RpakFileSystem, std::unique_p
 	std::unique_ptr<IO::MemoryStream> Stream2 = std::make_unique<IO::MemoryStream>(Buffer, 0, header.lumps[LUMP_GAME_LUMPS].filelen);
 	List<string> propNames = ExportPropContainer(Stream2, Model->Name + "_LOD0", ModelPath);
 
-	// Export all of the bsp's prop models
-
-	string ExportedModelsPath = IO::Path::Combine(ModelPath, "_models");
-	string ExportedModelAnimsPath = IO::Path::Combine(ExportedModelsPath, "_animations");
-
-	if (!RpakFileSystem)
-		return;
-
-	std::array<bool, 12> bAssets = {
-		true,  // Model
-		false, // Animation
-		false, // Animation Seq
-		false, // Texture/Images
-		false, // Material
-		false, // UIIA
-		false, // Datatables
-		false, // ShaderSets
-		false, // SettingsSets
-		false, // RSONs
-		false, // Effects
-		false, // Wrapped Files
-	};
+	List<RMdlMaterial> ParsedMaterials;
+	List<uint8_t> ExtractedMaterials;
 
-	auto RpakModels = RpakFileSystem->BuildAssetList(bAssets);
-	Dictionary<string, RpakLoadAsset> RpakModelLookup;
+	Threading::WorkStealingScheduler Scheduler;
 
-	for (auto& tm : *RpakModels)
+	// The world model waits on it's meshes and materials, the props export alongside it
+	Scheduler.Schedule([&]
 	{
-		RpakModelLookup.Add(tm.Name, RpakFileSystem->Assets[tm.Hash]);
-	}
+		Threading::TaskGroup MeshTasks;
 
-	for (uint32_t i = 0; i < propNames.Count(); ++i)
-	{
-		string ModelName = propNames[i];
-		if (RpakModelLookup.ContainsKey(ModelName))
+		ExtractBspMaterials(MeshTasks, RpakFileSystem, MaterialNames, ParsedMaterials, ExtractedMaterials, TexturePath);
+
+		for (uint32_t First = 0; First < MeshJobs.Count(); First += BspMeshesPerTask)
+		{
+			Threading::WorkStealingScheduler::Spawn(MeshTasks, [&, First]
+			{
+				BspMeshBuilder Builder;
+
+				const uint32_t Last = min(First + BspMeshesPerTask, MeshJobs.Count());
+
+				for (uint32_t i = First; i < Last; i++)
+				{
+					dmesh_t& mesh = meshesLumpData[MeshJobs[i].BspMesh];
+					dmaterialsort_t& material = materialsLumpData[mesh.mtlSortIdx];
+
+					int meshVertType = mesh.flags & 0x600;
+
+					Builder.Begin(Model->Meshes[i], vertLumpData.begin(), vertNormalsLumpData.begin(), mesh.triCount);
+
+					switch (meshVertType)
+					{
+					case MESH_VERTEX_LIT_FLAT:
+					{
+						Builder.AddTriangles(&facesLumpData[mesh.firstIdx], mesh.triCount, &vertLitFlatLumpData[material.firstVertex]);
+						break;
+					}
+
+					case MESH_VERTEX_LIT_BUMP:
+					{
+						Builder.AddTriangles(&facesLumpData[mesh.firstIdx], mesh.triCount, &vertLitBumpLumpData[material.firstVertex]);
+						break;
+					}
+
+					case MESH_VERTEX_UNLIT:
+					{
+						Builder.AddTriangles(&facesLumpData[mesh.firstIdx], mesh.triCount, &vertUnlitLumpData[material.firstVertex]);
+						break;
+					}
+
+					case MESH_VERTEX_UNLIT_TS:
+					{
+						Builder.AddTriangles(&facesLumpData[mesh.firstIdx], mesh.triCount, &vertUnlitTSLumpData[material.firstVertex]);
+						break;
+					}
+
+					}
+				}
+			});
+		}
+
+		Threading::WorkStealingScheduler::Wait(MeshTasks);
+
+		for (uint32_t i = 0; i < MeshJobs.Count(); i++)
 		{
-			RpakLoadAsset& ModelAsset = RpakModelLookup[ModelName];
-			RpakFileSystem->ExportModel(ModelAsset, ExportedModelsPath, ExportedModelAnimsPath);
+			const uint32_t Material = MeshJobs[i].Material;
+
+			Model->Meshes[i].MaterialIndices.EmplaceBack(AddBspMaterial(*Model, MaterialNames[Material], ExtractedMaterials[Material] ? &ParsedMaterials[Material] : nullptr));
 		}
-	}
+
+		s_BSPModelExporter->ExportModel(*Model.get(), IO::Path::Combine(ModelPath, Model->Name + "_LOD0" + (const char*)s_BSPModelExporter->ModelExtension()));
+	}, UINT64_MAX);
+
+	// Export all of the bsp's prop models
+	ScheduleBspPropExports(Scheduler, RpakFileSystem, propNames, ModelPath);
+
+	Scheduler.Run([]
+	{
+		(void)CoInitializeEx(0, COINIT_MULTITHREADED);
+	}, []
+	{
+		CoUninitialize();
+	});
 }
 
 
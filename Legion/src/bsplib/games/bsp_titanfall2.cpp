@@ -1,5 +1,7 @@
 #include "pch.h"
 #include "bsplib.h"
+#include "BspMeshBuilder.h"
+#include "WorkStealingScheduler.h"
 
 #include "MdlLib.h"
 #include "File.h"
@@ -76,34 +78,16 @@ void ExportTitanfall2Bsp(const std::unique_ptr<RpakLib>& RpakFileSystem, std::un
 		}
 	}
 
-	std::unique_ptr<List<ApexAsset>> RpakMaterials;
-	Dictionary<string, RpakLoadAsset> RpakMaterialLookup;
-
-	// make sure that RpakFileSystem actually exists (i.e. an rpak is loaded)
-	if (RpakFileSystem)
+	// Meshes are added in lump order and built concurrently into their own slot, so the model is the same on every run
+	struct BspMeshJob
 	{
-		std::array<bool, 12> bAssets = {
-			false, // Model
-			false, // Animation
-			false, // Animation Seq
-			false, // Texture/Images
-			true,  // Material
-			false, // UIIA
-			false, // Datatables
-			false, // ShaderSets
-			false, // SettingsSets
-			false, // RSONs
-			false, // Effects
-			false, // Wrapped Files
-		};
-
-		RpakMaterials = RpakFileSystem->BuildAssetList(bAssets);
-
-		for (auto& Mat : *RpakMaterials)
-		{
-			RpakMaterialLookup.Add(Mat.Name, RpakFileSystem->Assets[Mat.Hash]);
-		}
-	}
+		uint32_t BspMesh;
+		uint32_t Material;
+	};
+
+	List<BspMeshJob> MeshJobs;
+	List<string> MaterialNames;
+	Dictionary<string, uint32_t> MaterialLookup;
 
 	for (auto& model : modelsLumpData)
 	{
@@ -114,118 +98,24 @@ void ExportTitanfall2Bsp(const std::unique_ptr<RpakLib>& RpakFileSystem, std::un
 			if (BspMesh.triCount <= 0)
 				continue;
 
-			int FaceLump = BspMesh.flags & 0x600;
-
 			dmaterialsort_t& Material = materialsLumpData[BspMesh.mtlSortIdx];
-			Assets::Mesh& Mesh = Model->Meshes.Emplace(0, 1);
 
 			dtexdata_t& tex = texLumpData[Material.texdata];
 			string MaterialName = NameStringTable[tex.nameStringTableID];
-			string CleanedMaterialName = IO::Path::GetFileNameWithoutExtension(MaterialName).ToLower();
-
-			int32_t MaterialIndex = -1;
-
-			if (RpakMaterialLookup.ContainsKey(CleanedMaterialName))
-			{
-				auto MaterialAsset = RpakMaterialLookup[CleanedMaterialName];
-				auto ParsedMaterial = RpakFileSystem->ExtractMaterial(MaterialAsset, TexturePath, true, false);
-				auto MaterialIndex = Model->AddMaterial(ParsedMaterial.MaterialName, ParsedMaterial.AlbedoHash);
-
-				auto& MaterialInstance = Model->Materials[MaterialIndex];
-
-				if (ParsedMaterial.AlbedoMapName != "")
-					MaterialInstance.Slots.Add(Assets::MaterialSlotType::Albedo, { "_images\\" + ParsedMaterial.AlbedoMapName, ParsedMaterial.AlbedoHash });
-				if (ParsedMaterial.NormalMapName != "")
-					MaterialInstance.Slots.Add(Assets::MaterialSlotType::Normal, { "_images\\" + ParsedMaterial.NormalMapName, ParsedMaterial.NormalHash });
-				if (ParsedMaterial.GlossMapName != "")
-					MaterialInstance.Slots.Add(Assets::MaterialSlotType::Gloss, { "_images\\" + ParsedMaterial.GlossMapName, ParsedMaterial.GlossHash });
-				if (ParsedMaterial.SpecularMapName != "")
-					MaterialInstance.Slots.Add(Assets::MaterialSlotType::Specular, { "_images\\" + ParsedMaterial.SpecularMapName, ParsedMaterial.SpecularHash });
-				if (ParsedMaterial.EmissiveMapName != "")
-					MaterialInstance.Slots.Add(Assets::MaterialSlotType::Emissive, { "_images\\" + ParsedMaterial.EmissiveMapName, ParsedMaterial.EmissiveHash });
-				if (ParsedMaterial.AmbientOcclusionMapName != "")
-					MaterialInstance.Slots.Add(Assets::MaterialSlotType::AmbientOcclusion, { "_images\\" + ParsedMaterial.AmbientOcclusionMapName, ParsedMaterial.AmbientOcclusionHash });
-				if (ParsedMaterial.CavityMapName != "")
-					MaterialInstance.Slots.Add(Assets::MaterialSlotType::Cavity, { "_images\\" + ParsedMaterial.CavityMapName, ParsedMaterial.CavityHash });
-
-				Mesh.MaterialIndices.EmplaceBack(MaterialIndex);
-			}
-			else
-			{
-				Mesh.MaterialIndices.EmplaceBack(Model->AddMaterial(CleanedMaterialName, 0xDEADBEEF));
-			}
-
-			uint32_t FaceIndex = 0;
 
-			if (FaceLump == 0x000)
-			{
-				for (uint32_t v = BspMesh.firstIdx; v < (BspMesh.firstIdx + (BspMesh.triCount * 3)); v += 3)
-				{
-					dvertLitFlat& V1 = vertLitFlatLumpData[facesLumpData[v + 0] + Material.firstVertex];
-					dvertLitFlat& V2 = vertLitFlatLumpData[facesLumpData[v + 1] + Material.firstVertex];
-					dvertLitFlat& V3 = vertLitFlatLumpData[facesLumpData[v + 2] + Material.firstVertex];
-
-					Mesh.Vertices.EmplaceBack(vertLumpData[V1.posIdx], vertNormalsLumpData[V1.nmlIdx], Assets::VertexColor(), V1.tex);
-					Mesh.Vertices.EmplaceBack(vertLumpData[V2.posIdx], vertNormalsLumpData[V2.nmlIdx], Assets::VertexColor(), V2.tex);
-					Mesh.Vertices.EmplaceBack(vertLumpData[V3.posIdx], vertNormalsLumpData[V3.nmlIdx], Assets::VertexColor(), V3.tex);
-
-					Mesh.Faces.EmplaceBack(FaceIndex, FaceIndex + 1, FaceIndex + 2);
-					FaceIndex += 3;
-				}
-			}
-			else if (FaceLump == 0x200)
-			{
-				for (uint32_t v = BspMesh.firstIdx; v < (BspMesh.firstIdx + (BspMesh.triCount * 3)); v += 3)
-				{
-					dvertLitBump& V1 = vertLitBumpLumpData[facesLumpData[v + 0] + Material.firstVertex];
-					dvertLitBump& V2 = vertLitBumpLumpData[facesLumpData[v + 1] + Material.firstVertex];
-					dvertLitBump& V3 = vertLitBumpLumpData[facesLumpData[v + 2] + Material.firstVertex];
-
-					Mesh.Vertices.EmplaceBack(vertLumpData[V1.posIdx], vertNormalsLumpData[V1.nmlIdx], Assets::VertexColor(), V1.tex);
-					Mesh.Vertices.EmplaceBack(vertLumpData[V2.posIdx], vertNormalsLumpData[V2.nmlIdx], Assets::VertexColor(), V2.tex);
-					Mesh.Vertices.EmplaceBack(vertLumpData[V3.posIdx], vertNormalsLumpData[V3.nmlIdx], Assets::VertexColor(), V3.tex);
+			string CleanedMaterialName = IO::Path::GetFileNameWithoutExtension(MaterialName).ToLower();
 
-					Mesh.Faces.EmplaceBack(FaceIndex, FaceIndex + 1, FaceIndex + 2);
-					FaceIndex += 3;
-				}
-			}
-			else if (FaceLump == 0x400)
+			if (!MaterialLookup.ContainsKey(CleanedMaterialName))
 			{
-				for (uint32_t v = BspMesh.firstIdx; v < (BspMesh.firstIdx + (BspMesh.triCount * 3)); v += 3)
-				{
-					dvertUnlit& V1 = vertUnlitLumpData[facesLumpData[v + 0] + Material.firstVertex];
-					dvertUnlit& V2 = vertUnlitLumpData[facesLumpData[v + 1] + Material.firstVertex];
-					dvertUnlit& V3 = vertUnlitLumpData[facesLumpData[v + 2] + Material.firstVertex];
-
-					Mesh.Vertices.EmplaceBack(vertLumpData[V1.posIdx], vertNormalsLumpData[V1.nmlIdx], Assets::VertexColor(), V1.tex);
-					Mesh.Vertices.EmplaceBack(vertLumpData[V2.posIdx], vertNormalsLumpData[V2.nmlIdx], Assets::VertexColor(), V2.tex);
-					Mesh.Vertices.EmplaceBack(vertLumpData[V3.posIdx], vertNormalsLumpData[V3.nmlIdx], Assets::VertexColor(), V3.tex);
-
-					Mesh.Faces.EmplaceBack(FaceIndex, FaceIndex + 1, FaceIndex + 2);
-					FaceIndex += 3;
-				}
+				MaterialLookup.Add(CleanedMaterialName, MaterialNames.Count());
+				MaterialNames.EmplaceBack(CleanedMaterialName);
 			}
-			else if (FaceLump == 0x600)
-			{
-				for (uint32_t v = BspMesh.firstIdx; v < (BspMesh.firstIdx + (BspMesh.triCount * 3)); v += 3)
-				{
-					dvertUnlitTS& V1 = vertUnlitTSLumpData[facesLumpData[v + 0] + Material.firstVertex];
-					dvertUnlitTS& V2 = vertUnlitTSLumpData[facesLumpData[v + 1] + Material.firstVertex];
-					dvertUnlitTS& V3 = vertUnlitTSLumpData[facesLumpData[v + 2] + Material.firstVertex];
-
-					Mesh.Vertices.EmplaceBack(vertLumpData[V1.posIdx], vertNormalsLumpData[V1.nmlIdx], Assets::VertexColor(), V1.tex);
-					Mesh.Vertices.EmplaceBack(vertLumpData[V2.posIdx], vertNormalsLumpData[V2.nmlIdx], Assets::VertexColor(), V2.tex);
-					Mesh.Vertices.EmplaceBack(vertLumpData[V3.posIdx], vertNormalsLumpData[V3.nmlIdx], Assets::VertexColor(), V3.tex);
 
-					Mesh.Faces.EmplaceBack(FaceIndex, FaceIndex + 1, FaceIndex + 2);
-					FaceIndex += 3;
-				}
-			}
+			MeshJobs.EmplaceBack(BspMeshJob{ m, MaterialLookup[CleanedMaterialName] });
+			Model->Meshes.Emplace(0, BspMesh.triCount, 0, 1);
 		}
 	}
 
-	s_BSPModelExporter->ExportModel(*Model.get(), IO::Path::Combine(ModelPath, Model->Name + "_LOD0" + (const char*)s_BSPModelExporter->ModelExtension()));
-
 	uint8_t* Buffer = new uint8_t[header.lumps[LUMP_GAME_LUMPS].filelen];
 	if (header.bExternal)
 	{
@@ -239,46 +129,77 @@ void ExportTitanfall2Bsp(const std::unique_ptr<RpakLib>& RpakFileSystem, std::un
 	std::unique_ptr<IO::MemoryStream> Stream2 = std::make_unique<IO::MemoryStream>(Buffer, 0, header.lumps[LUMP_GAME_LUMPS].filelen);
 	List<string> propNames = ExportPropContainer(Stream2, Model->Name + "_LOD0", ModelPath);
 
-	// Export all of the bsp's prop models
+	List<RMdlMaterial> ParsedMaterials;
+	List<uint8_t> ExtractedMaterials;
 
-	if (!RpakFileSystem)
-		return;
-
-	string ExportedModelsPath = IO::Path::Combine(ModelPath, "_models");
-	string ExportedModelAnimsPath = IO::Path::Combine(ExportedModelsPath, "_animations");
-
-	std::array<bool, 12> bAssets = {
-		true,  // Model
-		false, // Animation
-		false, // AnimationSeq
-		false, // Texture/Images
-		false, // Material
-		false, // UIIA
-		false, // Datatables
-		false, // ShaderSets
-		false, // SettingsSets
-		false, // RSONs
-		false, // Effects
-		false, // Wrapped Files
-	};
-
-	auto RpakModels = RpakFileSystem->BuildAssetList(bAssets);
-	Dictionary<string, RpakLoadAsset> RpakModelLookup;
+	Threading::WorkStealingScheduler Scheduler;
 
-	for (auto& tm : *RpakModels)
+	// The world model waits on it's meshes and materials, the props export alongside it
+	Scheduler.Schedule([&]
 	{
-		RpakModelLookup.Add(tm.Name, RpakFileSystem->Assets[tm.Hash]);
-	}
+		Threading::TaskGroup MeshTasks;
 
-	for (uint32_t i = 0; i < propNames.Count(); ++i)
-	{
-		string ModelName = propNames[i];
-		if (RpakModelLookup.ContainsKey(ModelName))
+		ExtractBspMaterials(MeshTasks, RpakFileSystem, MaterialNames, ParsedMaterials, ExtractedMaterials, TexturePath);
+
+		for (uint32_t First = 0; First < MeshJobs.Count(); First += BspMeshesPerTask)
+		{
+			Threading::WorkStealingScheduler::Spawn(MeshTasks, [&, First]
+			{
+				BspMeshBuilder Builder;
+
+				const uint32_t Last = min(First + BspMeshesPerTask, MeshJobs.Count());
+
+				for (uint32_t i = First; i < Last; i++)
+				{
+					dmesh_t& BspMesh = meshesLumpData[MeshJobs[i].BspMesh];
+					dmaterialsort_t& Material = materialsLumpData[BspMesh.mtlSortIdx];
+
+					int FaceLump = BspMesh.flags & 0x600;
+
+					Builder.Begin(Model->Meshes[i], vertLumpData.begin(), vertNormalsLumpData.begin(), BspMesh.triCount);
+
+					if (FaceLump == 0x000)
+					{
+						Builder.AddTriangles(&facesLumpData[BspMesh.firstIdx], BspMesh.triCount, &vertLitFlatLumpData[Material.firstVertex]);
+					}
+					else if (FaceLump == 0x200)
+					{
+						Builder.AddTriangles(&facesLumpData[BspMesh.firstIdx], BspMesh.triCount, &vertLitBumpLumpData[Material.firstVertex]);
+					}
+					else if (FaceLump == 0x400)
+					{
+						Builder.AddTriangles(&facesLumpData[BspMesh.firstIdx], BspMesh.triCount, &vertUnlitLumpData[Material.firstVertex]);
+					}
+					else if (FaceLump == 0x600)
+					{
+						Builder.AddTriangles(&facesLumpData[BspMesh.firstIdx], BspMesh.triCount, &vertUnlitTSLumpData[Material.firstVertex]);
+					}
+				}
+			});
+		}
+
+		Threading::WorkStealingScheduler::Wait(MeshTasks);
+
+		for (uint32_t i = 0; i < MeshJobs.Count(); i++)
 		{
-			RpakLoadAsset& ModelAsset = RpakModelLookup[ModelName];
-			RpakFileSystem->ExportModel(ModelAsset, ExportedModelsPath, ExportedModelAnimsPath);
+			const uint32_t Material = MeshJobs[i].Material;
+
+			Model->Meshes[i].MaterialIndices.EmplaceBack(AddBspMaterial(*Model, MaterialNames[Material], ExtractedMaterials[Material] ? &ParsedMaterials[Material] : nullptr));
 		}
-	}
+
+		s_BSPModelExporter->ExportModel(*Model.get(), IO::Path::Combine(ModelPath, Model->Name + "_LOD0" + (const char*)s_BSPModelExporter->ModelExtension()));
+	}, UINT64_MAX);
+
+	// Export all of the bsp's prop models
+	ScheduleBspPropExports(Scheduler, RpakFileSystem, propNames, ModelPath);
+
+	Scheduler.Run([]
+	{
+		(void)CoInitializeEx(0, COINIT_MULTITHREADED);
+	}, []
+	{
+		CoUninitialize();
+	});
 }
 
 static game_t game_titanfall2{
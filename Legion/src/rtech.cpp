@@ -1,6 +1,7 @@
 #include "pch.h"
 #include "rtech.h"
 #include "basetypes.h"
+#include "Environment.h"
 #include "../../cppnet/cppkore_incl/OODLE/oodle2.h"
 
 /******************************************************************************
@@ -111,9 +112,458 @@ uint64_t __fastcall RTech::DecompressPakfileInit(rpak_decomp_state* state, uint8
 }
 
 //-----------------------------------------------------------------------------
-// Purpose: decompress input pakfile
+// Purpose: pakfile decoder tables, packed so each lookup reads a single entry
+//-----------------------------------------------------------------------------
+struct RpakLzSymbol
+{
+	int8_t Length;	// LUT_0
+	uint8_t Bits;	// LUT_200
+};
+
+struct RpakLzDistance
+{
+	uint8_t Base;	// LUT_400
+	uint8_t Bits;	// LUT_440
+};
+
+struct RpakLzLength
+{
+	uint32_t Base;	// LUT_4D0 / LUT_480
+	uint32_t Bits;	// LUT_4D8 / LUT_4C0
+};
+
+static const std::array<RpakLzSymbol, 512> LUT_Symbol = []
+{
+	std::array<RpakLzSymbol, 512> Result{};
+	for (size_t i = 0; i < Result.size(); i++)
+		Result[i] = { LUT_0[i], LUT_200[i] };
+	return Result;
+}();
+
+static const std::array<RpakLzDistance, 0x40> LUT_Distance = []
+{
+	std::array<RpakLzDistance, 0x40> Result{};
+	for (size_t i = 0; i < Result.size(); i++)
+		Result[i] = { LUT_400[i], LUT_440[i] };
+	return Result;
+}();
+
+static const std::array<RpakLzLength, 8> LUT_ShortLength = []
+{
+	std::array<RpakLzLength, 8> Result{};
+	for (size_t i = 0; i < Result.size(); i++)
+		Result[i] = { LUT_4D0[i], LUT_4D8[i] };
+	return Result;
+}();
+
+static const std::array<RpakLzLength, 16> LUT_LongLength = []
+{
+	std::array<RpakLzLength, 16> Result{};
+	for (size_t i = 0; i < Result.size(); i++)
+		Result[i] = { LUT_480[i], LUT_4C0[i] };
+	return Result;
+}();
+
+//-----------------------------------------------------------------------------
+// Purpose: copy a multiple of 8 bytes, in chunks as wide as the distance
+//          between source and destination allows
+//-----------------------------------------------------------------------------
+static __forceinline void RpakCopyWide(uint8_t* Destination, const uint8_t* Source, uint64_t Count, uint64_t Distance)
+{
+	uint64_t i = 0;
+
+	if (Distance >= 32)
+	{
+		for (; i + 32 <= Count; i += 32)
+		{
+			const __m128i Low = _mm_loadu_si128((const __m128i*)(Source + i));
+			const __m128i High = _mm_loadu_si128((const __m128i*)(Source + i + 16));
+			_mm_storeu_si128((__m128i*)(Destination + i), Low);
+			_mm_storeu_si128((__m128i*)(Destination + i + 16), High);
+		}
+	}
+
+	if (Distance >= 16)
+	{
+		for (; i + 16 <= Count; i += 16)
+			_mm_storeu_si128((__m128i*)(Destination + i), _mm_loadu_si128((const __m128i*)(Source + i)));
+	}
+
+	for (; i < Count; i += 8)
+		*(uint64_t*)(Destination + i) = *(const uint64_t*)(Source + i);
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: decompress input pakfile, bit-exact with DecompressPakFileReference
 //-----------------------------------------------------------------------------
 uint8_t __fastcall RTech::DecompressPakFile(rpak_decomp_state* state, uint64_t inLen, uint64_t outLen)
+{
+	uint64_t decompressed_position; // r15
+	uint32_t byte_bit_offset; // ebp
+	uint64_t byte; // rsi
+	uint64_t input_byte_pos; // rdi
+	uint64_t some_size; // r12
+	uint32_t dword6C; // ecx MAPDST
+	uint64_t v12; // rsi
+	uint64_t i; // rax
+	uint64_t dword6c_shl8; // r8
+	int64_t dword6c_old; // r9
+	int32_t LUT_200_val; // ecx
+	uint64_t v17; // rax
+	uint64_t byte_new; // rsi
+	int64_t  LUT_0_VAL; // r14
+	int32_t byte_4bits_1; // ecx
+	uint64_t v21; // r11
+	int32_t v22; // edx
+	uint64_t out_mask; // rax
+	int32_t v24; // er8
+	uint32_t LUT_400_seek_backwards; // er13
+	uint64_t out_seek_back; // r10
+	uint64_t out_seekd_1; // rax
+	uint64_t* out_seekd_back; // r10
+	uint64_t decompressed_size; // r9
+	uint64_t inv_mask_in; // r10
+	uint64_t header_skip_bytes_bs; // r8
+	uint64_t v32; // rax
+	uint64_t v33; // rax
+	uint64_t v34; // rax
+	uint64_t stream_decompressed_size_new; // rcx
+	int64_t  v36; // rdx
+	uint64_t len_needed_new; // r14
+	uint64_t stream_compressed_size_new; // r11
+	char v39; // cl MAPDST
+	uint64_t v40; // rsi MAPDST
+	uint64_t v46; // rcx
+	int64_t v47; // r9
+	int64_t m; // r8
+	uint32_t v49; // er9
+	int64_t v50; // r8
+	int64_t v51; // rdx
+	int64_t k; // r8
+	char* v53; // r10
+	int64_t  v54; // rdx
+	uint32_t lut0_val_abs; // er14
+	int64_t* in_seekd; // rdx
+	int64_t* out_seekd; // r8
+	int64_t  byte_3bits; // rax MAPDST
+	uint64_t byte_new_tmp; // r9 MAPDST
+	int32_t LUT_4D0_480; // er10 MAPDST
+	uint8_t LUT_4D8_4C0_nBits; // cl MAPDST
+	uint64_t byte_4bits; // rax MAPDST
+	uint32_t copy_bytes_ammount; // er14
+	uint32_t j; // ecx
+	int64_t v67; // rax
+	uint64_t v68; // rcx
+	uint8_t result; // al
+	const RpakLzSymbol* symbol;
+	const RpakLzDistance* distance;
+	const RpakLzLength* length;
+
+	if (inLen < state->len_needed)
+		return 0;
+
+	decompressed_position = state->decompressed_position;
+	if (outLen < state->inv_mask_out + (decompressed_position & ~state->inv_mask_out) + 1 && outLen < state->decompressed_size)
+	{
+		return 0;
+	}
+
+	byte_bit_offset = state->byte_bit_offset; // Keeping copy since we increment it down below.
+	byte = state->byte; // Keeping copy since its getting overwritten down below.
+	input_byte_pos = state->input_byte_pos; // Keeping copy since we increment it down below.
+	some_size = state->qword70;
+	if (state->stream_compressed_size < some_size)
+		some_size = state->stream_compressed_size;
+	dword6C = state->dword6C;
+
+	if (!byte_bit_offset)
+		goto LABEL_9;
+
+	v12 = (*(uint64_t*)((input_byte_pos & state->mask) + state->input_buf) << (64 - (uint8_t)byte_bit_offset)) | byte;
+	for (i = byte_bit_offset; ; i = byte_bit_offset)
+	{
+		byte_bit_offset &= 7u;
+		input_byte_pos += i >> 3;
+		byte = (0xFFFFFFFFFFFFFFFFui64 >> byte_bit_offset) & v12;
+	LABEL_9:
+		dword6c_shl8 = (uint64_t)dword6C << 8;
+		dword6c_old = dword6C;
+		v17 = (uint8_t)byte + dword6c_shl8;
+		symbol = &LUT_Symbol[v17];
+		LUT_200_val = symbol->Bits;// LUT_200 - u8 - ammount of bits
+		byte_bit_offset += LUT_200_val;
+		byte_new = byte >> LUT_200_val;
+		LUT_0_VAL = symbol->Length;// LUT_0 - i32 - signed, ammount of bytes
+
+		if (LUT_0_VAL < 0)
+		{
+			lut0_val_abs = -(int32_t)LUT_0_VAL;
+			in_seekd = (int64_t*)(state->input_buf + (input_byte_pos & state->mask));
+			dword6C = 1;
+			out_seekd = (int64_t*)(state->out + (decompressed_position & state->out_mask));
+			if (lut0_val_abs == LUT_4E0[dword6c_old])
+			{
+				if ((~input_byte_pos & state->inv_mask_in) < 0xF 
+					|| (state->inv_mask_out & ~decompressed_position) < 0xF 
+					|| state->decompressed_size - decompressed_position < 0x10)
+				{
+					lut0_val_abs = 1;
+				}
+
+				v39 = byte_new;
+				v40 = byte_new >> 3;
+				byte_3bits = v39 & 7;
+				byte_new_tmp = v40;
+
+				if (byte_3bits)
+				{
+					length = &LUT_ShortLength[byte_3bits];
+				}
+				else
+				{
+					byte_new_tmp = v40 >> 4;
+					byte_4bits = v40 & 15;
+					byte_bit_offset += 4;
+					length = &LUT_LongLength[byte_4bits];
+				}
+
+				LUT_4D0_480 = length->Base;// LUT_4D0 / LUT_480
+				LUT_4D8_4C0_nBits = length->Bits;// LUT_4D8 / LUT_4C0 - ammount of bits
+
+				byte_bit_offset += LUT_4D8_4C0_nBits + 3;
+				byte_new = byte_new_tmp >> LUT_4D8_4C0_nBits;
+				copy_bytes_ammount = LUT_4D0_480 + (byte_new_tmp & ((1 << LUT_4D8_4C0_nBits) - 1)) + lut0_val_abs;
+
+				// copy by 32, 16 and 8 bytes, literals never overlap the output
+				j = copy_bytes_ammount & ~7u;
+				RpakCopyWide((uint8_t*)out_seekd, (const uint8_t*)in_seekd, j, UINT64_MAX);
+				out_seekd = (int64_t*)((char*)out_seekd + j);
+				in_seekd = (int64_t*)((char*)in_seekd + j);
+
+				if ((copy_bytes_ammount & 4) != 0)    // copy by 4
+				{
+					*(uint32_t*)out_seekd = *(uint32_t*)in_seekd;
+					out_seekd = (int64_t*)((char*)out_seekd + 4);
+					in_seekd = (int64_t*)((char*)in_seekd + 4);
+				}
+
+				if ((copy_bytes_ammount & 2) != 0)    // copy by 2
+				{
+					*(uint16_t*)out_seekd = *(uint16_t*)in_seekd;
+					out_seekd = (int64_t*)((char*)out_seekd + 2);
+					in_seekd = (int64_t*)((char*)in_seekd + 2);
+				}
+
+				if ((copy_bytes_ammount & 1) != 0)    // copy by 1
+					*(uint8_t*)out_seekd = *(uint8_t*)in_seekd;
+
+				input_byte_pos += copy_bytes_ammount;
+				decompressed_position += copy_bytes_ammount;
+			}
+			else
+			{
+				_mm_storeu_si128((__m128i*)out_seekd, _mm_loadu_si128((const __m128i*)in_seekd));
+				input_byte_pos += lut0_val_abs;
+				decompressed_position += lut0_val_abs;
+			}
+		}
+		else
+		{
+			byte_4bits_1 = byte_new & 0xF;
+			dword6C = 0;
+			v21 = ((uint64_t)(uint32_t)byte_new >> (((uint32_t)(byte_4bits_1 + 0xFFFFFFE1) >> 3) & 6)) & 0x3F;// 6 bits after shift for who knows how much???
+			distance = &LUT_Distance[v21];
+			v22 = 1 << (byte_4bits_1 + ((byte_new >> 4) & ((24 * (((uint32_t)(byte_4bits_1 + 0xFFFFFFE1) >> 3) & 2)) >> 4)));// ammount of bits to read???
+			byte_bit_offset += (((uint32_t)(byte_4bits_1 + 0xFFFFFFE1) >> 3) & 6)// shit shit gets shifted by ammount of bits it read or something
+				+ distance->Bits
+				+ byte_4bits_1
+				+ ((byte_new >> 4) & ((24 * (((uint32_t)(byte_4bits_1 + 0xFFFFFFE1) >> 3) & 2)) >> 4));
+			out_mask = state->out_mask;
+			v24 = 16
+				* (v22
+					+ ((v22 - 1) & (byte_new >> ((((uint32_t)(byte_4bits_1 + 0xFFFFFFE1) >> 3) & 6)
+						+ distance->Bits))));
+			byte_new >>= (((uint32_t)(byte_4bits_1 + 0xFFFFFFE1) >> 3) & 6)
+				+ distance->Bits
+				+ byte_4bits_1
+				+ ((byte_new >> 4) & ((24 * (((uint32_t)(byte_4bits_1 + 0xFFFFFFE1) >> 3) & 2)) >> 4));
+			LUT_400_seek_backwards = v24 + distance->Base - 16;// LUT_400 - u8 - seek backwards
+			out_seek_back = out_mask & (decompressed_position - LUT_400_seek_backwards);
+			out_seekd_1 = state->out + (decompressed_position & out_mask);
+			out_seekd_back = (uint64_t*)(state->out + out_seek_back);
+			if ((int32_t)LUT_0_VAL == 17)
+			{
+				v39 = byte_new;
+				v40 = byte_new >> 3;
+				byte_3bits = v39 & 7;
+				byte_new_tmp = v40;
+				if (byte_3bits)
+				{
+					length = &LUT_ShortLength[byte_3bits];
+					LUT_4D0_480 = length->Base;
+					LUT_4D8_4C0_nBits = length->Bits;
+				}
+				else
+				{
+					byte_bit_offset += 4;
+					byte_4bits = v40 & 0xF;
+					byte_new_tmp = v40 >> 4;
+					length = &LUT_LongLength[byte_4bits];
+					LUT_4D0_480 = length->Base;
+					LUT_4D8_4C0_nBits = length->Bits;
+					if (state->input_buf && byte_bit_offset + LUT_4D8_4C0_nBits >= 0x3D)
+					{
+						v46 = input_byte_pos++ & state->mask;
+						byte_new_tmp |= (uint64_t)*(uint8_t*)(v46 + state->input_buf) << (61
+							- (uint8_t)byte_bit_offset);
+						byte_bit_offset -= 8;
+					}
+				}
+				byte_bit_offset += LUT_4D8_4C0_nBits + 3;
+				byte_new = byte_new_tmp >> LUT_4D8_4C0_nBits;
+				v47 = ((uint32_t)byte_new_tmp & ((1 << LUT_4D8_4C0_nBits) - 1)) + LUT_4D0_480 + 17;
+				decompressed_position += v47;
+				if (LUT_400_seek_backwards < 8)
+				{
+					v49 = v47 - 13;
+					decompressed_position -= 13i64;
+					if (LUT_400_seek_backwards == 1)    // 1 means copy v49 qwords?
+					{
+						v50 = *(uint8_t*)out_seekd_back;
+						v51 = 0i64;
+						k = 0x101010101010101i64 * v50;
+
+						// fill 16 bytes at a time, then by 8 like before
+						const __m128i run = _mm_set1_epi64x(k);
+						for (; (uint32_t)v51 + 16 <= ((v49 + 7) & ~7u); v51 = (uint32_t)(v51 + 16))
+							_mm_storeu_si128((__m128i*)(v51 + out_seekd_1), run);
+
+						for (; (uint32_t)v51 < v49; v51 = (uint32_t)(v51 + 8))
+							*(uint64_t*)(v51 + out_seekd_1) = k;
+					}
+					else
+					{
+						if (v49)
+						{
+							v53 = (char*)out_seekd_back - out_seekd_1;
+							v54 = v49;
+							do
+							{
+								*(uint8_t*)out_seekd_1 = v53[out_seekd_1];// seekd = seek_back; increment ptrs
+								++out_seekd_1;
+								--v54;
+							} while (v54);
+						}
+					}
+				}
+				else
+				{
+					// the same 8 byte aligned range as before, in chunks as wide as the distance allows
+					RpakCopyWide((uint8_t*)out_seekd_1, (const uint8_t*)out_seekd_back, ((uint32_t)v47 + 7) & ~7u, LUT_400_seek_backwards);
+				}
+			}
+			else
+			{
+				decompressed_position += LUT_0_VAL;
+				if (LUT_400_seek_backwards >= 16)
+				{
+					_mm_storeu_si128((__m128i*)out_seekd_1, _mm_loadu_si128((const __m128i*)out_seekd_back));
+				}
+				else
+				{
+					*(uint64_t*)out_seekd_1 = *out_seekd_back;
+					*(uint64_t*)(out_seekd_1 + 8) = out_seekd_back[1];
+				}
+			}
+		}
+		if (input_byte_pos >= some_size)
+			break;
+
+	LABEL_26:
+		v12 = (*(uint64_t*)((input_byte_pos & state->mask) + state->input_buf) << (64 - (uint8_t)byte_bit_offset)) | byte_new;
+	}
+
+	if (decompressed_position != state->stream_decompressed_size)
+		goto LABEL_22;
+
+	decompressed_size = state->decompressed_size;
+	if (decompressed_position == decompressed_size)
+	{
+		state->input_byte_pos = input_byte_pos;
+		result = 1;
+		state->decompressed_position = decompressed_position;
+		return result;
+	}
+
+	inv_mask_in = state->inv_mask_in;
+	header_skip_bytes_bs = state->header_skip_bytes_bs;
+	v32 = inv_mask_in & -(int64_t)input_byte_pos;
+	byte_new >>= 1;
+	++byte_bit_offset;
+
+	if (header_skip_bytes_bs > v32)
+	{
+		input_byte_pos += v32;
+		v33 = state->qword70;
+		if (input_byte_pos > v33)
+			state->qword70 = inv_mask_in + v33 + 1;
+	}
+
+	v34 = input_byte_pos & state->mask;
+	input_byte_pos += header_skip_bytes_bs;
+	stream_decompressed_size_new = decompressed_position + state->inv_mask_out + 1;
+	v36 = *(uint64_t*)(v34 + state->input_buf) & ((1LL << (8 * (uint8_t)header_skip_bytes_bs)) - 1);
+	len_needed_new = v36 + state->len_needed;
+	stream_compressed_size_new = v36 + state->stream_compressed_size;
+	state->len_needed = len_needed_new;
+	state->stream_compressed_size = stream_compressed_size_new;
+
+	if (stream_decompressed_size_new >= decompressed_size)
+	{
+		stream_decompressed_size_new = decompressed_size;
+		state->stream_compressed_size = header_skip_bytes_bs + stream_compressed_size_new;
+	}
+
+	state->stream_decompressed_size = stream_decompressed_size_new;
+
+	if (inLen >= len_needed_new && outLen >= stream_decompressed_size_new)
+	{
+	LABEL_22:
+		some_size = state->qword70;
+		if (input_byte_pos >= some_size)
+		{
+			input_byte_pos = ~state->inv_mask_in & (input_byte_pos + 7);
+			some_size += state->inv_mask_in + 1;
+			state->qword70 = some_size;
+		}
+		if (state->stream_compressed_size < some_size)
+			some_size = state->stream_compressed_size;
+		goto LABEL_26;
+	}
+
+	v68 = state->qword70;
+
+	if (input_byte_pos >= v68)
+	{
+		input_byte_pos = ~inv_mask_in & (input_byte_pos + 7);
+		state->qword70 = v68 + inv_mask_in + 1;
+	}
+
+	state->dword6C = dword6C;
+	result = 0;
+	state->input_byte_pos = input_byte_pos;
+	state->decompressed_position = decompressed_position;
+	state->byte = byte_new;
+	state->byte_bit_offset = byte_bit_offset;
+
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: decompress input pakfile (the original decoder, kept as a reference
+//          for verifying and benchmarking DecompressPakFile)
+//-----------------------------------------------------------------------------
+uint8_t __fastcall RTech::DecompressPakFileReference(rpak_decomp_state* state, uint64_t inLen, uint64_t outLen)
 {
 	uint64_t decompressed_position; // r15
 	uint32_t byte_bit_offset; // ebp
@@ -2268,15 +2718,27 @@ bool RTech::DecompressSnowflake(int64_t param_buffer, uint64_t data_size, uint64
 //-----------------------------------------------------------------------------
 // Purpose: decompress input animation data
 //-----------------------------------------------------------------------------
-// 0x1401C93C0 - ExtractAnimValue
-float* __fastcall RTech::ExtractAnimValue(int frame_count, uint8_t* in_translation_buffer, float translation_scale, float* out_translation_buffer, float* time_scale)
+// The size of an anim value run in shorts is [0] + (([1] + FrameCount * [2]) >> 4), indexed by three times the run's type
+static constexpr uint8_t LUT_AnimValueRunSize[64] =
+{
+	0x01, 0x0F, 0x10, 0x02, 0x07, 0x08, 0x02, 0x0F, 0x00, 0x03, 0x0F, 0x00, 0x04, 0x0F, 0x00, 0x05,
+	0x0F, 0x00, 0x06, 0x0F, 0x00, 0x07, 0x0F, 0x00, 0x02, 0x0F, 0x02, 0x03, 0x0F, 0x02, 0x04, 0x0F,
+	0x02, 0x05, 0x0F, 0x02, 0x06, 0x0F, 0x02, 0x07, 0x0F, 0x02, 0x02, 0x0F, 0x04, 0x03, 0x0F, 0x04,
+	0x04, 0x0F, 0x04, 0x05, 0x0F, 0x04, 0x06, 0x0F, 0x04, 0x07, 0x0F, 0x04, 0x00, 0x00, 0x00, 0x00
+};
+
+uint8_t* RTech::NextAnimValueRun(uint8_t* Run)
+{
+	const uint8_t* Size = &LUT_AnimValueRunSize[3 * Run[0]];
+
+	return Run + 2 * (Size[0] + ((uint64_t)(Size[1] + Run[1] * (unsigned int)Size[2]) >> 4));
+}
+
+// Decodes a frame from the run that contains it, v5 is the frame relative to the start of the run
+static float* __fastcall ExtractAnimValueFromRun(uint8_t* v9, int v5, float translation_scale, float* out_translation_buffer, float* time_scale)
 {
-	int           v5; // er10
-	int64_t       v6; // rcx
 	float*        v7; // rdi
 	float         v8; // xmm15_4
-	uint8_t*      v9; // rbx
-	int          v10; // eax
 	int          v11; // er11
 	int          v12; // er8
 	int          v13; // er8
@@ -2311,47 +2773,15 @@ float* __fastcall RTech::ExtractAnimValue(int frame_count, uint8_t* in_translati
 	float        v42; // [rsp+F0h] [rbp+8h]
 	float        v43; // [rsp+F8h] [rbp+10h]
 	float        v44; // [rsp+100h] [rbp+18h]
-	int      v73[16];
-
-	v73[0] = 0x2100F01;
-	v73[1] = 0xF020807;
-	v73[2] = 0xF0300;
-	v73[3] = 0x5000F04;
-	v73[4] = 0xF06000F;
-	v73[5] = 0xF0700;
-	v73[6] = 0x3020F02;
-	v73[7] = 0xF04020F;
-	v73[8] = 0x20F0502;
-	v73[9] = 0x7020F06;
-	v73[10] = 0xF02020F;
-	v73[11] = 0x40F0304;
-	v73[12] = 0x5040F04;
-	v73[13] = 0xF06040F;
-	v73[14] = 0x40F0704;
 
 	v44 = translation_scale;
-	v5 = frame_count;
-	LODWORD(v6) = in_translation_buffer[1];
 	v7 = out_translation_buffer;
 	v8 = translation_scale;
-	v9 = in_translation_buffer;
-	if (v5 >= (int)v6)
-	{
-		LOBYTE(v10) = v6;
-		do
-		{
-			v5 -= (uint8_t)v6;
-			v6 = *((uint8_t*)v73 + 3 * *v9) + ((uint64_t)(*((uint8_t*)v73 + 3 * *v9 + 1) + (uint8_t)v10 * (unsigned int)*((uint8_t*)v73 + 3 * *v9 + 2)) >> 4);
-			v10 = v9[2 * v6 + 1];
-			v9 += 2 * v6;
-			LOBYTE(v6) = v10;
-		} while (v5 >= v10);
-	}
 	v11 = v9[1] - 1;
 	if (v5 >= v11)
 	{
-		*out_translation_buffer = FrameToEulerTranslation(v9, v5, translation_scale);
-		v41 = FrameToEulerTranslation(v9, 0, translation_scale);
+		*out_translation_buffer = RTech::FrameToEulerTranslation(v9, v5, translation_scale);
+		v41 = RTech::FrameToEulerTranslation(v9, 0, translation_scale);
 		result = time_scale;
 		*time_scale = v41;
 	}
@@ -2462,6 +2892,136 @@ float* __fastcall RTech::ExtractAnimValue(int frame_count, uint8_t* in_translati
 	return result;
 }
 
+// 0x1401C93C0 - ExtractAnimValue
+float* __fastcall RTech::ExtractAnimValue(int frame_count, uint8_t* in_translation_buffer, float translation_scale, float* out_translation_buffer, float* time_scale)
+{
+	uint8_t* Run = in_translation_buffer;
+	int Frame = frame_count;
+
+	// Skip over the runs that end before the frame
+	while (Frame >= Run[1])
+	{
+		Frame -= Run[1];
+		Run = NextAnimValueRun(Run);
+	}
+
+	return ExtractAnimValueFromRun(Run, Frame, translation_scale, out_translation_buffer, time_scale);
+}
+
+void RTech::ExtractAnimValues(int first_frame, uint32_t frame_count, uint8_t* in_translation_buffer, float translation_scale, float* out_translation_buffer, float* time_scale)
+{
+	uint8_t* Run = in_translation_buffer;
+	int Frame = first_frame;
+	uint32_t i = 0;
+
+	while (i < frame_count)
+	{
+		// Frames only move forward, so each run is skipped once instead of once per frame
+		while (Frame >= Run[1])
+		{
+			Frame -= Run[1];
+			Run = NextAnimValueRun(Run);
+		}
+
+		// Raw runs store a short per frame, every frame but the last is a plain scale of it and the next one
+		if (Run[0] == 0 && Frame < Run[1] - 1)
+		{
+			const int16_t* Values = (const int16_t*)Run + 1 + Frame;
+			const uint32_t Count = min((uint32_t)(Run[1] - 1 - Frame), frame_count - i);
+			uint32_t k = 0;
+
+			if (System::Environment::IsAvx2Supported())
+			{
+				const __m256 Scale = _mm256_set1_ps(translation_scale);
+
+				for (; k + 8 <= Count; k += 8)
+				{
+					__m256 Value = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(Values + k))));
+					__m256 Next = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(Values + k + 1))));
+
+					_mm256_storeu_ps(out_translation_buffer + i + k, _mm256_mul_ps(Value, Scale));
+					_mm256_storeu_ps(time_scale + i + k, _mm256_mul_ps(Next, Scale));
+				}
+			}
+
+			for (; k < Count; k++)
+			{
+				out_translation_buffer[i + k] = (float)Values[k] * translation_scale;
+				time_scale[i + k] = (float)Values[k + 1] * translation_scale;
+			}
+
+			i += Count;
+			Frame += Count;
+			continue;
+		}
+
+		ExtractAnimValueFromRun(Run, Frame, translation_scale, out_translation_buffer + i, time_scale + i);
+
+		i++;
+		Frame++;
+	}
+}
+
+Quaternion RTech::UnpackQuat64(uint64_t packed_quat)
+{
+	Quaternion Quat;
+
+	Quat.X = ((int)(packed_quat & 0x1FFFFF) - 0x100000) * (1 / 1048576.5f);
+	Quat.Y = ((int)((packed_quat >> 21) & 0x1FFFFF) - 0x100000) * (1 / 1048576.5f);
+	Quat.Z = ((int)((packed_quat >> 42) & 0x1FFFFF) - 0x100000) * (1 / 1048576.5f);
+	Quat.W = std::sqrt(1 - Quat.X * Quat.X - Quat.Y * Quat.Y - Quat.Z * Quat.Z);
+
+	if (packed_quat >> 63)
+		Quat.W = -Quat.W;
+
+	return Quat;
+}
+
+void RTech::UnpackQuat64Batch(const uint64_t* packed_quats, Quaternion* out_quats, uint32_t count)
+{
+	static_assert(sizeof(Quaternion) == (sizeof(float) * 4), "Quaternion must be tightly packed");
+
+	uint32_t i = 0;
+
+	if (System::Environment::IsAvx2Supported())
+	{
+		const __m256i ComponentMask = _mm256_set1_epi64x(0x1FFFFF);
+		const __m256i LowDwords = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+		const __m128i Bias = _mm_set1_epi32(0x100000);
+		const __m128 Scale = _mm_set1_ps(1 / 1048576.5f);
+		const __m128 One = _mm_set1_ps(1.0f);
+
+		for (; i + 4 <= count; i += 4)
+		{
+			__m256i Packed = _mm256_loadu_si256((const __m256i*)(packed_quats + i));
+
+			// Move each component into the low dword of it's lane, then gather the low dwords
+			__m128i XBits = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(_mm256_and_si256(Packed, ComponentMask), LowDwords));
+			__m128i YBits = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(_mm256_and_si256(_mm256_srli_epi64(Packed, 21), ComponentMask), LowDwords));
+			__m128i ZBits = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(_mm256_and_si256(_mm256_srli_epi64(Packed, 42), ComponentMask), LowDwords));
+			__m128i WSign = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(_mm256_slli_epi64(_mm256_srli_epi64(Packed, 63), 31), LowDwords));
+
+			__m128 X = _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(XBits, Bias)), Scale);
+			__m128 Y = _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(YBits, Bias)), Scale);
+			__m128 Z = _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(ZBits, Bias)), Scale);
+
+			// Same order as the scalar code so the result is bit exact
+			__m128 W = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(One, _mm_mul_ps(X, X)), _mm_mul_ps(Y, Y)), _mm_mul_ps(Z, Z));
+			W = _mm_xor_ps(_mm_sqrt_ps(W), _mm_castsi128_ps(WSign));
+
+			_MM_TRANSPOSE4_PS(X, Y, Z, W);
+
+			_mm_storeu_ps(&out_quats[i + 0].X, X);
+			_mm_storeu_ps(&out_quats[i + 1].X, Y);
+			_mm_storeu_ps(&out_quats[i + 2].X, Z);
+			_mm_storeu_ps(&out_quats[i + 3].X, W);
+		}
+	}
+
+	for (; i < count; i++)
+		out_quats[i] = UnpackQuat64(packed_quats[i]);
+}
+
 //-----------------------------------------------------------------------------
 // Purpose: convert bone rotations from input
 //-----------------------------------------------------------------------------
@@ -2691,22 +3251,11 @@ std::unique_ptr<IO::MemoryStream> RTech::DecompressStreamedBuffer(const uint8_t*
 	}
 	case CompressionType::OODLE:
 	{
-		int SizeNeeded = OodleLZDecoder_MemorySizeNeeded(OodleLZ_Compressor_Invalid, -1);
-
-		uint8_t* Decoder = new uint8_t[SizeNeeded]{};
 		uint8_t* OutBuf_ = new uint8_t[DataSize + OodleOutBufOffset]{};
-		uint8_t* OutBuf = OutBuf_ + OodleOutBufOffset;
 
-		OodleLZDecoder_Create(OodleLZ_Compressor::OodleLZ_Compressor_Invalid, DataSize, Decoder, SizeNeeded);
-
-		int DecPos = 0;
-		int DataPos = 0;
-
-		OodleLZ_DecodeSome_Out out{};
-		if (!OodleLZDecoder_DecodeSome((OodleLZDecoder*)Decoder, &out, OutBuf, DecPos, DataSize, DataSize - DecPos, Data + DataPos, DataSize - DataPos, OodleLZ_FuzzSafe_No, OodleLZ_CheckCRC_No, OodleLZ_Verbosity::OodleLZ_Verbosity_None, OodleLZ_Decode_ThreadPhaseAll))
+		if (!RTech::DecompressOodleBuffer(Data, DataSize, OutBuf_ + OodleOutBufOffset, DataSize))
 		{
 			// If it fails it shouldn't be compressed?
-			delete[] Decoder;
 			delete[] OutBuf_;
 
 			if (!OodleReturnDataOnError)
@@ -2714,25 +3263,13 @@ std::unique_ptr<IO::MemoryStream> RTech::DecompressStreamedBuffer(const uint8_t*
 				return nullptr;
 			}
 
-			return std::make_unique<IO::MemoryStream>(const_cast<uint8_t*>(Data), 0, DataSize, true, true);
-		}
-
-		while (true)
-		{
-			DecPos += out.decodedCount;
-			DataPos += out.compBufUsed;
-
-			if (out.compBufUsed + out.decodedCount == 0)
-				break;
-
-			if (DecPos >= DataSize)
-				break;
+			// The caller keeps ownership of it's buffer, so the stream gets a copy
+			uint8_t* Copy = new uint8_t[DataSize];
+			std::memcpy(Copy, Data, DataSize);
 
-			bool DecodeResult = OodleLZDecoder_DecodeSome((OodleLZDecoder*)Decoder, &out, OutBuf, DecPos, DataSize, DataSize - DecPos, Data + DataPos, DataSize - DataPos, OodleLZ_FuzzSafe_No, OodleLZ_CheckCRC_No, OodleLZ_Verbosity::OodleLZ_Verbosity_None, OodleLZ_Decode_ThreadPhaseAll);
+			return std::make_unique<IO::MemoryStream>(Copy, 0, DataSize, true, false);
 		}
 
-		delete[] Decoder;
-		delete[] Data;
 		return std::make_unique<IO::MemoryStream>(OutBuf_, 0, DataSize + OodleOutBufOffset, true, false);
 	}
 	default:
@@ -2788,3 +3325,43 @@ unsigned int __fastcall RTech::PakPatch_DecodeData(char* in_data, int numbits, c
 	return out_index;
 }
 ///////////////////////////////////////////////////////////////////////////////
+
+bool RTech::DecompressOodleBuffer(const uint8_t* Data, uint64_t DataSize, uint8_t* Output, uint64_t OutputSize)
+{
+	// The decoder state is only used for the duration of a call, so every thread keeps it's own
+	static thread_local std::unique_ptr<uint8_t[]> DecoderScratch = nullptr;
+	static thread_local int DecoderScratchSize = 0;
+
+	if (!DecoderScratch)
+	{
+		DecoderScratchSize = OodleLZDecoder_MemorySizeNeeded(OodleLZ_Compressor_Invalid, -1);
+		DecoderScratch = std::make_unique<uint8_t[]>(DecoderScratchSize);
+	}
+
+	uint8_t* Decoder = DecoderScratch.get();
+
+	OodleLZDecoder_Create(OodleLZ_Compressor::OodleLZ_Compressor_Invalid, OutputSize, Decoder, DecoderScratchSize);
+
+	int DecPos = 0;
+	int DataPos = 0;
+
+	OodleLZ_DecodeSome_Out out{};
+	if (!OodleLZDecoder_DecodeSome((OodleLZDecoder*)Decoder, &out, Output, DecPos, OutputSize, OutputSize - DecPos, Data + DataPos, DataSize - DataPos, OodleLZ_FuzzSafe_No, OodleLZ_CheckCRC_No, OodleLZ_Verbosity::OodleLZ_Verbosity_None, OodleLZ_Decode_ThreadPhaseAll))
+		return false;
+
+	while (true)
+	{
+		DecPos += out.decodedCount;
+		DataPos += out.compBufUsed;
+
+		if (out.compBufUsed + out.decodedCount == 0)
+			break;
+
+		if (DecPos >= OutputSize)
+			break;
+
+		OodleLZDecoder_DecodeSome((OodleLZDecoder*)Decoder, &out, Output, DecPos, OutputSize, OutputSize - DecPos, Data + DataPos, DataSize - DataPos, OodleLZ_FuzzSafe_No, OodleLZ_CheckCRC_No, OodleLZ_Verbosity::OodleLZ_Verbosity_None, OodleLZ_Decode_ThreadPhaseAll);
+	}
+
+	return true;
+}
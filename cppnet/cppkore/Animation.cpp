@@ -27,6 +27,87 @@ namespace Assets
 		return Curves[NodeName];
 	}
 
+	const Dictionary<string, List<Curve>>& Animation::GetCurves() const
+	{
+		// The tracks are just the unconverted form of the curves, resolving them doesn't change the animation
+		if (Tracks.IsInitialized())
+			const_cast<Animation*>(this)->ResolveTracks();
+
+		return Curves;
+	}
+
+	void Animation::ResolveTracks()
+	{
+		if (!Tracks.IsInitialized())
+			return;
+
+		const auto Mode = Tracks.Mode();
+		const auto FrameCount = Tracks.FrameCount();
+
+		for (uint32_t b = 0; b < Tracks.BoneCount() && b < Bones.Count(); b++)
+		{
+			const string& BoneName = Bones[b].Name();
+			List<Curve>& CurveNodes = GetNodeCurves(BoneName);
+
+			bool HasRotation = false, HasTranslation = false, HasScale = false;
+
+			for (uint32_t f = 0; f < FrameCount; f++)
+			{
+				HasRotation |= Tracks.HasChannel(b, f, AnimationTrackChannel::Rotation);
+				HasTranslation |= Tracks.HasChannel(b, f, AnimationTrackChannel::Translation);
+				HasScale |= Tracks.HasChannel(b, f, AnimationTrackChannel::Scale);
+			}
+
+			if (HasRotation)
+			{
+				auto& Rotation = CurveNodes.Emplace(BoneName, CurveProperty::RotateQuaternion, Mode);
+
+				const float* X = Tracks.Track(AnimationTrackComponent::RotateX, b);
+				const float* Y = Tracks.Track(AnimationTrackComponent::RotateY, b);
+				const float* Z = Tracks.Track(AnimationTrackComponent::RotateZ, b);
+				const float* W = Tracks.Track(AnimationTrackComponent::RotateW, b);
+
+				for (uint32_t f = 0; f < FrameCount; f++)
+				{
+					if (Tracks.HasChannel(b, f, AnimationTrackChannel::Rotation))
+						Rotation.Keyframes.Emplace(f, Math::Quaternion(X[f], Y[f], Z[f], W[f]));
+				}
+			}
+
+			if (HasTranslation)
+			{
+				for (uint32_t c = 0; c < 3; c++)
+				{
+					auto& Translation = CurveNodes.Emplace(BoneName, (CurveProperty)((uint32_t)CurveProperty::TranslateX + c), Mode);
+					const float* Values = Tracks.Track((AnimationTrackComponent)((uint32_t)AnimationTrackComponent::TranslateX + c), b);
+
+					for (uint32_t f = 0; f < FrameCount; f++)
+					{
+						if (Tracks.HasChannel(b, f, AnimationTrackChannel::Translation))
+							Translation.Keyframes.EmplaceBack(f, Values[f]);
+					}
+				}
+			}
+
+			if (HasScale)
+			{
+				for (uint32_t c = 0; c < 3; c++)
+				{
+					auto& Scale = CurveNodes.Emplace(BoneName, (CurveProperty)((uint32_t)CurveProperty::ScaleX + c), Mode);
+					const float* Values = Tracks.Track((AnimationTrackComponent)((uint32_t)AnimationTrackComponent::ScaleX + c), b);
+
+					for (uint32_t f = 0; f < FrameCount; f++)
+					{
+						if (Tracks.HasChannel(b, f, AnimationTrackChannel::Scale))
+							Scale.Keyframes.EmplaceBack(f, Values[f]);
+					}
+				}
+			}
+		}
+
+		Tracks.Clear();
+	}
+
 	void Animation::AddNotification(const string& Name, uint32_t Frame)
 	{
 		if (Notificiations.ContainsKey(Name))
@@ -40,7 +121,7 @@ namespace Assets
 	{
 		uint32_t Result = 0;
 
-		for (auto& Kvp : Curves)
+		for (auto& Kvp : GetCurves())
 		{
 			for (auto& Curve : Kvp.Value())
 			{
@@ -84,6 +165,8 @@ namespace Assets
 
 	void Animation::Scale(float Factor)
 	{
+		ResolveTracks();
+
 		for (auto& Kvp : Curves)
 		{
 			for (auto& Curve : Kvp.Value())
@@ -114,6 +197,8 @@ namespace Assets
 
 	void Animation::RemoveEmptyNodes()
 	{
+		ResolveTracks();
+
 		for (auto& Kvp : Curves)
 		{
 			for (int32_t i = ((int32_t)Kvp.Value().Count() - 1); i >= 0; i--)
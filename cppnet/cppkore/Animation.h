@@ -11,6 +11,7 @@
 #include "Quaternion.h"
 #include "AnimationTypes.h"
 #include "Curve.h"
+#include "AnimationTrackBuffer.h"
 
 namespace Assets
 {
@@ -30,13 +31,19 @@ namespace Assets
 
 		// A collection of 3D bones for this animation. (May or may not represent the actual skeleton)
 		List<Bone> Bones;
-		// The collection of curves that make up this animation.
+		// The collection of curves that make up this animation. (Read them through GetCurves() to include decoded tracks)
 		Dictionary<string, List<Curve>> Curves;
+		// Dense bone tracks written by decoders, converted to curves the first time they're needed.
+		AnimationTrackBuffer Tracks;
 		// A collection of notifications that may occur.
 		Dictionary<string, List<uint32_t>> Notificiations;
 
 		// Gets a reference to a list of node curves.
 		List<Curve>& GetNodeCurves(const string& NodeName);
+		// Gets the curves of this animation, converting any decoded tracks first.
+		const Dictionary<string, List<Curve>>& GetCurves() const;
+		// Converts any decoded tracks to curves, channels without keys don't get a curve.
+		void ResolveTracks();
 		// Adds a notification to the animation.
 		void AddNotification(const string& Name, uint32_t Frame);
 
@@ -0,0 +1,104 @@
+#include "stdafx.h"
+#include "AnimationTrackBuffer.h"
+
+namespace Assets
+{
+	AnimationTrackBuffer::AnimationTrackBuffer()
+		: _BoneCount(0), _FrameCount(0), _Mode(AnimationCurveMode::Absolute), _Values(nullptr), _Channels(nullptr)
+	{
+	}
+
+	void AnimationTrackBuffer::Initialize(uint32_t BoneCount, uint32_t FrameCount, AnimationCurveMode Mode)
+	{
+		const uint64_t KeyCount = (uint64_t)BoneCount * FrameCount;
+
+		this->_BoneCount = BoneCount;
+		this->_FrameCount = FrameCount;
+		this->_Mode = Mode;
+
+		// Values are only read where a channel was marked, so they don't need clearing
+		this->_Values.reset(new float[KeyCount * (uint64_t)AnimationTrackComponent::Count]);
+		this->_Channels = std::make_unique<uint8_t[]>(KeyCount);
+	}
+
+	void AnimationTrackBuffer::Clear()
+	{
+		this->_BoneCount = 0;
+		this->_FrameCount = 0;
+		this->_Values.reset();
+		this->_Channels.reset();
+	}
+
+	bool AnimationTrackBuffer::IsInitialized() const
+	{
+		return (this->_Channels != nullptr);
+	}
+
+	uint32_t AnimationTrackBuffer::BoneCount() const
+	{
+		return this->_BoneCount;
+	}
+
+	uint32_t AnimationTrackBuffer::FrameCount() const
+	{
+		return this->_FrameCount;
+	}
+
+	AnimationCurveMode AnimationTrackBuffer::Mode() const
+	{
+		return this->_Mode;
+	}
+
+	float* AnimationTrackBuffer::Track(AnimationTrackComponent Component, uint32_t Bone)
+	{
+		return this->_Values.get() + (((uint64_t)Component * this->_BoneCount) + Bone) * this->_FrameCount;
+	}
+
+	const float* AnimationTrackBuffer::Track(AnimationTrackComponent Component, uint32_t Bone) const
+	{
+		return this->_Values.get() + (((uint64_t)Component * this->_BoneCount) + Bone) * this->_FrameCount;
+	}
+
+	bool AnimationTrackBuffer::HasChannel(uint32_t Bone, uint32_t Frame, AnimationTrackChannel Channel) const
+	{
+		return (this->_Channels[(uint64_t)Bone * this->_FrameCount + Frame] & (uint8_t)Channel) != 0;
+	}
+
+	void AnimationTrackBuffer::MarkChannel(uint32_t Bone, uint32_t Frame, AnimationTrackChannel Channel)
+	{
+		this->_Channels[(uint64_t)Bone * this->_FrameCount + Frame] |= (uint8_t)Channel;
+	}
+
+	void AnimationTrackBuffer::MarkChannels(uint32_t Bone, uint32_t FirstFrame, uint32_t FrameCount, AnimationTrackChannel Channel)
+	{
+		uint8_t* Channels = this->_Channels.get() + (uint64_t)Bone * this->_FrameCount + FirstFrame;
+
+		for (uint32_t f = 0; f < FrameCount; f++)
+			Channels[f] |= (uint8_t)Channel;
+	}
+
+	void AnimationTrackBuffer::SetRotation(uint32_t Bone, uint32_t Frame, const Math::Quaternion& Value)
+	{
+		this->Track(AnimationTrackComponent::RotateX, Bone)[Frame] = Value.X;
+		this->Track(AnimationTrackComponent::RotateY, Bone)[Frame] = Value.Y;
+		this->Track(AnimationTrackComponent::RotateZ, Bone)[Frame] = Value.Z;
+		this->Track(AnimationTrackComponent::RotateW, Bone)[Frame] = Value.W;
+		this->MarkChannel(Bone, Frame, AnimationTrackChannel::Rotation);
+	}
+
+	void AnimationTrackBuffer::SetTranslation(uint32_t Bone, uint32_t Frame, float X, float Y, float Z)
+	{
+		this->Track(AnimationTrackComponent::TranslateX, Bone)[Frame] = X;
+		this->Track(AnimationTrackComponent::TranslateY, Bone)[Frame] = Y;
+		this->Track(AnimationTrackComponent::TranslateZ, Bone)[Frame] = Z;
+		this->MarkChannel(Bone, Frame, AnimationTrackChannel::Translation);
+	}
+
+	void AnimationTrackBuffer::SetScale(uint32_t Bone, uint32_t Frame, float X, float Y, float Z)
+	{
+		this->Track(AnimationTrackComponent::ScaleX, Bone)[Frame] = X;
+		this->Track(AnimationTrackComponent::ScaleY, Bone)[Frame] = Y;
+		this->Track(AnimationTrackComponent::ScaleZ, Bone)[Frame] = Z;
+		this->MarkChannel(Bone, Frame, AnimationTrackChannel::Scale);
+	}
+}
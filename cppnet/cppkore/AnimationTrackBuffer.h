@@ -0,0 +1,86 @@
+#pragma once
+
+#include <memory>
+#include <cstdint>
+#include "Quaternion.h"
+#include "AnimationTypes.h"
+
+namespace Assets
+{
+	// The components of a bone track, each is stored as it's own array of frames
+	enum class AnimationTrackComponent : uint32_t
+	{
+		RotateX,
+		RotateY,
+		RotateZ,
+		RotateW,
+		TranslateX,
+		TranslateY,
+		TranslateZ,
+		ScaleX,
+		ScaleY,
+		ScaleZ,
+
+		Count
+	};
+
+	// The channels that can be written for a bone on a frame
+	enum class AnimationTrackChannel : uint8_t
+	{
+		Rotation = 0x1,
+		Translation = 0x2,
+		Scale = 0x4,
+	};
+
+	// A dense buffer of bone tracks, indexed by component, bone and frame.
+	// Decoders write keys directly into their slot, instead of building curves per frame.
+	class AnimationTrackBuffer
+	{
+	public:
+		AnimationTrackBuffer();
+
+		// Allocates the tracks for the given bone and frame count, discarding any previous tracks.
+		void Initialize(uint32_t BoneCount, uint32_t FrameCount, AnimationCurveMode Mode);
+		// Frees the tracks.
+		void Clear();
+
+		// Whether or not the tracks have been allocated.
+		bool IsInitialized() const;
+
+		// The count of bones in the buffer.
+		uint32_t BoneCount() const;
+		// The count of frames in the buffer.
+		uint32_t FrameCount() const;
+		// The mode every track is applied with.
+		AnimationCurveMode Mode() const;
+
+		// Gets every frame of a component of the bone's track.
+		float* Track(AnimationTrackComponent Component, uint32_t Bone);
+		// Gets every frame of a component of the bone's track.
+		const float* Track(AnimationTrackComponent Component, uint32_t Bone) const;
+
+		// Whether or not the channel was written for the bone on the frame.
+		bool HasChannel(uint32_t Bone, uint32_t Frame, AnimationTrackChannel Channel) const;
+		// Marks the channel as written for the bone on the frame.
+		void MarkChannel(uint32_t Bone, uint32_t Frame, AnimationTrackChannel Channel);
+		// Marks the channel as written for the bone on a run of frames.
+		void MarkChannels(uint32_t Bone, uint32_t FirstFrame, uint32_t FrameCount, AnimationTrackChannel Channel);
+
+		// Writes the rotation of the bone on the frame.
+		void SetRotation(uint32_t Bone, uint32_t Frame, const Math::Quaternion& Value);
+		// Writes the translation of the bone on the frame.
+		void SetTranslation(uint32_t Bone, uint32_t Frame, float X, float Y, float Z);
+		// Writes the scale of the bone on the frame.
+		void SetScale(uint32_t Bone, uint32_t Frame, float X, float Y, float Z);
+
+	private:
+		uint32_t _BoneCount;
+		uint32_t _FrameCount;
+		AnimationCurveMode _Mode;
+
+		// Every component, bone and frame, in that order
+		std::unique_ptr<float[]> _Values;
+		// The written channels of each bone and frame
+		std::unique_ptr<uint8_t[]> _Channels;
+	};
+}
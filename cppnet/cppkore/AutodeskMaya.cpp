@@ -17,6 +17,7 @@ namespace Assets::Exporters
 	bool AutodeskMaya::ExportModel(const Model& Model, const string& Path)
 	{
 		auto Writer = IO::StreamWriter(IO::File::Create(Path));
+		Writer.SetBufferSize(IO::StreamWriter::ExportBufferSize);
 		auto FileName = IO::Path::GetFileNameWithoutExtension(Path);
 		auto Hash = Hashing::CRC32::HashString(FileName);
 
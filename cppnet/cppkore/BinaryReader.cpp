@@ -76,12 +76,36 @@ namespace IO
 			IOError::StreamBaseStream();
 
 		string Buffer = "";
-		
-		char Cur = this->Read<char>();
-		while ((uint8_t)Cur > 0)
+
+		uint64_t Available = 0;
+		auto Data = this->BaseStream->PeekBuffer(Available);
+
+		// Streams without a buffer are read a byte at a time
+		if (Data == nullptr)
 		{
-			Buffer += Cur;
-			Cur = this->Read<char>();
+			char Cur = this->Read<char>();
+			while ((uint8_t)Cur > 0)
+			{
+				Buffer += Cur;
+				Cur = this->Read<char>();
+			}
+
+			return std::move(Buffer);
+		}
+
+		// Otherwise the terminator is searched for in the buffer, refilling it for strings that cross it's end
+		while (Data != nullptr && Available > 0)
+		{
+			auto Terminator = (const uint8_t*)std::memchr(Data, 0, (size_t)Available);
+			auto Length = (Terminator != nullptr) ? (uint64_t)(Terminator - Data) : Available;
+
+			Buffer.Append((char*)Data, (uint32_t)Length);
+			this->BaseStream->Advance((Terminator != nullptr) ? Length + 1 : Length);
+
+			if (Terminator != nullptr)
+				break;
+
+			Data = this->BaseStream->PeekBuffer(Available);
 		}
 
 		return std::move(Buffer);
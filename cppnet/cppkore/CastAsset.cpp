@@ -18,6 +18,356 @@ namespace Assets::Exporters
 	static_assert(sizeof(CastHeader) == 0x10, "Cast header size mismatch");
 	
 
+	// Stages node data into large chunks before it's written, so meshes and curves can be written straight from their buffers
+	class CastStreamBuffer
+	{
+	public:
+		CastStreamBuffer(IO::BinaryWriter& Writer)
+			: _Writer(Writer), _Buffer(std::make_unique<uint8_t[]>(BufferSize)), _Size(0)
+		{
+		}
+
+		template<typename T>
+		void Add(const T& Value)
+		{
+			this->AddRange(&Value, sizeof(T));
+		}
+
+		void AddRange(const void* Data, uint32_t Size)
+		{
+			if (this->_Size + Size > BufferSize)
+				this->Flush();
+
+			if (Size > BufferSize)
+			{
+				this->_Writer.Write((void*)Data, 0, Size);
+				return;
+			}
+
+			std::memcpy(this->_Buffer.get() + this->_Size, Data, Size);
+			this->_Size += Size;
+		}
+
+		void AddNode(CastId Id, uint32_t Length, uint64_t Hash, uint32_t PropertyCount, uint32_t ChildCount)
+		{
+			this->Add<CastNodeHeader>({ Id, Length, Hash, PropertyCount, ChildCount });
+		}
+
+		void AddProperty(CastPropertyId Id, const string& Name, uint32_t Count)
+		{
+			this->Add<CastPropertyHeader>({ Id, (uint16_t)Name.Length(), Count });
+
+			if (Name.Length() > 0)
+				this->AddRange((const char*)Name, Name.Length());
+		}
+
+		void AddString(CastPropertyId Id, const string& Name, const string& Value)
+		{
+			this->AddProperty(Id, Name, 1);
+
+			// An empty string has no buffer, only the terminator is written
+			if (Value.Length() > 0)
+				this->AddRange((const char*)Value, Value.Length());
+
+			this->Add<uint8_t>(0);
+		}
+
+		void Flush()
+		{
+			if (this->_Size == 0)
+				return;
+
+			this->_Writer.Write(this->_Buffer.get(), 0, this->_Size);
+			this->_Size = 0;
+		}
+
+	private:
+		IO::BinaryWriter& _Writer;
+		std::unique_ptr<uint8_t[]> _Buffer;
+		uint32_t _Size;
+
+		static constexpr uint32_t BufferSize = 0x100000;
+	};
+
+	// Gets the size of a string property
+	static uint32_t CastStringLength(uint32_t NameLength, const string& Value)
+	{
+		return sizeof(CastPropertyHeader) + NameLength + Value.Length() + sizeof(uint8_t);
+	}
+
+	// The element types of a curve's buffers, and the size of it's node
+	struct CastCurveLayout
+	{
+		CastPropertyId FrameProperty;
+		CastPropertyId ValueProperty;
+		uint32_t ValueCount;
+		uint32_t Length;
+	};
+
+	// Cast curve property mapping
+	constexpr const char* CastCurvePropertyNames[] =
+	{
+		"ex",
+		"rq",
+		"rx",
+		"ry",
+		"rz",
+		"tx",
+		"ty",
+		"tz",
+		"sx",
+		"sy",
+		"sz",
+		"vb"
+	};
+
+	constexpr const char* CastCurveModeNames[] =
+	{
+		"absolute",
+		"additive",
+		"relative"
+	};
+
+	static CastCurveLayout BuildCurveLayout(const Curve& Curve)
+	{
+		CastCurveLayout Result{ CastPropertyId::Float, CastPropertyId::Float, Curve.Keyframes.Count(), 0 };
+
+		switch (Curve.Property)
+		{
+		case CurveProperty::RotateQuaternion:
+			Result.ValueProperty = CastPropertyId::Vector4;
+			break;
+
+		case CurveProperty::RotateX:
+		case CurveProperty::RotateY:
+		case CurveProperty::RotateZ:
+		case CurveProperty::TranslateX:
+		case CurveProperty::TranslateY:
+		case CurveProperty::TranslateZ:
+		case CurveProperty::ScaleX:
+		case CurveProperty::ScaleY:
+		case CurveProperty::ScaleZ:
+			Result.ValueProperty = CastPropertyId::Float;
+			break;
+
+		case CurveProperty::Visibility:
+			Result.ValueProperty = CastPropertyId::Byte;
+			break;
+
+		default:
+			// Values of other properties aren't written
+			Result.ValueCount = 0;
+			break;
+		}
+
+		if (Curve.IsFrameIntegral())
+		{
+			uint32_t LargestFrameIndex = 0;
+			for (auto& KeyFrame : Curve.Keyframes)
+				LargestFrameIndex = max(LargestFrameIndex, KeyFrame.Frame.Integer32);
+
+			if (LargestFrameIndex <= 0xFF)
+				Result.FrameProperty = CastPropertyId::Byte;
+			else if (LargestFrameIndex <= 0xFFFF)
+				Result.FrameProperty = CastPropertyId::Short;
+			else
+				Result.FrameProperty = CastPropertyId::Integer32;
+		}
+
+		Result.Length = sizeof(CastNodeHeader)
+			+ CastStringLength(2, Curve.Name)
+			+ CastStringLength(2, CastCurvePropertyNames[(uint32_t)Curve.Property])
+			+ CastStringLength(1, CastCurveModeNames[(uint32_t)Curve.Mode])
+			+ CastProperty::Length(Result.FrameProperty, 2, Curve.Keyframes.Count())
+			+ CastProperty::Length(Result.ValueProperty, 2, Result.ValueCount);
+
+		return Result;
+	}
+
+	static void WriteCurve(CastStreamBuffer& Stream, const Curve& Curve, const CastCurveLayout& Layout)
+	{
+		Stream.AddNode(CastId::Curve, Layout.Length, 0, 5, 0);
+
+		Stream.AddString(CastPropertyId::String, "nn", Curve.Name);
+		Stream.AddString(CastPropertyId::String, "kp", CastCurvePropertyNames[(uint32_t)Curve.Property]);
+		Stream.AddString(CastPropertyId::String, "m", CastCurveModeNames[(uint32_t)Curve.Mode]);
+
+		Stream.AddProperty(Layout.FrameProperty, "kb", Curve.Keyframes.Count());
+
+		for (auto& KeyFrame : Curve.Keyframes)
+		{
+			switch (Layout.FrameProperty)
+			{
+			case CastPropertyId::Float:
+				Stream.Add<float>(KeyFrame.Frame.Float);
+				break;
+			case CastPropertyId::Byte:
+				Stream.Add<uint8_t>((uint8_t)KeyFrame.Frame.Integer32);
+				break;
+			case CastPropertyId::Short:
+				Stream.Add<uint16_t>((uint16_t)KeyFrame.Frame.Integer32);
+				break;
+			case CastPropertyId::Integer32:
+				Stream.Add<uint32_t>(KeyFrame.Frame.Integer32);
+				break;
+			}
+		}
+
+		Stream.AddProperty(Layout.ValueProperty, "kv", Layout.ValueCount);
+
+		if (Layout.ValueCount == 0)
+			return;
+
+		for (auto& KeyFrame : Curve.Keyframes)
+		{
+			switch (Layout.ValueProperty)
+			{
+			case CastPropertyId::Vector4:
+				Stream.Add<Math::Quaternion>(KeyFrame.Value.Vector4);
+				break;
+			case CastPropertyId::Float:
+				Stream.Add<float>(KeyFrame.Value.Float);
+				break;
+			case CastPropertyId::Byte:
+				Stream.Add<uint8_t>(KeyFrame.Value.Byte);
+				break;
+			}
+		}
+	}
+
+	// The element types of a mesh's buffers, and the size of it's node
+	struct CastMeshLayout
+	{
+		CastPropertyId FaceProperty;
+		CastPropertyId WeightBoneProperty;
+		uint32_t PropertyCount;
+		uint32_t Length;
+	};
+
+	static CastMeshLayout BuildMeshLayout(const Mesh& Mesh, uint32_t BoneCount, bool HasMaterial)
+	{
+		CastMeshLayout Result{};
+
+		const uint32_t VertexCount = Mesh.Vertices.Count();
+		const uint32_t WeightCount = VertexCount * Mesh.Vertices.WeightCount();
+
+		if (VertexCount <= 0xFF)
+			Result.FaceProperty = CastPropertyId::Byte;
+		else if (VertexCount <= 0xFFFF)
+			Result.FaceProperty = CastPropertyId::Short;
+		else
+			Result.FaceProperty = CastPropertyId::Integer32;
+
+		if (BoneCount <= 0xFF)
+			Result.WeightBoneProperty = CastPropertyId::Byte;
+		else if (BoneCount <= 0xFFFF)
+			Result.WeightBoneProperty = CastPropertyId::Short;
+		else
+			Result.WeightBoneProperty = CastPropertyId::Integer32;
+
+		Result.PropertyCount = 8 + Mesh.Vertices.UVLayerCount() + (HasMaterial ? 1 : 0);
+		Result.Length = sizeof(CastNodeHeader)
+			+ CastProperty::Length(CastPropertyId::Vector3, 2, VertexCount)
+			+ CastProperty::Length(CastPropertyId::Vector3, 2, VertexCount)
+			+ CastProperty::Length(CastPropertyId::Integer32, 2, VertexCount)
+			+ CastProperty::Length(Result.FaceProperty, 1, Mesh.Faces.Count() * 3)
+			+ CastProperty::Length(CastPropertyId::Byte, 2, 1)
+			+ CastProperty::Length(CastPropertyId::Byte, 2, 1)
+			+ CastProperty::Length(Result.WeightBoneProperty, 2, WeightCount)
+			+ CastProperty::Length(CastPropertyId::Float, 2, WeightCount);
+
+		for (uint8_t i = 0; i < Mesh.Vertices.UVLayerCount(); i++)
+			Result.Length += CastProperty::Length(CastPropertyId::Vector2, string::Format("u%d", i).Length(), VertexCount);
+
+		if (HasMaterial)
+			Result.Length += CastProperty::Length(CastPropertyId::Integer64, 1, 1);
+
+		return Result;
+	}
+
+	static void WriteMesh(CastStreamBuffer& Stream, const Mesh& Mesh, const CastMeshLayout& Layout, uint64_t Hash, uint64_t MaterialHash)
+	{
+		const uint32_t VertexCount = Mesh.Vertices.Count();
+		const uint8_t WeightCount = Mesh.Vertices.WeightCount();
+
+		Stream.AddNode(CastId::Mesh, Layout.Length, Hash, Layout.PropertyCount, 0);
+
+		Stream.AddProperty(CastPropertyId::Vector3, "vp", VertexCount);
+		for (auto& Vertex : Mesh.Vertices)
+			Stream.Add<Math::Vector3>(Vertex.Position());
+
+		Stream.AddProperty(CastPropertyId::Vector3, "vn", VertexCount);
+		for (auto& Vertex : Mesh.Vertices)
+			Stream.Add<Math::Vector3>(Vertex.Normal());
+
+		Stream.AddProperty(CastPropertyId::Integer32, "vc", VertexCount);
+		for (auto& Vertex : Mesh.Vertices)
+			Stream.Add<uint32_t>(*(uint32_t*)&Vertex.Color());
+
+		Stream.AddProperty(Layout.FaceProperty, "f", Mesh.Faces.Count() * 3);
+		for (auto& Face : Mesh.Faces)
+		{
+			if (Layout.FaceProperty == CastPropertyId::Byte)
+			{
+				Stream.Add<uint8_t>((uint8_t)Face[2]);
+				Stream.Add<uint8_t>((uint8_t)Face[1]);
+				Stream.Add<uint8_t>((uint8_t)Face[0]);
+			}
+			else if (Layout.FaceProperty == CastPropertyId::Short)
+			{
+				Stream.Add<uint16_t>((uint16_t)Face[2]);
+				Stream.Add<uint16_t>((uint16_t)Face[1]);
+				Stream.Add<uint16_t>((uint16_t)Face[0]);
+			}
+			else
+			{
+				Stream.Add<uint32_t>(Face[2]);
+				Stream.Add<uint32_t>(Face[1]);
+				Stream.Add<uint32_t>(Face[0]);
+			}
+		}
+
+		// Configure the uv layer count, and maximum influence
+		Stream.AddProperty(CastPropertyId::Byte, "ul", 1);
+		Stream.Add<uint8_t>(Mesh.Vertices.UVLayerCount());
+		Stream.AddProperty(CastPropertyId::Byte, "mi", 1);
+		Stream.Add<uint8_t>(WeightCount);
+
+		Stream.AddProperty(Layout.WeightBoneProperty, "wb", VertexCount * WeightCount);
+		for (auto& Vertex : Mesh.Vertices)
+		{
+			for (uint8_t i = 0; i < WeightCount; i++)
+			{
+				if (Layout.WeightBoneProperty == CastPropertyId::Byte)
+					Stream.Add<uint8_t>((uint8_t)Vertex.Weights(i).Bone);
+				else if (Layout.WeightBoneProperty == CastPropertyId::Short)
+					Stream.Add<uint16_t>((uint16_t)Vertex.Weights(i).Bone);
+				else
+					Stream.Add<uint32_t>(Vertex.Weights(i).Bone);
+			}
+		}
+
+		Stream.AddProperty(CastPropertyId::Float, "wv", VertexCount * WeightCount);
+		for (auto& Vertex : Mesh.Vertices)
+		{
+			for (uint8_t i = 0; i < WeightCount; i++)
+				Stream.Add<float>(Vertex.Weights(i).Value);
+		}
+
+		for (uint8_t i = 0; i < Mesh.Vertices.UVLayerCount(); i++)
+		{
+			Stream.AddProperty(CastPropertyId::Vector2, string::Format("u%d", i), VertexCount);
+			for (auto& Vertex : Mesh.Vertices)
+				Stream.Add<Math::Vector2>(Vertex.UVLayers(i));
+		}
+
+		if (Layout.PropertyCount > (8u + Mesh.Vertices.UVLayerCount()))
+		{
+			Stream.AddProperty(CastPropertyId::Integer64, "m", 1);
+			Stream.Add<uint64_t>(MaterialHash);
+		}
+	}
+
 	bool CastAsset::ExportAnimation(const Animation& Animation, const string& Path)
 	{
 		auto Writer = IO::BinaryWriter(IO::File::Create(Path));
@@ -25,9 +375,8 @@ namespace Assets::Exporters
 		// Magic, version 1, one root node, no flags.
 		Writer.Write<CastHeader>({ 0x74736163, 0x1, 0x1, 0x0 });
 
-		// This is the base of the virtual scene
-		auto Root = CastNode(CastId::Root);
-		auto& AnimNode = Root.Children.Emplace(CastId::Animation, Hashing::XXHash::HashString("animation"));
+		// The skeleton and notifications are small, so they're built as nodes, curves are written straight from the animation
+		auto AnimNode = CastNode(CastId::Animation, Hashing::XXHash::HashString("animation"));
 		auto& SkeletonNode = AnimNode.Children.Emplace(CastId::Skeleton, Hashing::XXHash::HashString("skeleton"));
 
 		AnimNode.Properties.Emplace(CastPropertyId::Float, "fr").AddFloat(Animation.FrameRate);
@@ -56,129 +405,11 @@ namespace Assets::Exporters
 			}
 		}
 
-		for (auto& Kvp : Animation.Curves)
-		{
-			for (auto& Curve : Kvp.Value())
-			{
-				auto& CurveNode = AnimNode.Children.Emplace(CastId::Curve, 0);
-
-				CurveNode.Properties.Emplace(CastPropertyId::String, "nn").SetString(Curve.Name);
-
-				constexpr const char* PropertyNameMap[] = {
-					"ex",
-					"rq",
-					"rx",
-					"ry",
-					"rz",
-					"tx",
-					"ty",
-					"tz",
-					"sx",
-					"sy",
-					"sz",
-					"vb"
-				};
-
-				constexpr const char* ModeNameMap[] = {
-					"absolute",
-					"additive",
-					"relative"
-				};
-
-				CurveNode.Properties.Emplace(CastPropertyId::String, "kp").SetString(PropertyNameMap[(uint32_t)Curve.Property]);
-				CurveNode.Properties.Emplace(CastPropertyId::String, "m").SetString(ModeNameMap[(uint32_t)Curve.Mode]);
-
-				auto KeyframeValueProperty = CastPropertyId::Float;
-
-				switch (Curve.Property)
-				{
-				case CurveProperty::RotateQuaternion:
-					KeyframeValueProperty = CastPropertyId::Vector4;
-					break;
-
-				case CurveProperty::RotateX:
-				case CurveProperty::RotateY:
-				case CurveProperty::RotateZ:
-				case CurveProperty::TranslateX:
-				case CurveProperty::TranslateY:
-				case CurveProperty::TranslateZ:
-				case CurveProperty::ScaleX:
-				case CurveProperty::ScaleY:
-				case CurveProperty::ScaleZ:
-					KeyframeValueProperty = CastPropertyId::Float;
-					break;
-
-				case CurveProperty::Visibility:
-					KeyframeValueProperty = CastPropertyId::Byte;
-					break;
-				}
-
-				auto KeyframeFrameProperty = CastPropertyId::Float;
-
-				if (Curve.IsFrameIntegral())
-				{
-					uint32_t LargestFrameIndex = 0;
-					for (auto& KeyFrame : Curve.Keyframes)
-						LargestFrameIndex = max(LargestFrameIndex, KeyFrame.Frame.Integer32);
-
-					if (LargestFrameIndex <= 0xFF)
-						KeyframeFrameProperty = CastPropertyId::Byte;
-					else if (LargestFrameIndex <= 0xFFFF)
-						KeyframeFrameProperty = CastPropertyId::Short;
-					else
-						KeyframeFrameProperty = CastPropertyId::Integer32;
-				}
-
-				auto& KeyFrameBuffer = CurveNode.Properties.Emplace(KeyframeFrameProperty, "kb");
-				auto& KeyValueBuffer = CurveNode.Properties.Emplace(KeyframeValueProperty, "kv");
-
-				for (auto& KeyFrame : Curve.Keyframes)
-				{
-					switch (KeyframeFrameProperty)
-					{
-					case CastPropertyId::Float:
-						KeyFrameBuffer.AddFloat(KeyFrame.Frame.Float);
-						break;
-					case CastPropertyId::Byte:
-						KeyFrameBuffer.AddByte((uint8_t)KeyFrame.Frame.Integer32);
-						break;
-					case CastPropertyId::Short:
-						KeyFrameBuffer.AddShort((uint16_t)KeyFrame.Frame.Integer32);
-						break;
-					case CastPropertyId::Integer32:
-						KeyFrameBuffer.AddInteger32(KeyFrame.Frame.Integer32);
-						break;
-					}
-
-					switch (Curve.Property)
-					{
-					case CurveProperty::RotateQuaternion:
-						KeyValueBuffer.AddVector4(KeyFrame.Value.Vector4);
-						break;
-
-					case CurveProperty::RotateX:
-					case CurveProperty::RotateY:
-					case CurveProperty::RotateZ:
-					case CurveProperty::TranslateX:
-					case CurveProperty::TranslateY:
-					case CurveProperty::TranslateZ:
-					case CurveProperty::ScaleX:
-					case CurveProperty::ScaleY:
-					case CurveProperty::ScaleZ:
-						KeyValueBuffer.AddFloat(KeyFrame.Value.Float);
-						break;
-
-					case CurveProperty::Visibility:
-						KeyValueBuffer.AddByte(KeyFrame.Value.Byte);
-						break;
-					}
-				}
-			}
-		}
+		List<CastNode> NotetrackNodes;
 
 		for (auto& Notetrack : Animation.Notificiations)
 		{
-			auto& TrackNode = AnimNode.Children.Emplace(CastId::NotificationTrack, Hashing::XXHash::HashString(Notetrack.Key()));
+			auto& TrackNode = NotetrackNodes.Emplace(CastId::NotificationTrack, Hashing::XXHash::HashString(Notetrack.Key()));
 
 			TrackNode.Properties.Emplace(CastPropertyId::String, "n").SetString(Notetrack.Key());
 
@@ -188,8 +419,47 @@ namespace Assets::Exporters
 				KeyBuffer.AddInteger32(Key);
 		}
 
-		// Finally, serialize the node to the disk
-		Root.Write(Writer);
+		// Size every node up front, so the headers can be written before the data
+		List<CastCurveLayout> CurveLayouts;
+		uint32_t AnimLength = AnimNode.Length();
+
+		for (auto& Kvp : Animation.GetCurves())
+		{
+			for (auto& Curve : Kvp.Value())
+			{
+				auto Layout = BuildCurveLayout(Curve);
+
+				CurveLayouts.Add(Layout);
+				AnimLength += Layout.Length;
+			}
+		}
+
+		for (auto& TrackNode : NotetrackNodes)
+			AnimLength += TrackNode.Length();
+
+		CastStreamBuffer Stream(Writer);
+
+		Stream.AddNode(CastId::Root, sizeof(CastNodeHeader) + AnimLength, 0, 0, 1);
+		Stream.AddNode(CastId::Animation, AnimLength, AnimNode.Hash, AnimNode.Properties.Count(), AnimNode.Children.Count() + CurveLayouts.Count() + NotetrackNodes.Count());
+		Stream.Flush();
+
+		for (auto& Prop : AnimNode.Properties)
+			Prop.Write(Writer);
+		for (auto& Child : AnimNode.Children)
+			Child.Write(Writer);
+
+		uint32_t CurveIndex = 0;
+
+		for (auto& Kvp : Animation.GetCurves())
+		{
+			for (auto& Curve : Kvp.Value())
+				WriteCurve(Stream, Curve, CurveLayouts[CurveIndex++]);
+		}
+
+		Stream.Flush();
+
+		for (auto& TrackNode : NotetrackNodes)
+			TrackNode.Write(Writer);
 
 		return true;
 	}
@@ -201,9 +471,8 @@ namespace Assets::Exporters
 		// Magic, version 1, one root node, no flags.
 		Writer.Write<CastHeader>({ 0x74736163, 0x1, 0x1, 0x0 });
 
-		// This is the base of the virtual scene
-		auto Root = CastNode(CastId::Root);
-		auto& ModelNode = Root.Children.Emplace(CastId::Model, Hashing::XXHash::HashString("model"));
+		// The skeleton and materials are small, so they're built as nodes, meshes are written straight from their buffers
+		auto ModelNode = CastNode(CastId::Model, Hashing::XXHash::HashString("model"));
 		auto& SkeletonNode = ModelNode.Children.Emplace(CastId::Skeleton, Hashing::XXHash::HashString("skeleton"));
 
 		auto BoneCount = Model.Bones.Count();
@@ -267,110 +536,40 @@ namespace Assets::Exporters
 			MaterialHashMap.Add(MaterialIndex++, MatNode.Hash);
 		}
 
-		uint32_t MeshIndex = 0;
+		// Size every mesh from it's counts, so the headers can be written before the data
+		List<CastMeshLayout> MeshLayouts(Model.Meshes.Count());
+		uint32_t ModelLength = ModelNode.Length();
 
 		for (auto& Mesh : Model.Meshes)
 		{
-			auto& MeshNode = ModelNode.Children.Emplace(CastId::Mesh, Hashing::XXHash::HashString(string::Format("mesh%02d", MeshIndex++)));
-			
-			MeshNode.Properties.EmplaceBack(CastPropertyId::Vector3, "vp");
-			MeshNode.Properties.EmplaceBack(CastPropertyId::Vector3, "vn");
-			MeshNode.Properties.EmplaceBack(CastPropertyId::Integer32, "vc");
-
-			auto VertexCount = Mesh.Vertices.Count();
-
-			if (VertexCount <= 0xFF)
-				MeshNode.Properties.EmplaceBack(CastPropertyId::Byte, "f");
-			else if (VertexCount <= 0xFFFF)
-				MeshNode.Properties.EmplaceBack(CastPropertyId::Short, "f");
-			else
-				MeshNode.Properties.EmplaceBack(CastPropertyId::Integer32, "f");
-
-			// Configure the uv layer count, and maximum influence
-			MeshNode.Properties.Emplace(CastPropertyId::Byte, "ul").AddByte((uint8_t)Mesh.Vertices.UVLayerCount());
-			MeshNode.Properties.Emplace(CastPropertyId::Byte, "mi").AddByte((uint8_t)Mesh.Vertices.WeightCount());
-
-			if (BoneCount <= 0xFF)
-				MeshNode.Properties.Emplace(CastPropertyId::Byte, "wb");
-			else if (BoneCount <= 0xFFFF)
-				MeshNode.Properties.Emplace(CastPropertyId::Short, "wb");
-			else
-				MeshNode.Properties.Emplace(CastPropertyId::Integer32, "wb");
-
-			MeshNode.Properties.Emplace(CastPropertyId::Float, "wv");
-
-			List<CastProperty*> UVLayers;
+			auto Layout = BuildMeshLayout(Mesh, BoneCount, Mesh.MaterialIndices.Count() > 0 && Mesh.MaterialIndices[0] > -1);
 
-			for (uint8_t i = 0; i < Mesh.Vertices.UVLayerCount(); i++)
-				MeshNode.Properties.EmplaceBack(CastPropertyId::Vector2, string::Format("u%d", i));
+			MeshLayouts.Add(Layout);
+			ModelLength += Layout.Length;
+		}
 
-			auto& VertexPositions = MeshNode.Properties[0];
-			auto& VertexNormals = MeshNode.Properties[1];
-			auto& VertexColors = MeshNode.Properties[2];
-			auto& FaceIndices = MeshNode.Properties[3];
-			auto& VertexWeightBones = MeshNode.Properties[6];
-			auto& VertexWeightValues = MeshNode.Properties[7];
+		CastStreamBuffer Stream(Writer);
 
-			for (auto& Layer : MeshNode.Properties)
-			{
-				if (Layer.Name != "ul" && Layer.Name.StartsWith("u"))
-					UVLayers.Add(&Layer);
-			}
+		Stream.AddNode(CastId::Root, sizeof(CastNodeHeader) + ModelLength, 0, 0, 1);
+		Stream.AddNode(CastId::Model, ModelLength, ModelNode.Hash, ModelNode.Properties.Count(), ModelNode.Children.Count() + Model.Meshes.Count());
+		Stream.Flush();
 
-			for (auto& Vertex : Mesh.Vertices)
-			{
-				VertexPositions.AddVector3(Vertex.Position());
-				VertexNormals.AddVector3(Vertex.Normal());
-				VertexColors.AddInteger32(*(uint32_t*)&Vertex.Color());
+		for (auto& Prop : ModelNode.Properties)
+			Prop.Write(Writer);
+		for (auto& Child : ModelNode.Children)
+			Child.Write(Writer);
 
-				for (uint8_t i = 0; i < Mesh.Vertices.WeightCount(); i++)
-				{
-					if (BoneCount <= 0xFF)
-						VertexWeightBones.AddByte((uint8_t)Vertex.Weights(i).Bone);
-					else if (BoneCount <= 0xFFFF)
-						VertexWeightBones.AddShort((uint16_t)Vertex.Weights(i).Bone);
-					else
-						VertexWeightBones.AddInteger32(Vertex.Weights(i).Bone);
-
-					VertexWeightValues.AddFloat(Vertex.Weights(i).Value);
-				}
-
-				for (uint8_t i = 0; i < Mesh.Vertices.UVLayerCount(); i++)
-				{
-					UVLayers[i]->AddVector2(Vertex.UVLayers(i));
-				}
-			}
+		uint32_t MeshIndex = 0;
 
-			for (auto& Face : Mesh.Faces)
-			{
-				if (VertexCount <= 0xFF)
-				{
-					FaceIndices.AddByte((uint8_t)Face[2]);
-					FaceIndices.AddByte((uint8_t)Face[1]);
-					FaceIndices.AddByte((uint8_t)Face[0]);
-				}
-				else if (VertexCount <= 0xFFFF)
-				{
-					FaceIndices.AddShort((uint16_t)Face[2]);
-					FaceIndices.AddShort((uint16_t)Face[1]);
-					FaceIndices.AddShort((uint16_t)Face[0]);
-				}
-				else
-				{
-					FaceIndices.AddInteger32(Face[2]);
-					FaceIndices.AddInteger32(Face[1]);
-					FaceIndices.AddInteger32(Face[0]);
-				}
-			}
+		for (auto& Mesh : Model.Meshes)
+		{
+			uint64_t MaterialHash = (Mesh.MaterialIndices.Count() > 0 && Mesh.MaterialIndices[0] > -1) ? MaterialHashMap[Mesh.MaterialIndices[0]] : 0;
 
-			if (Mesh.MaterialIndices.Count() > 0 && Mesh.MaterialIndices[0] > -1)
-			{
-				MeshNode.Properties.Emplace(CastPropertyId::Integer64, "m").AddInteger64(MaterialHashMap[Mesh.MaterialIndices[0]]);
-			}
+			WriteMesh(Stream, Mesh, MeshLayouts[MeshIndex], Hashing::XXHash::HashString(string::Format("mesh%02d", MeshIndex)), MaterialHash);
+			MeshIndex++;
 		}
-		
-		// Finally, serialize the node to the disk
-		Root.Write(Writer);
+
+		Stream.Flush();
 
 		return true;
 	}
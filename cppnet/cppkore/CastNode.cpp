@@ -17,115 +17,109 @@ namespace Assets::Exporters
 
 	const uint32_t CastProperty::Length() const
 	{
-		switch (this->Identifier)
-		{
-		case CastPropertyId::Byte: return sizeof(CastPropertyHeader) + this->Name.Length() + (sizeof(uint8_t) * this->IntegralValues.Count());
-		case CastPropertyId::Short: return sizeof(CastPropertyHeader) + this->Name.Length() + (sizeof(uint16_t) * this->IntegralValues.Count());
-		case CastPropertyId::Integer32: return sizeof(CastPropertyHeader) + this->Name.Length() + (sizeof(uint32_t) * this->IntegralValues.Count());
-		case CastPropertyId::Integer64: return sizeof(CastPropertyHeader) + this->Name.Length() + (sizeof(uint64_t) * this->IntegralValues.Count());
-		case CastPropertyId::Float: return sizeof(CastPropertyHeader) + this->Name.Length() + (sizeof(float) * this->IntegralValues.Count());
-		case CastPropertyId::Double: return sizeof(CastPropertyHeader) + this->Name.Length() + (sizeof(double) * this->IntegralValues.Count());
-		case CastPropertyId::Vector2 : return sizeof(CastPropertyHeader) + this->Name.Length() + (sizeof(Math::Vector2) * this->IntegralValues.Count());
-		case CastPropertyId::Vector3: return sizeof(CastPropertyHeader) + this->Name.Length() + (sizeof(Math::Vector3) * this->IntegralValues.Count());
-		case CastPropertyId::Vector4: return sizeof(CastPropertyHeader) + this->Name.Length() + (sizeof(Math::Quaternion) * this->IntegralValues.Count());
-		case CastPropertyId::String: return sizeof(CastPropertyHeader) + this->Name.Length() + (StringValue.Length() + sizeof(uint8_t));
-		default: return 0;
-		}
+		if (this->Identifier == CastPropertyId::String)
+			return sizeof(CastPropertyHeader) + this->Name.Length() + (StringValue.Length() + sizeof(uint8_t));
+
+		return sizeof(CastPropertyHeader) + this->Name.Length() + this->Values.Count();
+	}
+
+	const uint32_t CastProperty::Count() const
+	{
+		if (this->Identifier == CastPropertyId::String)
+			return 1;
+
+		auto Size = CastProperty::ElementSize(this->Identifier);
+
+		return (Size > 0) ? (this->Values.Count() / Size) : 0;
 	}
 
 	void CastProperty::Write(IO::BinaryWriter& Writer) const
 	{
-		auto Size = (this->Identifier == CastPropertyId::String) ? 1 : this->IntegralValues.Count();
-		Writer.Write<CastPropertyHeader>({this->Identifier, (uint16_t)this->Name.Length(), Size});
-		Writer.Write(&this->Name[0], 0, this->Name.Length());
-		
-		switch (this->Identifier)
-		{
-		case CastPropertyId::Byte:
-			for (auto& Value : this->IntegralValues)
-				Writer.Write<uint8_t>(Value.Byte);
-			break;
-		case CastPropertyId::Short:
-			for (auto& Value : this->IntegralValues)
-				Writer.Write<uint16_t>(Value.Short);
-			break;
-		case CastPropertyId::Integer32:
-			for (auto& Value : this->IntegralValues)
-				Writer.Write<uint32_t>(Value.Integer32);
-			break;
-		case CastPropertyId::Integer64:
-			for (auto& Value : this->IntegralValues)
-				Writer.Write<uint64_t>(Value.Integer64);
-			break;
-		case CastPropertyId::Float:
-			for (auto& Value : this->IntegralValues)
-				Writer.Write<float>(Value.Float);
-			break;
-		case CastPropertyId::Double:
-			for (auto& Value : this->IntegralValues)
-				Writer.Write<double>(Value.Double);
-			break;
-		case CastPropertyId::Vector2:
-			for (auto& Value : this->IntegralValues)
-				Writer.Write<Math::Vector2>(Value.Vector2);
-			break;
-		case CastPropertyId::Vector3:
-			for (auto& Value : this->IntegralValues)
-				Writer.Write<Math::Vector3>(Value.Vector3);
-			break;
-		case CastPropertyId::Vector4:
-			for (auto& Value : this->IntegralValues)
-				Writer.Write<Math::Quaternion>(Value.Vector4);
-			break;
-		case CastPropertyId::String:
+		CastProperty::WriteHeader(Writer, this->Identifier, this->Name, this->Count());
+
+		if (this->Identifier == CastPropertyId::String)
 			Writer.WriteCString(this->StringValue);
-			break;
+		else if (this->Values.Count() > 0)
+			Writer.Write(this->Values.begin(), 0, this->Values.Count());
+	}
+
+	const uint32_t CastProperty::ElementSize(CastPropertyId Id)
+	{
+		switch (Id)
+		{
+		case CastPropertyId::Byte: return sizeof(uint8_t);
+		case CastPropertyId::Short: return sizeof(uint16_t);
+		case CastPropertyId::Integer32: return sizeof(uint32_t);
+		case CastPropertyId::Integer64: return sizeof(uint64_t);
+		case CastPropertyId::Float: return sizeof(float);
+		case CastPropertyId::Double: return sizeof(double);
+		case CastPropertyId::Vector2: return sizeof(Math::Vector2);
+		case CastPropertyId::Vector3: return sizeof(Math::Vector3);
+		case CastPropertyId::Vector4: return sizeof(Math::Quaternion);
+		default: return 0;
 		}
 	}
 
+	const uint32_t CastProperty::Length(CastPropertyId Id, uint32_t NameLength, uint32_t Count)
+	{
+		return sizeof(CastPropertyHeader) + NameLength + (CastProperty::ElementSize(Id) * Count);
+	}
+
+	void CastProperty::WriteHeader(IO::BinaryWriter& Writer, CastPropertyId Id, const string& Name, uint32_t Count)
+	{
+		Writer.Write<CastPropertyHeader>({Id, (uint16_t)Name.Length(), Count});
+		Writer.Write(&Name[0], 0, Name.Length());
+	}
+
+	template<typename T>
+	void CastProperty::AddValue(const T& Value)
+	{
+		this->Values.AddRange((const uint8_t*)&Value, sizeof(T));
+	}
+
 	void CastProperty::AddByte(uint8_t Value)
 	{
-		this->IntegralValues.EmplaceBack(Value);
+		this->AddValue(Value);
 	}
 
 	void CastProperty::AddShort(uint16_t Value)
 	{
-		this->IntegralValues.EmplaceBack(Value);
+		this->AddValue(Value);
 	}
 
 	void CastProperty::AddInteger32(uint32_t Value)
 	{
-		this->IntegralValues.EmplaceBack(Value);
+		this->AddValue(Value);
 	}
 
 	void CastProperty::AddInteger64(uint64_t Value)
 	{
-		this->IntegralValues.EmplaceBack(Value);
+		this->AddValue(Value);
 	}
 
 	void CastProperty::AddFloat(float Value)
 	{
-		this->IntegralValues.EmplaceBack(Value);
+		this->AddValue(Value);
 	}
 
 	void CastProperty::AddDouble(double Value)
 	{
-		this->IntegralValues.EmplaceBack(Value);
+		this->AddValue(Value);
 	}
 
 	void CastProperty::AddVector2(Math::Vector2 Value)
 	{
-		this->IntegralValues.EmplaceBack(Value);
+		this->AddValue(Value);
 	}
 
 	void CastProperty::AddVector3(Math::Vector3 Value)
 	{
-		this->IntegralValues.EmplaceBack(Value);
+		this->AddValue(Value);
 	}
 
 	void CastProperty::AddVector4(Math::Quaternion Value)
 	{
-		this->IntegralValues.EmplaceBack(Value);
+		this->AddValue(Value);
 	}
 
 	void CastProperty::SetString(const string& Value)
@@ -169,54 +163,4 @@ namespace Assets::Exporters
 		for (auto& Child : Children)
 			Child.Write(Writer);
 	}
-
-	CastPropertyUnion::CastPropertyUnion()
-		: Vector4(0,0,0,0)
-	{
-	}
-
-	CastPropertyUnion::CastPropertyUnion(uint8_t Value)
-		: Byte(Value)
-	{
-	}
-
-	CastPropertyUnion::CastPropertyUnion(uint16_t Value)
-		: Short(Value)
-	{
-	}
-
-	CastPropertyUnion::CastPropertyUnion(uint32_t Value)
-		: Integer32(Value)
-	{
-	}
-
-	CastPropertyUnion::CastPropertyUnion(uint64_t Value)
-		: Integer64(Value)
-	{
-	}
-
-	CastPropertyUnion::CastPropertyUnion(float Value)
-		: Float(Value)
-	{
-	}
-
-	CastPropertyUnion::CastPropertyUnion(double Value)
-		: Double(Value)
-	{
-	}
-
-	CastPropertyUnion::CastPropertyUnion(Math::Vector2 Value)
-		: Vector2(Value)
-	{
-	}
-
-	CastPropertyUnion::CastPropertyUnion(Math::Vector3 Value)
-		: Vector3(Value)
-	{
-	}
-
-	CastPropertyUnion::CastPropertyUnion(Math::Quaternion Value)
-		: Vector4(Value)
-	{
-	}
 }
\ No newline at end of file
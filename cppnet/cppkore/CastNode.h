@@ -63,36 +63,8 @@ namespace Assets::Exporters
 		// cast_property[ArrayLength] array of data
 	};
 
-	union CastPropertyUnion
-	{
-		uint8_t Byte;
-		uint16_t Short;
-		uint32_t Integer32;
-		uint64_t Integer64;
-
-		float Float;
-		double Double;
-
-		Math::Vector2 Vector2;
-		Math::Vector3 Vector3;
-		Math::Quaternion Vector4;
-
-		CastPropertyUnion();
-
-		explicit CastPropertyUnion(uint8_t Value);
-		explicit CastPropertyUnion(uint16_t Value);
-		explicit CastPropertyUnion(uint32_t Value);
-		explicit CastPropertyUnion(uint64_t Value);
-		explicit CastPropertyUnion(float Value);
-		explicit CastPropertyUnion(double Value);
-		explicit CastPropertyUnion(Math::Vector2 Value);
-		explicit CastPropertyUnion(Math::Vector3 Value);
-		explicit CastPropertyUnion(Math::Quaternion Value);
-	};
-
 	static_assert(sizeof(CastNodeHeader) == 0x18, "CastNode header size mismatch");
 	static_assert(sizeof(CastPropertyHeader) == 0x8, "CastProperty header size mismatch");
-	static_assert(sizeof(CastPropertyUnion) == 0x10, "CastProperty union size mismatch");
 
 	class CastProperty
 	{
@@ -101,6 +73,8 @@ namespace Assets::Exporters
 		explicit CastProperty(CastPropertyId Id, const char* Name);
 
 		const uint32_t Length() const;
+		// The count of values in the property.
+		const uint32_t Count() const;
 
 		void Write(IO::BinaryWriter& Writer) const;
 
@@ -118,12 +92,24 @@ namespace Assets::Exporters
 
 		void SetString(const string& Value);
 
+		// Gets the size of one value of the element type.
+		static const uint32_t ElementSize(CastPropertyId Id);
+		// Gets the size of a property with the count of values, for writing properties without building them.
+		static const uint32_t Length(CastPropertyId Id, uint32_t NameLength, uint32_t Count);
+		// Writes the header and name of a property, the values must follow.
+		static void WriteHeader(IO::BinaryWriter& Writer, CastPropertyId Id, const string& Name, uint32_t Count);
+
 		CastPropertyId Identifier;
 		string Name;
 
 	private:
-		List<CastPropertyUnion> IntegralValues;
+		// Values are packed as they're written to disk, in the property's element type
+		List<uint8_t> Values;
 		string StringValue;
+
+		// Appends the bytes of a value to the buffer.
+		template<typename T>
+		void AddValue(const T& Value);
 	};
 
 	class CastNode
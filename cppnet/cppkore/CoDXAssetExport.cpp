@@ -16,6 +16,7 @@ namespace Assets::Exporters
 	bool CoDXAssetExport::ExportModel(const Model& Model, const string& Path)
 	{
 		auto Writer = IO::StreamWriter(IO::File::Create(Path));
+		Writer.SetBufferSize(IO::StreamWriter::ExportBufferSize);
 
 		Writer.WriteLine(
 			"MODEL\nVERSION 6\n"
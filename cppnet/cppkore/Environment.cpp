@@ -2,6 +2,7 @@
 #include "Environment.h"
 #include "Path.h"
 #include <shellapi.h>
+#include <intrin.h>
 
 namespace System
 {
@@ -119,4 +120,49 @@ namespace System
 	{
 		return (sizeof(uintptr_t) == 8);
 	}
+
+	// The vector extensions the processor and os support, queried once for the process
+	struct ProcessorFeatures
+	{
+		bool Avx2;
+		bool F16C;
+	};
+
+	static const ProcessorFeatures& GetProcessorFeatures()
+	{
+		static const ProcessorFeatures Features = []
+		{
+			ProcessorFeatures Result{};
+			int CPUIdentifier[4];
+
+			__cpuid(CPUIdentifier, 0);
+			if (CPUIdentifier[0] < 7)
+				return Result;
+
+			// The os has to save the ymm registers as well
+			__cpuidex(CPUIdentifier, 1, 0);
+			if ((CPUIdentifier[2] & (1 << 27)) == 0 || (CPUIdentifier[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6)
+				return Result;
+
+			const bool HasF16C = (CPUIdentifier[2] & (1 << 29)) != 0;
+
+			__cpuidex(CPUIdentifier, 7, 0);
+			Result.Avx2 = (CPUIdentifier[1] & (1 << 5)) != 0;
+			Result.F16C = Result.Avx2 && HasF16C;
+
+			return Result;
+		}();
+
+		return Features;
+	}
+
+	bool Environment::IsAvx2Supported()
+	{
+		return GetProcessorFeatures().Avx2;
+	}
+
+	bool Environment::IsF16CSupported()
+	{
+		return GetProcessorFeatures().F16C;
+	}
 }
\ No newline at end of file
@@ -46,6 +46,11 @@ namespace System
 		// Returns whether or not we are a 64bit process
 		constexpr static bool Is64BitProcess();
 
+		// Returns whether or not the processor and os support avx2, checked once
+		static bool IsAvx2Supported();
+		// Returns whether or not the processor and os support avx2 and f16c, checked once
+		static bool IsF16CSupported();
+
 		// Returns a newline string for the environment
 		const static string NewLine;
 	};
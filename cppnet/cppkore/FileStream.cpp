@@ -271,6 +271,89 @@ namespace IO
 		return this->Read(Buffer, Offset, Count);
 	}
 
+	const uint8_t* FileStream::PeekBuffer(uint64_t& Count)
+	{
+		if (!this->_Handle)
+			IOError::StreamNotOpen();
+
+		if (!this->_CanRead)
+			IOError::StreamNoReadSupport();
+
+		// Unseekable files are read straight from the handle, there's no buffer to expose
+		if (!this->_CanSeek)
+		{
+			Count = 0;
+			return nullptr;
+		}
+
+		if (this->_ReadPosition == this->_ReadLength)
+		{
+			if (this->_WritePosition > 0)
+				this->FlushWrite();
+
+			this->_ReadPosition = 0;
+			this->_ReadLength = (int32_t)this->ReadCore(this->_Buffer.get(), 0, this->_BufferSize);
+		}
+
+		Count = (uint64_t)(this->_ReadLength - this->_ReadPosition);
+		return this->_Buffer.get() + this->_ReadPosition;
+	}
+
+	void FileStream::Advance(uint64_t Count)
+	{
+		this->_ReadPosition += (int32_t)Count;
+	}
+
+	uint64_t FileStream::ReadAt(uint8_t* Buffer, uint64_t Offset, uint64_t Count, uint64_t Position)
+	{
+		if (!this->_Handle)
+			IOError::StreamNotOpen();
+
+		if (!this->_CanRead)
+			IOError::StreamNoReadSupport();
+
+		if (!this->_CanSeek)
+			IOError::StreamNoSeekSupport();
+
+		// Pending writes must hit the file first
+		if (this->_WritePosition > 0)
+			this->FlushWrite();
+
+		// SetPosition only moves the file pointer, so it's read from the handle instead of trusting _Position
+		LARGE_INTEGER Distance{};
+		LARGE_INTEGER HandlePosition{};
+		SetFilePointerEx(this->_Handle, Distance, &HandlePosition, FILE_CURRENT);
+
+		auto ReadPtr = (Buffer + Offset);
+		uint64_t TotalRead = 0;
+
+		DWORD nRead = 0;
+		while (Count > 0)
+		{
+			// Calculate based on DWORD MAX value due to API limitations
+			auto Want = (Count > UINT32_MAX) ? UINT32_MAX : Count;
+
+			OVERLAPPED Overlapped{};
+			Overlapped.Offset = (DWORD)Position;
+			Overlapped.OffsetHigh = (DWORD)(Position >> 32);
+
+			// Read the buffer at the position
+			if (!ReadFile(this->_Handle, ReadPtr, (DWORD)Want, &nRead, &Overlapped) || nRead == 0)
+				break;
+
+			// Adjust counts
+			TotalRead += nRead;
+			Count -= nRead;
+			ReadPtr += nRead;
+			Position += nRead;
+		}
+
+		// Synchronous handles move the file pointer, put it back so the read buffer stays valid
+		SetFilePointerEx(this->_Handle, HandlePosition, NULL, FILE_BEGIN);
+
+		return TotalRead;
+	}
+
 	void FileStream::Write(uint8_t* Buffer, uint64_t Offset, uint64_t Count)
 	{
 		if (!this->_Handle)
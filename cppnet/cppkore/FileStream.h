@@ -39,6 +39,9 @@ namespace IO
 		virtual uint64_t Read(uint8_t* Buffer, uint64_t Offset, uint64_t Count, uint64_t Position);
 		virtual void Write(uint8_t* Buffer, uint64_t Offset, uint64_t Count);
 		virtual void Write(uint8_t* Buffer, uint64_t Offset, uint64_t Count, uint64_t Position);
+		virtual uint64_t ReadAt(uint8_t* Buffer, uint64_t Offset, uint64_t Count, uint64_t Position);
+		virtual const uint8_t* PeekBuffer(uint64_t& Count);
+		virtual void Advance(uint64_t Count);
 
 	private:
 		// FileMode flags cached
@@ -1,5 +1,7 @@
 #include "stdafx.h"
 #include "Half.h"
+#include "Environment.h"
+#include <intrin.h>
 
 namespace Math
 {
@@ -71,4 +73,36 @@ namespace Math
 	{
 		return Half(Value).ToFloat();
 	}
+
+	void Half::ToFloat(const uint16_t* Values, float* Result, uint64_t Count)
+	{
+		uint64_t i = 0;
+
+		if (System::Environment::IsF16CSupported())
+		{
+			const __m256i ExponentMask = _mm256_set1_epi32(0x7C00);
+			const __m256i MantissaMask = _mm256_set1_epi32(0x3FF);
+			const __m256i QuietBit = _mm256_set1_epi32(0x200);
+			const __m256i FloatQuietBit = _mm256_set1_epi32(0x400000);
+			const __m256i Zero = _mm256_setzero_si256();
+
+			for (; i + 8 <= Count; i += 8)
+			{
+				__m128i Packed = _mm_loadu_si128((const __m128i*)(Values + i));
+				__m256 Converted = _mm256_cvtph_ps(Packed);
+
+				// The hardware quiets signaling nans, the scalar conversion keeps them as is
+				__m256i Halves = _mm256_cvtepu16_epi32(Packed);
+				__m256i IsNaN = _mm256_and_si256(_mm256_cmpeq_epi32(_mm256_and_si256(Halves, ExponentMask), ExponentMask), _mm256_cmpgt_epi32(_mm256_and_si256(Halves, MantissaMask), Zero));
+				__m256i IsSignaling = _mm256_andnot_si256(_mm256_cmpeq_epi32(_mm256_and_si256(Halves, QuietBit), QuietBit), IsNaN);
+
+				Converted = _mm256_andnot_ps(_mm256_castsi256_ps(_mm256_and_si256(IsSignaling, FloatQuietBit)), Converted);
+
+				_mm256_storeu_ps(Result + i, Converted);
+			}
+		}
+
+		for (; i < Count; i++)
+			Result[i] = Half(Values[i]).ToFloat();
+	}
 }
@@ -22,6 +22,8 @@ namespace Math
 		static uint16_t ToHalf(float Value);
 		// Convert the float 16bit value to a 32bit float.
 		static float ToFloat(uint16_t Value);
+		// Converts a buffer of float 16bit values to 32bit floats, 8 at a time with f16c.
+		static void ToFloat(const uint16_t* Values, float* Result, uint64_t Count);
 
 	private:
 		// Internal value
@@ -82,6 +82,7 @@
 #include "BinaryWriter.h"
 #include "StreamReader.h"
 #include "StreamWriter.h"
+#include "NumberFormatter.h"
 #endif
 
 #if KORE_ENABLE_NET
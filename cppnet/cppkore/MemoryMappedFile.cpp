@@ -0,0 +1,93 @@
+#include "stdafx.h"
+#include "MemoryMappedFile.h"
+#include "IOError.h"
+
+namespace IO
+{
+	MemoryMappedFile::MemoryMappedFile(const string& Path)
+		: _FileHandle(nullptr), _MappingHandle(nullptr), _View(nullptr), _Length(0)
+	{
+		auto hFile = CreateFileA((const char*)Path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, NULL);
+		if (hFile == INVALID_HANDLE_VALUE)
+		{
+			switch (GetLastError())
+			{
+			case ERROR_PATH_NOT_FOUND:
+				IOError::StreamPathInvalid();
+				break;
+			case ERROR_FILE_NOT_FOUND:
+				IOError::StreamFileNotFound();
+				break;
+			case ERROR_SHARING_VIOLATION:
+				IOError::StreamInUse();
+				break;
+			case ERROR_ACCESS_DENIED:
+				IOError::StreamAccessDenied();
+				break;
+			default:
+				IOError::StreamUnknown();
+				break;
+			}
+		}
+
+		this->_FileHandle = hFile;
+
+		LARGE_INTEGER Size{};
+		GetFileSizeEx(this->_FileHandle, &Size);
+
+		this->_Length = (uint64_t)Size.QuadPart;
+
+		// Zero length files can't be mapped, leave the view empty
+		if (this->_Length == 0)
+			return;
+
+		this->_MappingHandle = CreateFileMappingA(this->_FileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (this->_MappingHandle == nullptr)
+		{
+			this->Close();
+			IOError::StreamUnknown();
+		}
+
+		this->_View = (uint8_t*)MapViewOfFile(this->_MappingHandle, FILE_MAP_READ, 0, 0, 0);
+		if (this->_View == nullptr)
+		{
+			this->Close();
+			IOError::StreamUnknown();
+		}
+	}
+
+	MemoryMappedFile::~MemoryMappedFile()
+	{
+		this->Close();
+	}
+
+	uint8_t* MemoryMappedFile::GetData() const
+	{
+		return this->_View;
+	}
+
+	uint64_t MemoryMappedFile::GetLength() const
+	{
+		return this->_Length;
+	}
+
+	void MemoryMappedFile::Close()
+	{
+		if (this->_View)
+			UnmapViewOfFile(this->_View);
+		if (this->_MappingHandle)
+			CloseHandle(this->_MappingHandle);
+		if (this->_FileHandle)
+			CloseHandle(this->_FileHandle);
+
+		this->_View = nullptr;
+		this->_MappingHandle = nullptr;
+		this->_FileHandle = nullptr;
+		this->_Length = 0;
+	}
+
+	std::unique_ptr<MemoryMappedFile> MemoryMappedFile::OpenRead(const string& Path)
+	{
+		return std::make_unique<MemoryMappedFile>(Path);
+	}
+}
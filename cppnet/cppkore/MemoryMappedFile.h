@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <Windows.h>
+#include "StringBase.h"
+
+namespace IO
+{
+	// MemoryMappedFile maps an entire file into memory for read-only access
+	class MemoryMappedFile
+	{
+	public:
+		MemoryMappedFile(const string& Path);
+		~MemoryMappedFile();
+
+		// The view is owned by this instance, it can't be copied
+		MemoryMappedFile(const MemoryMappedFile&) = delete;
+		MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+		// Returns a pointer to the start of the mapped view
+		uint8_t* GetData() const;
+		// Returns the length of the mapped view
+		uint64_t GetLength() const;
+
+		// Unmaps the view and closes the underlying handles
+		void Close();
+
+		// Maps a file in a particular path for reading
+		static std::unique_ptr<MemoryMappedFile> OpenRead(const string& Path);
+
+	private:
+		// The native handles
+		HANDLE _FileHandle;
+		HANDLE _MappingHandle;
+
+		// The mapped view, and it's size
+		uint8_t* _View;
+		uint64_t _Length;
+	};
+}
@@ -179,6 +179,48 @@ namespace IO
 		return this->Read(Buffer, Offset, Count);
 	}
 
+	uint64_t MemoryStream::ReadAt(uint8_t* Buffer, uint64_t Offset, uint64_t Count, uint64_t Position)
+	{
+		if (!this->_Buffer)
+			throw std::exception("Stream not open");
+
+		// Ensure we are within the bounds of the buffer
+		int64_t nLength = (int64_t)this->_Length - (int64_t)(this->_Origin + Position);
+		if (nLength > (int64_t)Count) nLength = Count;
+		if (nLength <= 0)
+			return 0;
+
+		std::memcpy(Buffer + Offset, this->_Buffer + this->_Origin + Position, (size_t)nLength);
+
+		return nLength;
+	}
+
+	const uint8_t* MemoryStream::PeekBuffer(uint64_t& Count)
+	{
+		if (!this->_Buffer)
+			throw std::exception("Stream not open");
+
+		Count = (this->_Position < this->_Length) ? (this->_Length - this->_Position) : 0;
+		return (this->_Buffer + this->_Position);
+	}
+
+	void MemoryStream::Advance(uint64_t Count)
+	{
+		this->_Position += Count;
+	}
+
+	uint8_t* MemoryStream::Borrow(uint64_t Position, uint64_t Count)
+	{
+		if (!this->_Buffer)
+			throw std::exception("Stream not open");
+
+		auto nOffset = this->_Origin + Position;
+		if (nOffset < this->_Origin || nOffset > this->_Length || Count > (this->_Length - nOffset))
+			throw std::exception("Attempt to read outside the bounds of the stream");
+
+		return (this->_Buffer + nOffset);
+	}
+
 	void MemoryStream::Write(uint8_t* Buffer, uint64_t Offset, uint64_t Count)
 	{
 		if (!this->_Buffer)
@@ -35,6 +35,13 @@ namespace IO
 		virtual uint64_t Read(uint8_t* Buffer, uint64_t Offset, uint64_t Count, uint64_t Position);
 		virtual void Write(uint8_t* Buffer, uint64_t Offset, uint64_t Count);
 		virtual void Write(uint8_t* Buffer, uint64_t Offset, uint64_t Count, uint64_t Position);
+		virtual uint64_t ReadAt(uint8_t* Buffer, uint64_t Offset, uint64_t Count, uint64_t Position);
+		virtual const uint8_t* PeekBuffer(uint64_t& Count);
+		virtual void Advance(uint64_t Count);
+
+		// Returns a pointer to Count bytes of the backing buffer at the given position, without copying.
+		// The pointer is only valid until the stream is written to or closed.
+		uint8_t* Borrow(uint64_t Position, uint64_t Count);
 
 	private:
 		// Memory flags cached
@@ -0,0 +1,281 @@
+#include "stdafx.h"
+#include "NumberFormatter.h"
+#include <charconv>
+#include <cmath>
+#include <cctype>
+
+namespace IO
+{
+	uint32_t NumberFormatter::FormatFixed(char* Buffer, uint32_t BufferSize, double Value, uint32_t Precision)
+	{
+		auto Result = std::to_chars(Buffer, Buffer + BufferSize, Value, std::chars_format::fixed, (int)Precision);
+
+		if (Result.ec != std::errc())
+			return 0;
+
+		return (uint32_t)(Result.ptr - Buffer);
+	}
+
+	uint32_t NumberFormatter::FormatShortest(char* Buffer, uint32_t BufferSize, float Value)
+	{
+		auto Result = std::to_chars(Buffer, Buffer + BufferSize, Value);
+
+		if (Result.ec != std::errc())
+			return 0;
+
+		return (uint32_t)(Result.ptr - Buffer);
+	}
+
+	uint32_t NumberFormatter::FormatShortest(char* Buffer, uint32_t BufferSize, double Value)
+	{
+		auto Result = std::to_chars(Buffer, Buffer + BufferSize, Value);
+
+		if (Result.ec != std::errc())
+			return 0;
+
+		return (uint32_t)(Result.ptr - Buffer);
+	}
+
+	uint32_t NumberFormatter::FormatInteger(char* Buffer, uint32_t BufferSize, int64_t Value)
+	{
+		auto Result = std::to_chars(Buffer, Buffer + BufferSize, Value);
+
+		if (Result.ec != std::errc())
+			return 0;
+
+		return (uint32_t)(Result.ptr - Buffer);
+	}
+
+	uint32_t NumberFormatter::FormatInteger(char* Buffer, uint32_t BufferSize, uint64_t Value)
+	{
+		auto Result = std::to_chars(Buffer, Buffer + BufferSize, Value);
+
+		if (Result.ec != std::errc())
+			return 0;
+
+		return (uint32_t)(Result.ptr - Buffer);
+	}
+
+	int32_t NumberFormatter::FormatPrintf(char* Buffer, uint32_t BufferSize, const char* Format, va_list Args)
+	{
+		uint32_t Length = 0;
+
+		while (*Format)
+		{
+			if (*Format != '%')
+			{
+				// Copy the text up to the next conversion in one go
+				auto Next = Format;
+				while (*Next && *Next != '%')
+					Next++;
+
+				const uint32_t Count = (uint32_t)(Next - Format);
+
+				if (Length + Count > BufferSize)
+					return -1;
+
+				std::memcpy(Buffer + Length, Format, Count);
+				Length += Count;
+				Format = Next;
+				continue;
+			}
+
+			Format++;
+
+			bool LeftAlign = false;
+			bool ZeroPad = false;
+
+			for (;; Format++)
+			{
+				if (*Format == '-')
+					LeftAlign = true;
+				else if (*Format == '0')
+					ZeroPad = true;
+				else if (*Format == '+' || *Format == ' ' || *Format == '#')
+					return -1;
+				else
+					break;
+			}
+
+			uint32_t Width = 0;
+			while (*Format >= '0' && *Format <= '9')
+				Width = Width * 10 + (*Format++ - '0');
+
+			if (*Format == '*')
+				return -1;
+
+			int32_t Precision = -1;
+
+			if (*Format == '.')
+			{
+				Format++;
+
+				if (*Format == '*')
+					return -1;
+
+				Precision = 0;
+				while (*Format >= '0' && *Format <= '9')
+					Precision = Precision * 10 + (*Format++ - '0');
+			}
+
+			// 0 = int, 1 = long, 2 = long long, -1 = short
+			int32_t Size = 0;
+
+			if (*Format == 'h')
+			{
+				Size = -1;
+				Format++;
+			}
+			else if (*Format == 'l')
+			{
+				Size = 1;
+				Format++;
+
+				if (*Format == 'l')
+				{
+					Size = 2;
+					Format++;
+				}
+			}
+
+			// The text of the conversion, before it's padded to the width
+			char Value[384];
+			const char* ValueText = Value;
+			uint32_t ValueLength = 0;
+			bool Numeric = true;
+
+			switch (*Format)
+			{
+			case 'd':
+			case 'i':
+			{
+				if (Precision >= 0)
+					return -1;
+
+				int64_t Integer = (Size == 2) ? va_arg(Args, long long) : (Size == 1) ? va_arg(Args, long) : va_arg(Args, int);
+				if (Size == -1)
+					Integer = (short)Integer;
+
+				ValueLength = FormatInteger(Value, sizeof(Value), Integer);
+				break;
+			}
+			case 'u':
+			case 'x':
+			case 'X':
+			{
+				if (Precision >= 0)
+					return -1;
+
+				uint64_t Integer = (Size == 2) ? va_arg(Args, unsigned long long) : (Size == 1) ? va_arg(Args, unsigned long) : va_arg(Args, unsigned int);
+				if (Size == -1)
+					Integer = (unsigned short)Integer;
+
+				if (*Format == 'u')
+				{
+					ValueLength = FormatInteger(Value, sizeof(Value), Integer);
+				}
+				else
+				{
+					auto Result = std::to_chars(Value, Value + sizeof(Value), Integer, 16);
+					ValueLength = (uint32_t)(Result.ptr - Value);
+
+					if (*Format == 'X')
+					{
+						for (uint32_t i = 0; i < ValueLength; i++)
+							Value[i] = (char)toupper(Value[i]);
+					}
+				}
+				break;
+			}
+			case 'f':
+			case 'F':
+			{
+				if (Size != 0)
+					return -1;
+
+				const double Float = va_arg(Args, double);
+
+				// Infinities and nans are spelled differently by every crt
+				if (!std::isfinite(Float))
+					return -1;
+
+				ValueLength = FormatFixed(Value, sizeof(Value), Float, (Precision >= 0) ? Precision : 6);
+				if (ValueLength == 0)
+					return -1;
+				break;
+			}
+			case 'c':
+			{
+				if (Size != 0 || Precision >= 0 || ZeroPad)
+					return -1;
+
+				Value[0] = (char)va_arg(Args, int);
+				ValueLength = 1;
+				Numeric = false;
+				break;
+			}
+			case 's':
+			{
+				if (Size != 0 || ZeroPad)
+					return -1;
+
+				ValueText = va_arg(Args, const char*);
+
+				if (ValueText == nullptr)
+					return -1;
+
+				ValueLength = (uint32_t)strlen(ValueText);
+
+				if (Precision >= 0)
+					ValueLength = min(ValueLength, (uint32_t)Precision);
+
+				Numeric = false;
+				break;
+			}
+			case '%':
+			{
+				if (Width != 0 || Precision >= 0 || Size != 0 || LeftAlign || ZeroPad)
+					return -1;
+
+				Value[0] = '%';
+				ValueLength = 1;
+				Numeric = false;
+				break;
+			}
+			default:
+				return -1;
+			}
+
+			Format++;
+
+			const uint32_t Padding = (Width > ValueLength) ? (Width - ValueLength) : 0;
+
+			if (Length + ValueLength + Padding > BufferSize)
+				return -1;
+
+			if (LeftAlign)
+			{
+				std::memcpy(Buffer + Length, ValueText, ValueLength);
+				std::memset(Buffer + Length + ValueLength, ' ', Padding);
+			}
+			else if (ZeroPad && Numeric)
+			{
+				// Zeros go between the sign and the digits
+				uint32_t Sign = (ValueText[0] == '-') ? 1 : 0;
+
+				std::memcpy(Buffer + Length, ValueText, Sign);
+				std::memset(Buffer + Length + Sign, '0', Padding);
+				std::memcpy(Buffer + Length + Sign + Padding, ValueText + Sign, ValueLength - Sign);
+			}
+			else
+			{
+				std::memset(Buffer + Length, ' ', Padding);
+				std::memcpy(Buffer + Length + Padding, ValueText, ValueLength);
+			}
+
+			Length += ValueLength + Padding;
+		}
+
+		return (int32_t)Length;
+	}
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdarg>
+
+namespace IO
+{
+	// Locale independent number formatting for text exporters, results match printf byte for byte.
+	class NumberFormatter
+	{
+	public:
+		// Formats the value with a fixed count of decimals, like %.*f, returns the length or 0 if the buffer is too small.
+		static uint32_t FormatFixed(char* Buffer, uint32_t BufferSize, double Value, uint32_t Precision = 6);
+		// Formats the value with the fewest digits that read back to the same float, returns the length or 0 if the buffer is too small.
+		static uint32_t FormatShortest(char* Buffer, uint32_t BufferSize, float Value);
+		// Formats the value with the fewest digits that read back to the same double, returns the length or 0 if the buffer is too small.
+		static uint32_t FormatShortest(char* Buffer, uint32_t BufferSize, double Value);
+		// Formats the integer in base 10, returns the length or 0 if the buffer is too small.
+		static uint32_t FormatInteger(char* Buffer, uint32_t BufferSize, int64_t Value);
+		// Formats the integer in base 10, returns the length or 0 if the buffer is too small.
+		static uint32_t FormatInteger(char* Buffer, uint32_t BufferSize, uint64_t Value);
+
+		// Formats a printf style string without the crt, supports the d, i, u, x, X, f, F, c, s and % conversions with the
+		// 0 and - flags, a width, a precision and the h, l and ll modifiers. Returns the length, or -1 if the format
+		// uses anything else or the buffer is too small, in which case the arguments must be formatted with vsnprintf.
+		static int32_t FormatPrintf(char* Buffer, uint32_t BufferSize, const char* Format, va_list Args);
+	};
+}
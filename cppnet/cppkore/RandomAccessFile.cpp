@@ -0,0 +1,120 @@
+#include "stdafx.h"
+#include "RandomAccessFile.h"
+#include "IOError.h"
+
+namespace IO
+{
+	// An event per thread, used to wait on overlapped reads
+	struct RandomAccessReadEvent
+	{
+		HANDLE Handle;
+
+		RandomAccessReadEvent()
+			: Handle(CreateEventA(NULL, TRUE, FALSE, NULL))
+		{
+		}
+
+		~RandomAccessReadEvent()
+		{
+			if (this->Handle)
+				CloseHandle(this->Handle);
+		}
+	};
+
+	static thread_local RandomAccessReadEvent ReadEvent;
+
+	RandomAccessFile::RandomAccessFile(const string& Path)
+		: _Handle(nullptr), _Length(0)
+	{
+		// Overlapped handles don't serialize reads from multiple threads
+		auto hFile = CreateFileA((const char*)Path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS | FILE_FLAG_OVERLAPPED, NULL);
+		if (hFile == INVALID_HANDLE_VALUE)
+		{
+			switch (GetLastError())
+			{
+			case ERROR_PATH_NOT_FOUND:
+				IOError::StreamPathInvalid();
+				break;
+			case ERROR_FILE_NOT_FOUND:
+				IOError::StreamFileNotFound();
+				break;
+			case ERROR_SHARING_VIOLATION:
+				IOError::StreamInUse();
+				break;
+			case ERROR_ACCESS_DENIED:
+				IOError::StreamAccessDenied();
+				break;
+			default:
+				IOError::StreamUnknown();
+				break;
+			}
+		}
+
+		this->_Handle = hFile;
+
+		LARGE_INTEGER Size{};
+		GetFileSizeEx(this->_Handle, &Size);
+
+		this->_Length = (uint64_t)Size.QuadPart;
+	}
+
+	RandomAccessFile::~RandomAccessFile()
+	{
+		this->Close();
+	}
+
+	uint64_t RandomAccessFile::GetLength() const
+	{
+		return this->_Length;
+	}
+
+	uint64_t RandomAccessFile::Read(uint8_t* Buffer, uint64_t Offset, uint64_t Count, uint64_t Position) const
+	{
+		if (!this->_Handle)
+			IOError::StreamNotOpen();
+
+		auto ReadPtr = (Buffer + Offset);
+		uint64_t TotalRead = 0;
+
+		while (Count > 0)
+		{
+			// Calculate based on DWORD MAX value due to API limitations
+			auto Want = (Count > UINT32_MAX) ? UINT32_MAX : Count;
+
+			OVERLAPPED Overlapped{};
+			Overlapped.Offset = (DWORD)Position;
+			Overlapped.OffsetHigh = (DWORD)(Position >> 32);
+			Overlapped.hEvent = ReadEvent.Handle;
+
+			// Reading past the end fails with ERROR_HANDLE_EOF
+			if (!ReadFile(this->_Handle, ReadPtr, (DWORD)Want, NULL, &Overlapped) && GetLastError() != ERROR_IO_PENDING)
+				break;
+
+			DWORD nRead = 0;
+			if (!GetOverlappedResult(this->_Handle, &Overlapped, &nRead, TRUE) || nRead == 0)
+				break;
+
+			// Adjust counts
+			TotalRead += nRead;
+			Count -= nRead;
+			ReadPtr += nRead;
+			Position += nRead;
+		}
+
+		return TotalRead;
+	}
+
+	void RandomAccessFile::Close()
+	{
+		if (this->_Handle)
+			CloseHandle(this->_Handle);
+
+		this->_Handle = nullptr;
+		this->_Length = 0;
+	}
+
+	std::unique_ptr<RandomAccessFile> RandomAccessFile::OpenRead(const string& Path)
+	{
+		return std::make_unique<RandomAccessFile>(Path);
+	}
+}
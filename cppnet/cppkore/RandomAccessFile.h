@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <Windows.h>
+#include "StringBase.h"
+
+namespace IO
+{
+	// RandomAccessFile supports positional reads from a file that can be shared between threads
+	class RandomAccessFile
+	{
+	public:
+		RandomAccessFile(const string& Path);
+		~RandomAccessFile();
+
+		// The handle is owned by this instance, it can't be copied
+		RandomAccessFile(const RandomAccessFile&) = delete;
+		RandomAccessFile& operator=(const RandomAccessFile&) = delete;
+
+		// Returns the length of the file
+		uint64_t GetLength() const;
+
+		// Reads data at the given position, without touching any shared file pointer
+		uint64_t Read(uint8_t* Buffer, uint64_t Offset, uint64_t Count, uint64_t Position) const;
+
+		// Closes the underlying handle
+		void Close();
+
+		// Opens a file in a particular path for positional reading
+		static std::unique_ptr<RandomAccessFile> OpenRead(const string& Path);
+
+	private:
+		// The native handle
+		HANDLE _Handle;
+
+		// The length of the file when it was opened
+		uint64_t _Length;
+	};
+}
@@ -0,0 +1,185 @@
+#include "stdafx.h"
+#include "RandomAccessStream.h"
+
+namespace IO
+{
+	RandomAccessStream::RandomAccessStream(std::shared_ptr<RandomAccessFile> File)
+		: RandomAccessStream(std::move(File), RandomAccessStream::DefaultBufferSize)
+	{
+	}
+
+	RandomAccessStream::RandomAccessStream(std::shared_ptr<RandomAccessFile> File, uint32_t BufferSize)
+		: _File(std::move(File)), _Buffer(nullptr), _BufferSize(BufferSize), _BufferPosition(0), _BufferLength(0), _Position(0)
+	{
+	}
+
+	RandomAccessStream::~RandomAccessStream()
+	{
+		this->Close();
+	}
+
+	bool RandomAccessStream::CanRead()
+	{
+		return (this->_File != nullptr);
+	}
+
+	bool RandomAccessStream::CanWrite()
+	{
+		return false;
+	}
+
+	bool RandomAccessStream::CanSeek()
+	{
+		return (this->_File != nullptr);
+	}
+
+	bool RandomAccessStream::GetIsEndOfFile()
+	{
+		return (this->_Position >= this->GetLength());
+	}
+
+	uint64_t RandomAccessStream::GetLength()
+	{
+		if (!this->_File)
+			IOError::StreamNotOpen();
+
+		return this->_File->GetLength();
+	}
+
+	uint64_t RandomAccessStream::GetPosition()
+	{
+		if (!this->_File)
+			IOError::StreamNotOpen();
+
+		return this->_Position;
+	}
+
+	void RandomAccessStream::SetLength(uint64_t Length)
+	{
+		IOError::StreamSetLengthSupport();
+	}
+
+	void RandomAccessStream::SetPosition(uint64_t Position)
+	{
+		if (!this->_File)
+			IOError::StreamNotOpen();
+
+		// The buffer is kept, it's only used when it covers the new position
+		this->_Position = Position;
+	}
+
+	void RandomAccessStream::Close()
+	{
+		// Only our reference is released, other views keep the file open
+		this->_File.reset();
+		this->_Buffer.reset();
+
+		this->_BufferPosition = 0;
+		this->_BufferLength = 0;
+	}
+
+	void RandomAccessStream::Flush()
+	{
+		// Nothing to flush, we never write
+	}
+
+	void RandomAccessStream::Seek(uint64_t Offset, SeekOrigin Origin)
+	{
+		if (!this->_File)
+			IOError::StreamNotOpen();
+
+		switch (Origin)
+		{
+		case SeekOrigin::Begin:
+			this->_Position = Offset;
+			break;
+		case SeekOrigin::Current:
+			this->_Position += Offset;
+			break;
+		case SeekOrigin::End:
+			this->_Position = this->GetLength() + Offset;
+			break;
+		}
+	}
+
+	uint64_t RandomAccessStream::Read(uint8_t* Buffer, uint64_t Offset, uint64_t Count)
+	{
+		if (!this->_File)
+			IOError::StreamNotOpen();
+
+		// Large reads go straight to the file
+		if (Count >= this->_BufferSize)
+		{
+			auto Result = this->_File->Read(Buffer, Offset, Count, this->_Position);
+			this->_Position += Result;
+
+			return Result;
+		}
+
+		// Refill the buffer when it doesn't cover the whole request
+		if (this->_Position < this->_BufferPosition || (this->_Position + Count) > (this->_BufferPosition + this->_BufferLength))
+		{
+			if (!this->_Buffer)
+				this->_Buffer = std::make_unique<uint8_t[]>(this->_BufferSize);
+
+			this->_BufferPosition = this->_Position;
+			this->_BufferLength = this->_File->Read(this->_Buffer.get(), 0, this->_BufferSize, this->_Position);
+		}
+
+		uint64_t BufferRemaining = (this->_BufferPosition + this->_BufferLength) - this->_Position;
+		if (BufferRemaining > Count)
+			BufferRemaining = Count;
+
+		std::memcpy(Buffer + Offset, this->_Buffer.get() + (this->_Position - this->_BufferPosition), BufferRemaining);
+		this->_Position += BufferRemaining;
+
+		return BufferRemaining;
+	}
+
+	uint64_t RandomAccessStream::Read(uint8_t* Buffer, uint64_t Offset, uint64_t Count, uint64_t Position)
+	{
+		this->SetPosition(Position);
+		return this->Read(Buffer, Offset, Count);
+	}
+
+	const uint8_t* RandomAccessStream::PeekBuffer(uint64_t& Count)
+	{
+		if (!this->_File)
+			IOError::StreamNotOpen();
+
+		if (this->_Position < this->_BufferPosition || this->_Position >= (this->_BufferPosition + this->_BufferLength))
+		{
+			if (!this->_Buffer)
+				this->_Buffer = std::make_unique<uint8_t[]>(this->_BufferSize);
+
+			this->_BufferPosition = this->_Position;
+			this->_BufferLength = this->_File->Read(this->_Buffer.get(), 0, this->_BufferSize, this->_Position);
+		}
+
+		Count = (this->_BufferPosition + this->_BufferLength) - this->_Position;
+		return this->_Buffer.get() + (this->_Position - this->_BufferPosition);
+	}
+
+	void RandomAccessStream::Advance(uint64_t Count)
+	{
+		this->_Position += Count;
+	}
+
+	uint64_t RandomAccessStream::ReadAt(uint8_t* Buffer, uint64_t Offset, uint64_t Count, uint64_t Position)
+	{
+		if (!this->_File)
+			IOError::StreamNotOpen();
+
+		return this->_File->Read(Buffer, Offset, Count, Position);
+	}
+
+	void RandomAccessStream::Write(uint8_t* Buffer, uint64_t Offset, uint64_t Count)
+	{
+		IOError::StreamNoWriteSupport();
+	}
+
+	void RandomAccessStream::Write(uint8_t* Buffer, uint64_t Offset, uint64_t Count, uint64_t Position)
+	{
+		IOError::StreamNoWriteSupport();
+	}
+}
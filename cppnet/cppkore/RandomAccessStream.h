@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "Stream.h"
+#include "RandomAccessFile.h"
+
+namespace IO
+{
+	// RandomAccessStream is a read-only view over a shared RandomAccessFile, with it's own position
+	class RandomAccessStream : public Stream
+	{
+	public:
+		RandomAccessStream(std::shared_ptr<RandomAccessFile> File);
+		RandomAccessStream(std::shared_ptr<RandomAccessFile> File, uint32_t BufferSize);
+		virtual ~RandomAccessStream();
+
+		// Implement Getters and Setters
+		virtual bool CanRead();
+		virtual bool CanWrite();
+		virtual bool CanSeek();
+		virtual bool GetIsEndOfFile();
+		virtual uint64_t GetLength();
+		virtual uint64_t GetPosition();
+		virtual void SetLength(uint64_t Length);
+		virtual void SetPosition(uint64_t Position);
+
+		// Implement functions
+		virtual void Close();
+		virtual void Flush();
+		virtual void Seek(uint64_t Offset, SeekOrigin Origin);
+		virtual uint64_t Read(uint8_t* Buffer, uint64_t Offset, uint64_t Count);
+		virtual uint64_t Read(uint8_t* Buffer, uint64_t Offset, uint64_t Count, uint64_t Position);
+		virtual void Write(uint8_t* Buffer, uint64_t Offset, uint64_t Count);
+		virtual void Write(uint8_t* Buffer, uint64_t Offset, uint64_t Count, uint64_t Position);
+		virtual uint64_t ReadAt(uint8_t* Buffer, uint64_t Offset, uint64_t Count, uint64_t Position);
+		virtual const uint8_t* PeekBuffer(uint64_t& Count);
+		virtual void Advance(uint64_t Count);
+
+	private:
+		// The shared file
+		std::shared_ptr<RandomAccessFile> _File;
+
+		// Internal read buffer, and the file position it starts at
+		std::unique_ptr<uint8_t[]> _Buffer;
+		uint32_t _BufferSize;
+		uint64_t _BufferPosition;
+		uint64_t _BufferLength;
+
+		// Our position in the file
+		uint64_t _Position;
+
+		// Internal buffer size default 4k
+		constexpr static uint32_t DefaultBufferSize = 4096;
+	};
+}
@@ -90,7 +90,7 @@ namespace Assets::Exporters
 		{
 			Dictionary<string, uint32_t> SEBones;
 
-			for (auto& Kvp : Animation.Curves)
+			for (auto& Kvp : Animation.GetCurves())
 			{
 				for (auto& Curve : Kvp.Value())
 				{
@@ -136,9 +136,9 @@ namespace Assets::Exporters
 		{
 			auto& Bone = Bones[i];
 
-			if (Animation.Curves.ContainsKey(Bone))
+			if (Animation.GetCurves().ContainsKey(Bone))
 			{
-				auto& Curves = Animation.Curves[Bone];
+				auto& Curves = Animation.GetCurves()[Bone];
 
 				for (auto& Curve : Curves)
 				{
@@ -208,7 +208,7 @@ namespace Assets::Exporters
 		{
 			Writer.Write<uint8_t>(0);	// Flags
 
-			auto& BoneCurves = Animation.Curves[Bones[i]];
+			auto& BoneCurves = Animation.GetCurves()[Bones[i]];
 
 			int32_t TrackSlots[7] = { -1, -1, -1, -1, -1, -1, -1 };
 
@@ -31,6 +31,31 @@ namespace IO
 		virtual void Write(uint8_t* Buffer, uint64_t Offset, uint64_t Count) = 0;
 		virtual void Write(uint8_t* Buffer, uint64_t Offset, uint64_t Count, uint64_t Position) = 0;
 
+		// Returns the data readable at the current position without copying, filling the buffer when it's empty.
+		// Count is zero at the end of the stream, nullptr means the stream has no buffer to expose.
+		virtual const uint8_t* PeekBuffer(uint64_t& Count)
+		{
+			Count = 0;
+			return nullptr;
+		}
+
+		// Moves past Count bytes of the data returned by PeekBuffer
+		virtual void Advance(uint64_t Count)
+		{
+			this->Seek(Count, SeekOrigin::Current);
+		}
+
+		// Reads data at the given position, leaving the stream position untouched
+		virtual uint64_t ReadAt(uint8_t* Buffer, uint64_t Offset, uint64_t Count, uint64_t Position)
+		{
+			auto OldPosition = this->GetPosition();
+			auto Result = this->Read(Buffer, Offset, Count, Position);
+
+			this->SetPosition(OldPosition);
+
+			return Result;
+		}
+
 		// Copies all of the data from the current position to the target stream
 		void CopyTo(Stream& Rhs)
 		{
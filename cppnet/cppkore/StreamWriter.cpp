@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "StreamWriter.h"
+#include "NumberFormatter.h"
 
 namespace IO
 {
@@ -14,6 +15,7 @@ namespace IO
 	}
 
 	StreamWriter::StreamWriter(std::unique_ptr<Stream> Stream, bool LeaveOpen)
+		: _Buffer(nullptr), _BufferSize(0), _BufferPosition(0)
 	{
 		this->BaseStream = std::move(Stream);
 		this->_LeaveOpen = LeaveOpen;
@@ -25,6 +27,7 @@ namespace IO
 	}
 
 	StreamWriter::StreamWriter(Stream* Stream, bool LeaveOpen)
+		: _Buffer(nullptr), _BufferSize(0), _BufferPosition(0)
 	{
 		this->BaseStream.reset(Stream);
 		this->_LeaveOpen = LeaveOpen;
@@ -37,6 +40,9 @@ namespace IO
 
 	void StreamWriter::Close()
 	{
+		if (this->BaseStream)
+			this->FlushBuffer();
+
 		// Forcefully reset the stream
 		if (this->_LeaveOpen)
 			this->BaseStream.release();
@@ -49,15 +55,13 @@ namespace IO
 		if (!this->BaseStream)
 			IOError::StreamBaseStream();
 
+		this->FlushBuffer();
 		this->BaseStream->Flush();
 	}
 
 	void StreamWriter::Write(const char Value)
 	{
-		if (!this->BaseStream)
-			IOError::StreamBaseStream();
-
-		this->BaseStream->Write((uint8_t*)&Value, 0, 1);
+		this->Write(&Value, 0, 1);
 	}
 
 	void StreamWriter::Write(const char* Buffer, uint32_t Index, uint32_t Count)
@@ -65,7 +69,24 @@ namespace IO
 		if (!this->BaseStream)
 			IOError::StreamBaseStream();
 
-		this->BaseStream->Write((uint8_t*)&Buffer[0], Index, Count);
+		if (this->_BufferSize == 0)
+		{
+			this->BaseStream->Write((uint8_t*)&Buffer[0], Index, Count);
+			return;
+		}
+
+		if (this->_BufferPosition + Count > this->_BufferSize)
+			this->FlushBuffer();
+
+		// Anything larger than the buffer goes straight through
+		if (Count > this->_BufferSize)
+		{
+			this->BaseStream->Write((uint8_t*)&Buffer[0], Index, Count);
+			return;
+		}
+
+		std::memcpy(this->_Buffer.get() + this->_BufferPosition, Buffer + Index, Count);
+		this->_BufferPosition += Count;
 	}
 
 	void StreamWriter::Write(const string& Value)
@@ -96,22 +117,9 @@ namespace IO
 		va_list vArgs;
 		va_start(vArgs, Format);
 
-		char StackFmt[FormatBufferSize];
-		auto ResultFmt = vsnprintf(StackFmt, FormatBufferSize, Format, vArgs);
+		this->WriteFormatted(Format, vArgs, false);
 
-		if (ResultFmt > 0 && ResultFmt < FormatBufferSize)
-		{
-			va_end(vArgs);
-			this->Write((const char*)StackFmt, 0, (uint32_t)ResultFmt);
-			return;
-		}
-
-		auto HeapFmt = std::make_unique<char[]>(ResultFmt + 1);
-
-		vsnprintf(HeapFmt.get(), ResultFmt + 1, Format, vArgs);
 		va_end(vArgs);
-
-		this->Write((const char*)HeapFmt.get(), 0, (uint32_t)ResultFmt);
 	}
 
 	void StreamWriter::WriteLineFmt(const char* Format, ...)
@@ -125,22 +133,9 @@ namespace IO
 			va_list vArgs;
 			va_start(vArgs, Format);
 
-			char StackFmt[FormatBufferSize];
-			auto ResultFmt = vsnprintf(StackFmt, FormatBufferSize, Format, vArgs);
+			this->WriteFormatted(Format, vArgs, true);
 
-			if (ResultFmt > 0 && ResultFmt < FormatBufferSize)
-			{
-				va_end(vArgs);
-				TextWriter::WriteLine((const char*)StackFmt, 0, (uint32_t)ResultFmt);
-				return;
-			}
-
-			auto HeapFmt = std::make_unique<char[]>(ResultFmt + 1);
-
-			vsnprintf(HeapFmt.get(), ResultFmt + 1, Format, vArgs);
 			va_end(vArgs);
-
-			TextWriter::WriteLine((const char*)HeapFmt.get(), 0, (uint32_t)ResultFmt);
 		}
 	}
 
@@ -148,4 +143,60 @@ namespace IO
 	{
 		return this->BaseStream.get();
 	}
+
+	void StreamWriter::SetBufferSize(uint32_t Size)
+	{
+		this->FlushBuffer();
+
+		this->_Buffer = (Size > 0) ? std::make_unique<char[]>(Size) : nullptr;
+		this->_BufferSize = Size;
+	}
+
+	void StreamWriter::FlushBuffer()
+	{
+		if (this->_BufferPosition == 0)
+			return;
+
+		this->BaseStream->Write((uint8_t*)this->_Buffer.get(), 0, this->_BufferPosition);
+		this->_BufferPosition = 0;
+	}
+
+	void StreamWriter::WriteFormatted(const char* Format, va_list Args, bool NewLine)
+	{
+		char StackFmt[FormatBufferSize];
+
+		// The fast formatter consumes the arguments, keep a copy in case it has to fall back
+		va_list vArgs;
+		va_copy(vArgs, Args);
+
+		auto ResultFmt = NumberFormatter::FormatPrintf(StackFmt, FormatBufferSize, Format, vArgs);
+		va_end(vArgs);
+
+		if (ResultFmt < 0)
+		{
+			va_copy(vArgs, Args);
+			ResultFmt = vsnprintf(StackFmt, FormatBufferSize, Format, vArgs);
+			va_end(vArgs);
+		}
+
+		if (ResultFmt >= 0 && ResultFmt < FormatBufferSize)
+		{
+			if (NewLine)
+				TextWriter::WriteLine((const char*)StackFmt, 0, (uint32_t)ResultFmt);
+			else
+				this->Write((const char*)StackFmt, 0, (uint32_t)ResultFmt);
+			return;
+		}
+
+		auto HeapFmt = std::make_unique<char[]>(ResultFmt + 1);
+
+		va_copy(vArgs, Args);
+		vsnprintf(HeapFmt.get(), ResultFmt + 1, Format, vArgs);
+		va_end(vArgs);
+
+		if (NewLine)
+			TextWriter::WriteLine((const char*)HeapFmt.get(), 0, (uint32_t)ResultFmt);
+		else
+			this->Write((const char*)HeapFmt.get(), 0, (uint32_t)ResultFmt);
+	}
 }
\ No newline at end of file
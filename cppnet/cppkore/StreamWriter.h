@@ -42,10 +42,26 @@ namespace IO
 		// Get the underlying stream
 		Stream* GetBaseStream() const;
 
+		// Collects writes into a buffer of the size before they hit the stream, 0 writes straight through (Default: 0)
+		void SetBufferSize(uint32_t Size);
+
+		// The buffer size used by the exporters
+		static uint32_t constexpr ExportBufferSize = 0x100000;
+
 	private:
 		std::unique_ptr<Stream> BaseStream;
 		bool _LeaveOpen;
 
+		// Used for buffering writes
+		std::unique_ptr<char[]> _Buffer;
+		uint32_t _BufferSize;
+		uint32_t _BufferPosition;
+
+		// Writes the buffered text to the stream
+		void FlushBuffer();
+		// Formats into the stack buffer with the fast formatter, falling back to the crt, then writes it
+		void WriteFormatted(const char* Format, va_list Args, bool NewLine);
+
 		// Used for the built-in format buffer
 		static uint32_t constexpr FormatBufferSize = 4096;
 	};
@@ -31,6 +31,7 @@ namespace Assets::Exporters
 	bool ValveSMD::ExportModel(const Model& Model, const string& Path)
 	{
 		auto Writer = IO::StreamWriter(IO::File::Create(Path));
+		Writer.SetBufferSize(IO::StreamWriter::ExportBufferSize);
 
 		Writer.WriteLine(
 			"version 1\n"
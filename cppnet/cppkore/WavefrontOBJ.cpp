@@ -7,6 +7,11 @@
 
 namespace Assets::Exporters
 {
+	WavefrontOBJ::WavefrontOBJ(bool Indexed)
+		: _Indexed(Indexed)
+	{
+	}
+
 	bool WavefrontOBJ::ExportAnimation(const Animation& Animation, const string& Path)
 	{
 		return false;
@@ -15,10 +20,128 @@ namespace Assets::Exporters
 	bool WavefrontOBJ::ExportModel(const Model& Model, const string& Path)
 	{
 		auto Writer = IO::StreamWriter(IO::File::Create(Path));
+		Writer.SetBufferSize(IO::StreamWriter::ExportBufferSize);
 		auto MaterialPath = IO::Path::ChangeExtension(Path, ".mtl");
 
 		Writer.WriteLineFmt("\nmtllib %s\n", (char*)IO::Path::GetFileName(MaterialPath));
 
+		if (this->_Indexed)
+			this->WriteIndexed(Writer, Model);
+		else
+			this->WriteFlat(Writer, Model);
+
+		auto MatWriter = IO::StreamWriter(IO::File::Create(MaterialPath));
+
+		for (auto& Material : Model.Materials)
+		{
+			MatWriter.WriteLineFmt("newmtl %s", (char*)Material.Name);
+
+			MatWriter.WriteLine(
+				"illum 4\n"
+				"Kd 0.00 0.00 0.00\n"
+				"Ka 0.00 0.00 0.00\n"
+				"Ks 0.50 0.50 0.50"
+			);
+
+			if (Material.Slots.ContainsKey(MaterialSlotType::Albedo))
+				MatWriter.WriteLineFmt("map_Kd %s", (char*)Material.Slots[MaterialSlotType::Albedo].first);
+			else if (Material.Slots.ContainsKey(MaterialSlotType::Diffuse))
+				MatWriter.WriteLineFmt("map_Kd %s", (char*)Material.Slots[MaterialSlotType::Diffuse].first);
+
+			if (Material.Slots.ContainsKey(MaterialSlotType::Normal))
+				MatWriter.WriteLineFmt("map_bump %s", (char*)Material.Slots[MaterialSlotType::Normal].first);
+			if (Material.Slots.ContainsKey(MaterialSlotType::Specular))
+				MatWriter.WriteLineFmt("map_Ks %s", (char*)Material.Slots[MaterialSlotType::Specular].first);
+		}
+
+		return true;
+	}
+
+	imstring WavefrontOBJ::ModelExtension()
+	{
+		return ".obj";
+	}
+
+	imstring WavefrontOBJ::AnimationExtension()
+	{
+		return nullptr;
+	}
+
+	ExporterScale WavefrontOBJ::ExportScale()
+	{
+		// OBJ is considered generic, so we won't enforce a scale constant
+		return ExporterScale::Default;
+	}
+
+	bool WavefrontOBJ::SupportsAnimations()
+	{
+		return false;
+	}
+
+	bool WavefrontOBJ::SupportsModels()
+	{
+		return true;
+	}
+
+	void WavefrontOBJ::WriteIndexed(IO::StreamWriter& Writer, const Model& Model)
+	{
+		for (auto& Submesh : Model.Meshes)
+		{
+			for (auto& Vertex : Submesh.Vertices)
+			{
+				auto& Position = Vertex.Position();
+
+				Writer.WriteLineFmt("v %f %f %f", Position.X, Position.Y, Position.Z);
+			}
+		}
+
+		for (auto& Submesh : Model.Meshes)
+		{
+			for (auto& Vertex : Submesh.Vertices)
+			{
+				auto& UVLayer = Vertex.UVLayers(0);
+
+				Writer.WriteLineFmt("vt %f %f", UVLayer.U, (1 - UVLayer.V));
+			}
+		}
+
+		for (auto& Submesh : Model.Meshes)
+		{
+			for (auto& Vertex : Submesh.Vertices)
+			{
+				auto& Normal = Vertex.Normal();
+
+				Writer.WriteLineFmt("vn %f %f %f", Normal.X, Normal.Y, Normal.Z);
+			}
+		}
+
+		// Obj indices are global and one based, each mesh starts after the vertices of the ones before it
+		uint32_t VertexOffset = 1;
+
+		for (auto& Submesh : Model.Meshes)
+		{
+			this->WriteGroup(Writer, Model, Submesh);
+
+			for (auto& Face : Submesh.Faces)
+			{
+				const uint32_t Index1 = VertexOffset + Face[2];
+				const uint32_t Index2 = VertexOffset + Face[1];
+				const uint32_t Index3 = VertexOffset + Face[0];
+
+				Writer.WriteLineFmt(
+					"f %u/%u/%u %u/%u/%u %u/%u/%u",
+					Index1, Index1, Index1,
+					Index2, Index2, Index2,
+					Index3, Index3, Index3
+				);
+			}
+
+			VertexOffset += Submesh.Vertices.Count();
+		}
+	}
+
+	void WavefrontOBJ::WriteFlat(IO::StreamWriter& Writer, const Model& Model)
+	{
 		for (auto& Submesh : Model.Meshes)
 		{
 			for (auto& Face : Submesh.Faces)
@@ -80,24 +203,7 @@ namespace Assets::Exporters
 
 		for (auto& Submesh : Model.Meshes)
 		{
-			if (Submesh.MaterialIndices[0] > -1)
-			{
-				auto& Material = Model.Materials[Submesh.MaterialIndices[0]];
-
-				Writer.WriteLineFmt(
-					"g %s\n"
-					"usemtl %s",
-					(char*)Material.Name,
-					(char*)Material.Name
-				);
-			}
-			else
-			{
-				Writer.WriteLine(
-					"g default_material\n"
-					"usemtl default_material"
-				);
-			}
+			this->WriteGroup(Writer, Model, Submesh);
 
 			for (auto& Face : Submesh.Faces)
 			{
@@ -111,58 +217,27 @@ namespace Assets::Exporters
 				VertexIndex += 3;
 			}
 		}
+	}
 
-		
-		auto MatWriter = IO::StreamWriter(IO::File::Create(MaterialPath));
-
-		for (auto& Material : Model.Materials)
+	void WavefrontOBJ::WriteGroup(IO::StreamWriter& Writer, const Model& Model, const Mesh& Submesh)
+	{
+		if (Submesh.MaterialIndices[0] > -1)
 		{
-			MatWriter.WriteLineFmt("newmtl %s", (char*)Material.Name);
+			auto& Material = Model.Materials[Submesh.MaterialIndices[0]];
 
-			MatWriter.WriteLine(
-				"illum 4\n"
-				"Kd 0.00 0.00 0.00\n"
-				"Ka 0.00 0.00 0.00\n"
-				"Ks 0.50 0.50 0.50"
+			Writer.WriteLineFmt(
+				"g %s\n"
+				"usemtl %s",
+				(char*)Material.Name,
+				(char*)Material.Name
+			);
+		}
+		else
+		{
+			Writer.WriteLine(
+				"g default_material\n"
+				"usemtl default_material"
 			);
-
-			if (Material.Slots.ContainsKey(MaterialSlotType::Albedo))
-				MatWriter.WriteLineFmt("map_Kd %s", (char*)Material.Slots[MaterialSlotType::Albedo].first);
-			else if (Material.Slots.ContainsKey(MaterialSlotType::Diffuse))
-				MatWriter.WriteLineFmt("map_Kd %s", (char*)Material.Slots[MaterialSlotType::Diffuse].first);
-
-			if (Material.Slots.ContainsKey(MaterialSlotType::Normal))
-				MatWriter.WriteLineFmt("map_bump %s", (char*)Material.Slots[MaterialSlotType::Normal].first);
-			if (Material.Slots.ContainsKey(MaterialSlotType::Specular))
-				MatWriter.WriteLineFmt("map_Ks %s", (char*)Material.Slots[MaterialSlotType::Specular].first);
 		}
-
-		return true;
-	}
-
-	imstring WavefrontOBJ::ModelExtension()
-	{
-		return ".obj";
-	}
-
-	imstring WavefrontOBJ::AnimationExtension()
-	{
-		return nullptr;
-	}
-
-	ExporterScale WavefrontOBJ::ExportScale()
-	{
-		// OBJ is considered generic, so we won't enforce a scale constant
-		return ExporterScale::Default;
-	}
-
-	bool WavefrontOBJ::SupportsAnimations()
-	{
-		return false;
-	}
-
-	bool WavefrontOBJ::SupportsModels()
-	{
-		return true;
 	}
-}
+}
\ No newline at end of file
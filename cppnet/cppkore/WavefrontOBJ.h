@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include "Exporter.h"
+#include "StreamWriter.h"
 
 namespace Assets::Exporters
 {
@@ -9,7 +10,8 @@ namespace Assets::Exporters
 	class WavefrontOBJ : public Exporter
 	{
 	public:
-		WavefrontOBJ() = default;
+		// Indexed exports write every vertex once and share it between faces, otherwise each face gets three unshared vertices.
+		WavefrontOBJ(bool Indexed = true);
 		~WavefrontOBJ() = default;
 
 		// Exports the given animation to the provided path.
@@ -29,5 +31,15 @@ namespace Assets::Exporters
 		virtual bool SupportsAnimations();
 		// Gets whether or not the exporter supports model exporting.
 		virtual bool SupportsModels();
+
+	private:
+		bool _Indexed;
+
+		// Writes the vertices of every mesh once, faces index into them.
+		void WriteIndexed(IO::StreamWriter& Writer, const Model& Model);
+		// Writes three vertices for every face, the layout older tools expect.
+		void WriteFlat(IO::StreamWriter& Writer, const Model& Model);
+		// Starts the group of a mesh using it's first material.
+		void WriteGroup(IO::StreamWriter& Writer, const Model& Model, const Mesh& Submesh);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,300 @@
+#include "stdafx.h"
+#include "WorkStealingScheduler.h"
+#include <algorithm>
+#include <thread>
+#include "ListBase.h"
+#include "Thread.h"
+
+namespace Threading
+{
+	// The scheduler and worker the current thread belongs to, if any
+	static thread_local WorkStealingScheduler* CurrentScheduler = nullptr;
+	static thread_local uint32_t CurrentWorker = 0;
+
+	TaskGroup::TaskGroup()
+		: _Pending(0)
+	{
+	}
+
+	bool TaskGroup::IsFinished() const
+	{
+		return (this->_Pending == 0);
+	}
+
+	WorkStealingScheduler::WorkStealingScheduler(uint32_t DegreeOfParallelism)
+		: _DegreeOfParallelism(DegreeOfParallelism), _TaskIndex(0), _Outstanding(0), _SignalEpoch(0)
+	{
+		// If value is 0, adjust to core count
+		if (this->_DegreeOfParallelism == 0)
+		{
+			SYSTEM_INFO SysInfo{};
+			GetSystemInfo(&SysInfo);
+
+			// We must always have one thread
+			this->_DegreeOfParallelism = max((uint32_t)1, (uint32_t)SysInfo.dwNumberOfProcessors);
+		}
+	}
+
+	void WorkStealingScheduler::Schedule(std::function<void()> Task, uint64_t Cost)
+	{
+		this->_Tasks.push_back({ std::move(Task), Cost });
+	}
+
+	void WorkStealingScheduler::Run(std::function<void()> WorkerStart, std::function<void()> WorkerExit)
+	{
+		// Most expensive first, equal costs keep the order they were scheduled in
+		std::stable_sort(this->_Tasks.begin(), this->_Tasks.end(), [](const ScheduledTask& Lhs, const ScheduledTask& Rhs)
+		{
+			return Lhs.Cost > Rhs.Cost;
+		});
+
+		this->_TaskIndex = 0;
+		this->_Outstanding = this->_Tasks.size();
+		this->_Exception = nullptr;
+
+		this->_Queues.clear();
+		for (uint32_t i = 0; i < this->_DegreeOfParallelism; i++)
+			this->_Queues.emplace_back(std::make_unique<WorkerQueue>());
+
+		// Worker pool
+		List<Thread> Workers;
+
+		for (uint32_t i = 0; i < this->_DegreeOfParallelism; i++)
+		{
+			Workers.Emplace([this, i, &WorkerStart, &WorkerExit]
+			{
+				if (WorkerStart != nullptr)
+					WorkerStart();
+
+				this->WorkerMain(i);
+
+				if (WorkerExit != nullptr)
+					WorkerExit();
+			}).Start();
+		}
+
+		// Wait for all workers to end
+		for (auto& Worker : Workers)
+		{
+			try
+			{
+				Worker.Join();
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> ExceptionLock(this->_ExceptionLock);
+
+				if (!this->_Exception)
+					this->_Exception = std::current_exception();
+			}
+		}
+
+		this->_Tasks.clear();
+
+		if (this->_Exception)
+		{
+			auto Exception = this->_Exception;
+			this->_Exception = nullptr;
+
+			std::rethrow_exception(Exception);
+		}
+	}
+
+	void WorkStealingScheduler::Spawn(TaskGroup& Group, std::function<void()> Task)
+	{
+		auto Scheduler = CurrentScheduler;
+
+		if (Scheduler == nullptr)
+		{
+			try
+			{
+				Task();
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> ExceptionLock(Group._ExceptionLock);
+
+				if (!Group._Exception)
+					Group._Exception = std::current_exception();
+			}
+
+			return;
+		}
+
+		Group._Pending++;
+		Scheduler->_Outstanding++;
+
+		auto& Queue = *Scheduler->_Queues[CurrentWorker];
+
+		{
+			std::lock_guard<std::mutex> QueueLock(Queue.Lock);
+			Queue.Tasks.push_back({ std::move(Task), &Group });
+		}
+
+		Scheduler->Signal(false);
+	}
+
+	void WorkStealingScheduler::Wait(TaskGroup& Group)
+	{
+		auto Scheduler = CurrentScheduler;
+
+		while (!Group.IsFinished())
+		{
+			// Outside of a worker the sub-tasks already ran inline in Spawn
+			if (Scheduler == nullptr)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			uint64_t Epoch = Scheduler->_SignalEpoch;
+
+			// Help out instead of blocking, our own sub-tasks are first in line
+			if (Scheduler->TryRunSubTask(CurrentWorker, true))
+				continue;
+
+			// Every sub-task finishing signals, so the group is checked again whenever one of it's own does
+			std::unique_lock<std::mutex> SignalLock(Scheduler->_SignalLock);
+			Scheduler->_Signal.wait(SignalLock, [Scheduler, Epoch, &Group]
+			{
+				return Scheduler->_SignalEpoch != Epoch || Group.IsFinished();
+			});
+		}
+
+		std::lock_guard<std::mutex> ExceptionLock(Group._ExceptionLock);
+
+		if (Group._Exception)
+		{
+			auto Exception = Group._Exception;
+			Group._Exception = nullptr;
+
+			std::rethrow_exception(Exception);
+		}
+	}
+
+	void WorkStealingScheduler::WorkerMain(uint32_t WorkerIndex)
+	{
+		CurrentScheduler = this;
+		CurrentWorker = WorkerIndex;
+
+		// Finish sub-tasks of started work before starting new tasks, steal once there's nothing left
+		while (this->_Outstanding > 0)
+		{
+			uint64_t Epoch = this->_SignalEpoch;
+
+			if (this->TryRunSubTask(WorkerIndex, false))
+				continue;
+			if (this->TryRunTask())
+				continue;
+			if (this->TryRunSubTask(WorkerIndex, true))
+				continue;
+
+			this->Idle(Epoch);
+		}
+
+		CurrentScheduler = nullptr;
+		CurrentWorker = 0;
+	}
+
+	bool WorkStealingScheduler::TryRunTask()
+	{
+		auto Index = this->_TaskIndex++;
+
+		if (Index >= this->_Tasks.size())
+			return false;
+
+		try
+		{
+			this->_Tasks[Index].Task();
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> ExceptionLock(this->_ExceptionLock);
+
+			if (!this->_Exception)
+				this->_Exception = std::current_exception();
+		}
+
+		this->_Outstanding--;
+		this->Signal(true);
+
+		return true;
+	}
+
+	bool WorkStealingScheduler::TryRunSubTask(uint32_t WorkerIndex, bool Steal)
+	{
+		SubTask Task{};
+		bool HasTask = false;
+
+		// Our own queue is used newest first, it's most likely to still be in cache
+		{
+			auto& Queue = *this->_Queues[WorkerIndex];
+			std::lock_guard<std::mutex> QueueLock(Queue.Lock);
+
+			if (!Queue.Tasks.empty())
+			{
+				Task = std::move(Queue.Tasks.back());
+				Queue.Tasks.pop_back();
+				HasTask = true;
+			}
+		}
+
+		// Other queues are stolen from oldest first
+		for (uint32_t i = 1; Steal && i < this->_Queues.size() && !HasTask; i++)
+		{
+			auto& Queue = *this->_Queues[(WorkerIndex + i) % this->_Queues.size()];
+			std::lock_guard<std::mutex> QueueLock(Queue.Lock);
+
+			if (!Queue.Tasks.empty())
+			{
+				Task = std::move(Queue.Tasks.front());
+				Queue.Tasks.pop_front();
+				HasTask = true;
+			}
+		}
+
+		if (!HasTask)
+			return false;
+
+		try
+		{
+			Task.Task();
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> ExceptionLock(Task.Group->_ExceptionLock);
+
+			if (!Task.Group->_Exception)
+				Task.Group->_Exception = std::current_exception();
+		}
+
+		Task.Group->_Pending--;
+		this->_Outstanding--;
+		this->Signal(true);
+
+		return true;
+	}
+
+	void WorkStealingScheduler::Signal(bool All)
+	{
+		{
+			std::lock_guard<std::mutex> SignalLock(this->_SignalLock);
+			this->_SignalEpoch++;
+		}
+
+		if (All)
+			this->_Signal.notify_all();
+		else
+			this->_Signal.notify_one();
+	}
+
+	void WorkStealingScheduler::Idle(uint64_t SeenEpoch)
+	{
+		std::unique_lock<std::mutex> SignalLock(this->_SignalLock);
+
+		this->_Signal.wait(SignalLock, [this, SeenEpoch]
+		{
+			return this->_SignalEpoch != SeenEpoch || this->_Outstanding == 0;
+		});
+	}
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <vector>
+#include <functional>
+
+namespace Threading
+{
+	// A set of sub-tasks that the task which spawned them can wait on
+	class TaskGroup
+	{
+	public:
+		TaskGroup();
+
+		// Whether or not every task in the group has finished
+		bool IsFinished() const;
+
+		// Allow the scheduler to track pending tasks
+		friend class WorkStealingScheduler;
+	private:
+		std::atomic<uint32_t> _Pending;
+
+		// The first exception thrown by a task in the group, rethrown by Wait
+		std::exception_ptr _Exception;
+		std::mutex _ExceptionLock;
+	};
+
+	// Runs weighted tasks over a pool of workers, starting the most expensive first.
+	// Tasks may split into sub-tasks, which are queued on the worker that spawned them and stolen by idle workers.
+	class WorkStealingScheduler
+	{
+	public:
+		// Initialize a new scheduler, a value of 0 uses the core count
+		WorkStealingScheduler(uint32_t DegreeOfParallelism = 0);
+		~WorkStealingScheduler() = default;
+
+		// The scheduler owns it's queues, it can't be copied
+		WorkStealingScheduler(const WorkStealingScheduler&) = delete;
+		WorkStealingScheduler& operator=(const WorkStealingScheduler&) = delete;
+
+		// Adds a task to be run, tasks with a higher cost are started first
+		void Schedule(std::function<void()> Task, uint64_t Cost = 0);
+		// Runs all of the scheduled tasks and their sub-tasks, returns once they've all finished.
+		// The optional callbacks run on each worker thread as it starts and exits.
+		// Every task still runs when one throws, the first exception is rethrown once they're done.
+		void Run(std::function<void()> WorkerStart = nullptr, std::function<void()> WorkerExit = nullptr);
+
+		// Queues a sub-task on the calling worker, when not called from a worker it's run inline
+		static void Spawn(TaskGroup& Group, std::function<void()> Task);
+		// Waits for every task in the group to finish, running queued sub-tasks in the meantime.
+		// The first exception thrown by a task in the group is rethrown once it's finished.
+		static void Wait(TaskGroup& Group);
+
+	private:
+		// A task scheduled before running
+		struct ScheduledTask
+		{
+			std::function<void()> Task;
+			uint64_t Cost;
+		};
+
+		// A task spawned while running
+		struct SubTask
+		{
+			std::function<void()> Task;
+			TaskGroup* Group;
+		};
+
+		// The sub-task queue of a single worker
+		struct WorkerQueue
+		{
+			std::mutex Lock;
+			std::deque<SubTask> Tasks;
+		};
+
+		uint32_t _DegreeOfParallelism;
+
+		// Scheduled tasks, sorted by cost once running
+		std::vector<ScheduledTask> _Tasks;
+		std::atomic<uint32_t> _TaskIndex;
+
+		// One sub-task queue per worker
+		std::vector<std::unique_ptr<WorkerQueue>> _Queues;
+
+		// Tasks and sub-tasks that haven't finished yet
+		std::atomic<uint64_t> _Outstanding;
+
+		// Idle workers sleep until a sub-task is spawned or a task finishes, which bumps the epoch
+		std::mutex _SignalLock;
+		std::condition_variable _Signal;
+		std::atomic<uint64_t> _SignalEpoch;
+
+		// The first exception thrown by a scheduled task, rethrown by Run
+		std::exception_ptr _Exception;
+		std::mutex _ExceptionLock;
+
+		// Internal routine for each worker thread
+		void WorkerMain(uint32_t WorkerIndex);
+
+		// Runs the next scheduled task, if any are left
+		bool TryRunTask();
+		// Runs a sub-task from the workers own queue, optionally stealing one from another worker
+		bool TryRunSubTask(uint32_t WorkerIndex, bool Steal);
+
+		// Wakes idle workers, all of them when a task finished since any of them may be waiting on it
+		void Signal(bool All);
+		// Sleeps until the epoch moves past the one seen before looking for work, or everything has finished
+		void Idle(uint64_t SeenEpoch);
+	};
+}
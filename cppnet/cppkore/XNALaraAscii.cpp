@@ -15,6 +15,7 @@ namespace Assets::Exporters
 	bool XNALaraAscii::ExportModel(const Model& Model, const string& Path)
 	{
 		auto Writer = IO::StreamWriter(IO::File::Create(Path));
+		Writer.SetBufferSize(IO::StreamWriter::ExportBufferSize);
 
 		Writer.WriteLineFmt("%d", Model.Bones.Count());
 